@@ -0,0 +1,606 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include "./Error.hpp"
+#include "./Threads.hpp"
+#include <vector>
+#include <complex>
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <utility>
+#include <type_traits>
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Fast Fourier transform utilities.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::math
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Error codes for FFT.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr auto ERR_FFT_SIZE = u64(1);
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Power of two helpers.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr inline auto isPow2 ( const u64 _Val ) -> bool { return (_Val != 0) && ((_Val & (_Val - 1)) == 0); }
+
+	constexpr inline auto nextPow2 ( const u64 _Val ) -> u64
+	{
+		auto P = u64(1);
+		while(P < _Val) P <<= 1;
+		return P;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Smallest size >= _Val with no prime factor above 5. Such sizes use only specialized butterflies.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr inline auto nextFastSize ( const u64 _Val ) -> u64
+	{
+		for(auto N = std::max(u64(1), _Val);; ++N)
+		{
+			auto M = N;
+			for(auto P : { u64(2), u64(3), u64(5) }) while(M % P == 0) M /= P;
+			if(M == 1) return N;
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Fast Fourier transform internals.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::math::impl
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Complex multiply without std::complex special value handling, which keeps butterflies vectorizable.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> inline auto cmul ( const std::complex<T> _A, const std::complex<T> _B ) -> std::complex<T>
+	{
+		return std::complex<T>(_A.real() * _B.real() - _A.imag() * _B.imag(), _A.real() * _B.imag() + _A.imag() * _B.real());
+	}
+
+	// Multiply by -i.
+	template<class T> inline auto cmulNegI ( const std::complex<T> _A ) -> std::complex<T> { return std::complex<T>(_A.imag(), -_A.real()); }
+
+	template<class T> inline auto root ( const u64 _K, const u64 _N ) -> std::complex<T>
+	{
+		const auto Angle = -2.0 * std::numbers::pi * r64(_K) / r64(_N);
+		return std::complex<T>(T(std::cos(Angle)), T(std::sin(Angle)));
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Per-thread scratch. Slots keep nested users (1D passes inside 2D transform) from sharing one buffer.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T, int SLOT> auto scratch ( const u64 _Count ) -> std::complex<T>*
+	{
+		thread_local auto Buffer = std::vector<std::complex<T>>();
+		if(Buffer.size() < _Count) Buffer.resize(_Count);
+		return Buffer.data();
+	}
+
+	constexpr auto SLOT_STOCKHAM = 0;
+	constexpr auto SLOT_REAL = 1;
+	constexpr auto SLOT_2D = 2;
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Blocked transpose of _Rows x _Cols matrix, tiles of 16 x 16 complex values fit in L1. Tile rows run in parallel.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr auto FFT_TILE = u64(16);
+
+	template<class T> auto transpose ( const std::complex<T>* _Src, std::complex<T>* _Dst, const u64 _Rows, const u64 _Cols ) -> void
+	{
+		thr::parallelFor(0, (_Rows + FFT_TILE - 1) / FFT_TILE, 1, [&]( const u64 _Lo, const u64 _Hi )
+		{
+			for(auto Ty = _Lo * FFT_TILE; Ty < std::min(_Rows, _Hi * FFT_TILE); Ty += FFT_TILE)
+			{
+				const auto Y1 = std::min(_Rows, Ty + FFT_TILE);
+				for(auto Tx = u64(0); Tx < _Cols; Tx += FFT_TILE)
+				{
+					const auto X1 = std::min(_Cols, Tx + FFT_TILE);
+					for(auto y = Ty; y < Y1; ++y) for(auto x = Tx; x < X1; ++x) _Dst[x * _Rows + y] = _Src[y * _Cols + x];
+				}
+			}
+		});
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Fast Fourier transform.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::math
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Complex FFT plan of any size. Size is factored into radix 4, 2, 3 and 5 stages, remaining primes use generic O(p) butterflies.
+	// Stages run Stockham autosort between data and scratch, so no bit reversal pass is needed. Twiddles of every stage are computed once, plan is immutable
+	// and one plan can serve many threads. Forward uses e^(-2 pi i k n / N), inverse e^(+2 pi i k n / N) scaled by 1 / N.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> class Fft
+	{
+		static_assert(std::is_floating_point_v<T>, "fx::math::Fft | Type not implemented.");
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Stage of Radix butterflies combining sub-transforms of Span values. Twiddles for stage start at Offset, (Radix - 1) per sub-transform index.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		struct Stage
+		{
+			u64 Radix;
+			u64 Span;
+			u64 Offset;
+		};
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		u64 N = 0;
+		std::vector<Stage> Stages;
+		std::vector<std::complex<T>> Twiddles;
+
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		Fft ( void ) = default;
+
+		explicit Fft ( const u64 _Size ) : N(_Size)
+		{
+			if(_Size == 0) throw Error("fx::math"s, "Fft"s, "Fft"s, ERR_FFT_SIZE, "Size is zero."s);
+
+			auto Radices = std::vector<u64>();
+			auto Rest = _Size;
+			while(Rest % 4 == 0) { Radices.push_back(4); Rest /= 4; }
+			while(Rest % 2 == 0) { Radices.push_back(2); Rest /= 2; }
+			for(auto P = u64(3); P * P <= Rest; P += 2) while(Rest % P == 0) { Radices.push_back(P); Rest /= P; }
+			if(Rest > 1) Radices.push_back(Rest);
+
+			auto Span = u64(1);
+			for(auto Radix : Radices)
+			{
+				this->Stages.push_back(Stage{ Radix, Span, this->Twiddles.size() });
+				for(auto k = u64(0); k < Span; ++k) for(auto r = u64(1); r < Radix; ++r) this->Twiddles.push_back(impl::root<T>(k * r, Span * Radix));
+				Span *= Radix;
+			}
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Trivial.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		inline auto size ( void ) const -> u64 { return this->N; }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// In-place transforms of size() values. _Scratch holds size() values, without it per-thread buffer is used.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto forward ( std::complex<T>* _Data, std::complex<T>* _Scratch ) const -> void { this->transform(_Data, _Scratch); }
+		auto forward ( std::complex<T>* _Data ) const -> void { this->transform(_Data, impl::scratch<T, impl::SLOT_STOCKHAM>(this->N)); }
+
+		auto inverse ( std::complex<T>* _Data, std::complex<T>* _Scratch ) const -> void
+		{
+			// Inverse DFT is conjugate of forward DFT of conjugate.
+			for(auto i = u64(0); i < this->N; ++i) _Data[i] = std::conj(_Data[i]);
+			this->transform(_Data, _Scratch);
+
+			const auto Scale = T(1) / T(this->N);
+			for(auto i = u64(0); i < this->N; ++i) _Data[i] = std::complex<T>(_Data[i].real() * Scale, -_Data[i].imag() * Scale);
+		}
+
+		auto inverse ( std::complex<T>* _Data ) const -> void { this->inverse(_Data, impl::scratch<T, impl::SLOT_STOCKHAM>(this->N)); }
+
+		private:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Stockham stages. Input j + r * N / R feeds butterfly j, output of butterfly lands at (j / Span) * Span * R + j % Span + r * Span.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto transform ( std::complex<T>* _Data, std::complex<T>* _Scratch ) const -> void
+		{
+			auto In = _Data;
+			auto Out = _Scratch;
+
+			for(const auto& S : this->Stages)
+			{
+				const auto Stride = this->N / S.Radix;
+				const auto Tw = this->Twiddles.data() + S.Offset;
+
+				switch(S.Radix)
+				{
+					case 2: this->stage2(In, Out, Stride, S.Span, Tw); break;
+					case 3: this->stage3(In, Out, Stride, S.Span, Tw); break;
+					case 4: this->stage4(In, Out, Stride, S.Span, Tw); break;
+					case 5: this->stage5(In, Out, Stride, S.Span, Tw); break;
+					default: this->stageGeneric(In, Out, Stride, S.Span, S.Radix, Tw); break;
+				}
+
+				std::swap(In, Out);
+			}
+
+			if(In != _Data) std::copy(In, In + this->N, _Data);
+		}
+
+		static auto stage2 ( const std::complex<T>* _In, std::complex<T>* _Out, const u64 _Stride, const u64 _Span, const std::complex<T>* _Tw ) -> void
+		{
+			for(auto B = u64(0); B < _Stride; B += _Span)
+			{
+				const auto In = _In + B;
+				auto Out = _Out + 2 * B;
+
+				for(auto k = u64(0); k < _Span; ++k)
+				{
+					const auto V0 = In[k];
+					const auto V1 = impl::cmul(In[k + _Stride], _Tw[k]);
+					Out[k] = V0 + V1;
+					Out[k + _Span] = V0 - V1;
+				}
+			}
+		}
+
+		static auto stage3 ( const std::complex<T>* _In, std::complex<T>* _Out, const u64 _Stride, const u64 _Span, const std::complex<T>* _Tw ) -> void
+		{
+			constexpr auto C = T(-0.5);
+			constexpr auto S = T(-0.86602540378443864676);
+
+			for(auto B = u64(0); B < _Stride; B += _Span)
+			{
+				const auto In = _In + B;
+				auto Out = _Out + 3 * B;
+
+				for(auto k = u64(0); k < _Span; ++k)
+				{
+					const auto V0 = In[k];
+					const auto V1 = impl::cmul(In[k + _Stride], _Tw[2 * k]);
+					const auto V2 = impl::cmul(In[k + 2 * _Stride], _Tw[2 * k + 1]);
+					const auto T1 = V1 + V2;
+					const auto T2 = V1 - V2;
+					const auto M = V0 + C * T1;
+					const auto Rot = std::complex<T>(-S * T2.imag(), S * T2.real());
+
+					Out[k] = V0 + T1;
+					Out[k + _Span] = M + Rot;
+					Out[k + 2 * _Span] = M - Rot;
+				}
+			}
+		}
+
+		static auto stage4 ( const std::complex<T>* _In, std::complex<T>* _Out, const u64 _Stride, const u64 _Span, const std::complex<T>* _Tw ) -> void
+		{
+			for(auto B = u64(0); B < _Stride; B += _Span)
+			{
+				const auto In = _In + B;
+				auto Out = _Out + 4 * B;
+
+				for(auto k = u64(0); k < _Span; ++k)
+				{
+					const auto V0 = In[k];
+					const auto V1 = impl::cmul(In[k + _Stride], _Tw[3 * k]);
+					const auto V2 = impl::cmul(In[k + 2 * _Stride], _Tw[3 * k + 1]);
+					const auto V3 = impl::cmul(In[k + 3 * _Stride], _Tw[3 * k + 2]);
+					const auto T0 = V0 + V2;
+					const auto T1 = V0 - V2;
+					const auto T2 = V1 + V3;
+					const auto T3 = impl::cmulNegI(V1 - V3);
+
+					Out[k] = T0 + T2;
+					Out[k + _Span] = T1 + T3;
+					Out[k + 2 * _Span] = T0 - T2;
+					Out[k + 3 * _Span] = T1 - T3;
+				}
+			}
+		}
+
+		static auto stage5 ( const std::complex<T>* _In, std::complex<T>* _Out, const u64 _Stride, const u64 _Span, const std::complex<T>* _Tw ) -> void
+		{
+			constexpr auto C1 = T(0.30901699437494742410);
+			constexpr auto C2 = T(-0.80901699437494742410);
+			constexpr auto S1 = T(0.95105651629515357212);
+			constexpr auto S2 = T(0.58778525229247312917);
+
+			for(auto B = u64(0); B < _Stride; B += _Span)
+			{
+				const auto In = _In + B;
+				auto Out = _Out + 5 * B;
+
+				for(auto k = u64(0); k < _Span; ++k)
+				{
+					const auto V0 = In[k];
+					const auto V1 = impl::cmul(In[k + _Stride], _Tw[4 * k]);
+					const auto V2 = impl::cmul(In[k + 2 * _Stride], _Tw[4 * k + 1]);
+					const auto V3 = impl::cmul(In[k + 3 * _Stride], _Tw[4 * k + 2]);
+					const auto V4 = impl::cmul(In[k + 4 * _Stride], _Tw[4 * k + 3]);
+					const auto T1 = V1 + V4;
+					const auto T2 = V2 + V3;
+					const auto T3 = V1 - V4;
+					const auto T4 = V2 - V3;
+					const auto A1 = V0 + C1 * T1 + C2 * T2;
+					const auto A2 = V0 + C2 * T1 + C1 * T2;
+					const auto B1 = impl::cmulNegI(S1 * T3 + S2 * T4);
+					const auto B2 = impl::cmulNegI(S2 * T3 - S1 * T4);
+
+					Out[k] = V0 + T1 + T2;
+					Out[k + _Span] = A1 + B1;
+					Out[k + 2 * _Span] = A2 + B2;
+					Out[k + 3 * _Span] = A2 - B2;
+					Out[k + 4 * _Span] = A1 - B1;
+				}
+			}
+		}
+
+		static auto stageGeneric ( const std::complex<T>* _In, std::complex<T>* _Out, const u64 _Stride, const u64 _Span, const u64 _Radix, const std::complex<T>* _Tw ) -> void
+		{
+			auto Roots = std::vector<std::complex<T>>(_Radix);
+			auto V = std::vector<std::complex<T>>(_Radix);
+			for(auto m = u64(0); m < _Radix; ++m) Roots[m] = impl::root<T>(m, _Radix);
+
+			for(auto B = u64(0); B < _Stride; B += _Span)
+			{
+				const auto In = _In + B;
+				auto Out = _Out + _Radix * B;
+
+				for(auto k = u64(0); k < _Span; ++k)
+				{
+					V[0] = In[k];
+					for(auto r = u64(1); r < _Radix; ++r) V[r] = impl::cmul(In[k + r * _Stride], _Tw[(_Radix - 1) * k + r - 1]);
+
+					for(auto m = u64(0); m < _Radix; ++m)
+					{
+						auto Sum = V[0];
+						for(auto r = u64(1); r < _Radix; ++r) Sum += impl::cmul(V[r], Roots[(r * m) % _Radix]);
+						Out[k + m * _Span] = Sum;
+					}
+				}
+			}
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Real FFT plan of any size. Even sizes pack even and odd samples into one complex FFT of N / 2 and split spectrum afterwards, odd sizes run full complex FFT.
+	// Forward writes N / 2 + 1 bins, rest follows from conjugate symmetry. Inverse takes same N / 2 + 1 bins and is scaled by 1 / N.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> class FftReal
+	{
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		u64 N = 0;
+		Fft<T> Inner;
+		std::vector<std::complex<T>> Twiddles;
+
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		FftReal ( void ) = default;
+
+		explicit FftReal ( const u64 _Size ) : N(_Size)
+		{
+			if(_Size == 0) throw Error("fx::math"s, "FftReal"s, "FftReal"s, ERR_FFT_SIZE, "Size is zero."s);
+
+			if(_Size % 2 != 0) { this->Inner = Fft<T>(_Size); return; }
+
+			this->Inner = Fft<T>(_Size / 2);
+			this->Twiddles.resize(_Size / 2);
+			for(auto k = u64(0); k < _Size / 2; ++k) this->Twiddles[k] = impl::root<T>(k, _Size);
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Trivial.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		inline auto size ( void ) const -> u64 { return this->N; }
+		inline auto bins ( void ) const -> u64 { return this->N / 2 + 1; }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// N real samples to N / 2 + 1 complex bins.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto forward ( const T* _In, std::complex<T>* _Out ) const -> void
+		{
+			if(this->N % 2 != 0)
+			{
+				auto Full = impl::scratch<T, impl::SLOT_REAL>(this->N);
+				for(auto i = u64(0); i < this->N; ++i) Full[i] = std::complex<T>(_In[i], T(0));
+				this->Inner.forward(Full);
+				std::copy(Full, Full + this->bins(), _Out);
+				return;
+			}
+
+			const auto M = this->N / 2;
+			for(auto k = u64(0); k < M; ++k) _Out[k] = std::complex<T>(_In[2 * k], _In[2 * k + 1]);
+
+			this->Inner.forward(_Out);
+
+			const auto Z0 = _Out[0];
+			_Out[0] = std::complex<T>(Z0.real() + Z0.imag(), T(0));
+			_Out[M] = std::complex<T>(Z0.real() - Z0.imag(), T(0));
+
+			for(auto k = u64(1); k <= M / 2; ++k)
+			{
+				const auto A = _Out[k];
+				const auto B = std::conj(_Out[M - k]);
+				const auto Even = (A + B) * T(0.5);
+				const auto Odd = (A - B) * std::complex<T>(T(0), T(-0.5));
+				const auto Rot = impl::cmul(this->Twiddles[k], Odd);
+
+				_Out[k] = Even + Rot;
+				_Out[M - k] = std::conj(Even - Rot);
+			}
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// N / 2 + 1 complex bins to N real samples. _In is used as scratch and left undefined, pass copy when spectrum is needed again.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto inverse ( std::complex<T>* _In, T* _Out ) const -> void
+		{
+			if(this->N % 2 != 0)
+			{
+				auto Full = impl::scratch<T, impl::SLOT_REAL>(this->N);
+				std::copy(_In, _In + this->bins(), Full);
+				for(auto k = this->bins(); k < this->N; ++k) Full[k] = std::conj(Full[this->N - k]);
+				this->Inner.inverse(Full);
+				for(auto i = u64(0); i < this->N; ++i) _Out[i] = Full[i].real();
+				return;
+			}
+
+			const auto M = this->N / 2;
+
+			const auto X0 = _In[0].real();
+			const auto XM = _In[M].real();
+			_In[0] = std::complex<T>((X0 + XM) * T(0.5), (X0 - XM) * T(0.5));
+
+			for(auto k = u64(1); k <= M / 2; ++k)
+			{
+				const auto A = _In[k];
+				const auto B = std::conj(_In[M - k]);
+				const auto Even = (A + B) * T(0.5);
+				const auto Odd = impl::cmul(A - B, std::conj(this->Twiddles[k])) * T(0.5);
+				const auto Rot = std::complex<T>(-Odd.imag(), Odd.real());
+
+				_In[k] = Even + Rot;
+				_In[M - k] = std::conj(Even - Rot);
+			}
+
+			this->Inner.inverse(_In);
+			for(auto k = u64(0); k < M; ++k)
+			{
+				_Out[2 * k] = _In[k].real();
+				_Out[2 * k + 1] = _In[k].imag();
+			}
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Complex 2D FFT plan of _Width x _Height values, row major. Rows are transformed in parallel, blocked transpose turns columns into rows,
+	// they are transformed in parallel as well and second transpose restores layout.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> class Fft2D
+	{
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		Fft<T> Rows;
+		Fft<T> Cols;
+
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		Fft2D ( void ) = default;
+		Fft2D ( const u64 _Width, const u64 _Height ) : Rows(_Width), Cols(_Height) {}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Trivial.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		inline auto width ( void ) const -> u64 { return this->Rows.size(); }
+		inline auto height ( void ) const -> u64 { return this->Cols.size(); }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// In-place transforms of width() * height() values.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto forward ( std::complex<T>* _Data ) const -> void { this->transform<false>(_Data); }
+		auto inverse ( std::complex<T>* _Data ) const -> void { this->transform<true>(_Data); }
+
+		private:
+
+		template<bool INVERSE> auto transform ( std::complex<T>* _Data ) const -> void
+		{
+			const auto W = this->width();
+			const auto H = this->height();
+			auto Transposed = impl::scratch<T, impl::SLOT_2D>(W * H);
+
+			const auto Pass = [&]( const Fft<T>& _Plan, std::complex<T>* _Base, const u64 _Count )
+			{
+				const auto Len = _Plan.size();
+				thr::parallelFor(0, _Count, std::max(u64(1), u64(4096) / Len), [&]( const u64 _Lo, const u64 _Hi )
+				{
+					for(auto i = _Lo; i < _Hi; ++i)
+					{
+						if constexpr(INVERSE) _Plan.inverse(_Base + i * Len);
+						else _Plan.forward(_Base + i * Len);
+					}
+				});
+			};
+
+			Pass(this->Rows, _Data, H);
+			impl::transpose(_Data, Transposed, H, W);
+			Pass(this->Cols, Transposed, W);
+			impl::transpose(Transposed, _Data, W, H);
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Real 2D FFT plan of _Width x _Height samples. Spectrum is _Height rows of _Width / 2 + 1 bins. Inverse is scaled by 1 / (_Width * _Height).
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> class FftReal2D
+	{
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		FftReal<T> Rows;
+		Fft<T> Cols;
+
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		FftReal2D ( void ) = default;
+		FftReal2D ( const u64 _Width, const u64 _Height ) : Rows(_Width), Cols(_Height) {}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Trivial.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		inline auto width ( void ) const -> u64 { return this->Rows.size(); }
+		inline auto height ( void ) const -> u64 { return this->Cols.size(); }
+		inline auto bins ( void ) const -> u64 { return this->Rows.bins(); }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// width() x height() samples to height() x bins() spectrum.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto forward ( const T* _In, std::complex<T>* _Out ) const -> void
+		{
+			const auto W = this->width();
+			const auto H = this->height();
+			const auto B = this->bins();
+			auto Transposed = impl::scratch<T, impl::SLOT_2D>(B * H);
+
+			thr::parallelFor(0, H, std::max(u64(1), u64(4096) / W), [&]( const u64 _Lo, const u64 _Hi )
+			{
+				for(auto y = _Lo; y < _Hi; ++y) this->Rows.forward(_In + y * W, _Out + y * B);
+			});
+
+			impl::transpose(_Out, Transposed, H, B);
+			thr::parallelFor(0, B, std::max(u64(1), u64(4096) / H), [&]( const u64 _Lo, const u64 _Hi )
+			{
+				for(auto x = _Lo; x < _Hi; ++x) this->Cols.forward(Transposed + x * H);
+			});
+			impl::transpose(Transposed, _Out, B, H);
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// height() x bins() spectrum to width() x height() samples. _In is used as scratch and left undefined, pass copy when spectrum is needed again.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto inverse ( std::complex<T>* _In, T* _Out ) const -> void
+		{
+			const auto W = this->width();
+			const auto H = this->height();
+			const auto B = this->bins();
+			auto Transposed = impl::scratch<T, impl::SLOT_2D>(B * H);
+
+			impl::transpose(_In, Transposed, H, B);
+			thr::parallelFor(0, B, std::max(u64(1), u64(4096) / H), [&]( const u64 _Lo, const u64 _Hi )
+			{
+				for(auto x = _Lo; x < _Hi; ++x) this->Cols.inverse(Transposed + x * H);
+			});
+			impl::transpose(Transposed, _In, B, H);
+
+			thr::parallelFor(0, H, std::max(u64(1), u64(4096) / W), [&]( const u64 _Lo, const u64 _Hi )
+			{
+				for(auto y = _Lo; y < _Hi; ++y) this->Rows.inverse(_In + y * B, _Out + y * W);
+			});
+		}
+	};
+}
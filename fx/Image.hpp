@@ -9,6 +9,7 @@
 #include "./Types.hpp"
 #include "./Error.hpp"
 #include "./Math.hpp"
+#include "./Files.hpp"
 
 #define STBI_NO_SIMD
 #define STB_IMAGE_IMPLEMENTATION
@@ -36,6 +37,11 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <mutex>
+#include <array>
+#include <cmath>
+#include <algorithm>
+#include <cctype>
 #include <type_traits>
 
 // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -53,11 +59,13 @@ namespace fx::img
 	constexpr auto ERR_UNKNOWN_FORMAT = u64(5);
 	constexpr auto ERR_LOAD_FAILED = u64(6);
 	constexpr auto ERR_FAILED_TO_OPEN = u64(7);
+	constexpr auto ERR_SAVE_FAILED = u64(8);
+	constexpr auto ERR_ENCODE_FAILED = u64(9);
 
 	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 	// Peek image format by magic numbers.
 	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-	enum struct FileFormat { AUTO, NO_FILE, UNDEFINED, JPG, PNG, BMP, GIF, PSD };
+	enum struct FileFormat { AUTO, NO_FILE, UNDEFINED, JPG, PNG, BMP, GIF, PSD, PPM };
 
 	auto peekFormat ( const str& _Filename ) -> FileFormat
 	{
@@ -73,12 +81,130 @@ namespace fx::img
 			if((Sample[0] == 0x42) && (Sample[1] == 0x4D)) return FileFormat::BMP;
 			if((Sample[0] == 0x47) && (Sample[1] == 0x49) && (Sample[2] == 0x46) && (Sample[3] == 0x38)) return FileFormat::GIF;
 			if((Sample[0] == 0x38) && (Sample[1] == 0x42) && (Sample[2] == 0x50) && (Sample[3] == 0x53)) return FileFormat::PSD;
+			if((Sample[0] == 0x50) && ((Sample[1] == 0x35) || (Sample[1] == 0x36))) return FileFormat::PPM;
 
 			return FileFormat::UNDEFINED;
 		}
 
 		return FileFormat::NO_FILE;
 	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Guess image format from file extension. Returns UNDEFINED for unknown extensions.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto formatFromExtension ( const str& _Filename ) -> FileFormat
+	{
+		auto Extension = files::getExtension(_Filename);
+		std::transform(Extension.begin(), Extension.end(), Extension.begin(), []( const char _C ) { return char(std::tolower(u8(_C))); });
+
+		if((Extension == "jpg") || (Extension == "jpeg")) return FileFormat::JPG;
+		if(Extension == "png") return FileFormat::PNG;
+		if(Extension == "bmp") return FileFormat::BMP;
+		if(Extension == "gif") return FileFormat::GIF;
+		if(Extension == "psd") return FileFormat::PSD;
+		if((Extension == "ppm") || (Extension == "pgm") || (Extension == "pnm")) return FileFormat::PPM;
+
+		return FileFormat::UNDEFINED;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Encoder settings. Quality is JPG quality (1..100). Compression is PNG zlib level (0..9+).
+	// PngFilter forces PNG filter mode (0..4), -1 lets encoder choose per row.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	struct EncodeOptions
+	{
+		i32 Quality = 90;
+		i32 Compression = 8;
+		i32 PngFilter = -1;
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// stb keeps PNG settings in globals. Encoders that touch them must hold this lock.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto pngSettingsLock ( void ) -> std::mutex&
+	{
+		static auto Lock = std::mutex();
+		return Lock;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// stb write callback. Appends encoded bytes to std::vector<u8> given as context.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto appendToBuffer ( void* _Context, void* _Data, int _Size ) -> void
+	{
+		auto Buffer = static_cast<std::vector<u8>*>(_Context);
+		auto Bytes = static_cast<const u8*>(_Data);
+
+		if(_Size == 1) Buffer->push_back(*Bytes);
+		else Buffer->insert(Buffer->end(), Bytes, Bytes + _Size);
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Transfer function of pixel values. NONE processes values as stored, SRGB decodes them to linear light first and encodes result back.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	enum struct Transfer { NONE, SRGB };
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Exact sRGB transfer functions on 0-1 values.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto srgbToLinear ( const r32 _Val ) -> r32
+	{
+		return (_Val <= 0.04045f) ? _Val * (1.0f / 12.92f) : std::pow((_Val + 0.055f) * (1.0f / 1.055f), 2.4f);
+	}
+
+	inline auto linearToSrgb ( const r32 _Val ) -> r32
+	{
+		return (_Val <= 0.0031308f) ? _Val * 12.92f : 1.055f * std::pow(_Val, 1.0f / 2.4f) - 0.055f;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Table of all 256 sRGB encoded u8 values decoded to linear 0-1.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto srgbDecodeTable ( void ) -> const std::array<r32, 256>&
+	{
+		static const auto Table = []
+		{
+			auto Values = std::array<r32, 256>();
+			for(auto i = u64(0); i < Values.size(); ++i) Values[i] = srgbToLinear(r32(i) / 255.0f);
+			return Values;
+		}();
+
+		return Table;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Encoded sRGB (0-255 scale) sampled at SRGB_ENCODE_STEPS + 1 evenly spaced linear values, plus one guard entry for interpolation at 1.
+	// Linear interpolation between samples stays within 0.1 of exact curve, so rounded result matches pow() except on rare ties.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr auto SRGB_ENCODE_STEPS = u64(1024);
+
+	inline auto srgbEncodeTable ( void ) -> const std::array<r32, SRGB_ENCODE_STEPS + 2>&
+	{
+		static const auto Table = []
+		{
+			auto Values = std::array<r32, SRGB_ENCODE_STEPS + 2>();
+			for(auto i = u64(0); i <= SRGB_ENCODE_STEPS; ++i) Values[i] = 255.0f * linearToSrgb(r32(i) / r32(SRGB_ENCODE_STEPS));
+			Values[SRGB_ENCODE_STEPS + 1] = Values[SRGB_ENCODE_STEPS];
+			return Values;
+		}();
+
+		return Table;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Fast u8 sRGB transfer through tables. Linear input is clamped to 0-1.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto srgbToLinear ( const u8 _Val ) -> r32 { return srgbDecodeTable()[_Val]; }
+
+	inline auto linearToSrgb8 ( const r32 _Val ) -> u8
+	{
+		const auto& Table = srgbEncodeTable();
+		const auto Pos = std::clamp(_Val, 0.0f, 1.0f) * r32(SRGB_ENCODE_STEPS);
+		const auto Idx = u64(Pos);
+		const auto Frac = Pos - r32(Idx);
+
+		return u8(Table[Idx] + (Table[Idx + 1] - Table[Idx]) * Frac + 0.5f);
+	}
 }
 
 // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -86,6 +212,53 @@ namespace fx::img
 // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 namespace fx
 {
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Non owning window into interleaved image memory. Rows are Stride elements apart, so view can cover sub rectangle.
+	// Use ImageView<const T> for read only access.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> class ImageView
+	{
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		T* Ptr;
+		u64 Width;
+		u64 Height;
+		u64 Depth;
+		u64 Stride;
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors. Zero stride means tightly packed rows.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		ImageView ( void ) : Ptr(nullptr), Width(0), Height(0), Depth(0), Stride(0) {}
+		ImageView ( T* _Ptr, const u64 _Width, const u64 _Height, const u64 _Depth, const u64 _Stride = 0 ) : Ptr(_Ptr), Width(_Width), Height(_Height), Depth(_Depth), Stride((_Stride == 0) ? _Width*_Depth : _Stride) {}
+		template<class C, class = std::enable_if_t<std::is_same_v<const C, T>>> ImageView ( const ImageView<C>& _Other ) : Ptr(_Other.data()), Width(_Other.width()), Height(_Other.height()), Depth(_Other.depth()), Stride(_Other.stride()) {}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Trivial.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		inline auto data ( void ) const -> T* { return this->Ptr; }
+		inline auto row ( const u64 _Y ) const -> T* { return this->Ptr + _Y*this->Stride; }
+		inline auto at ( const u64 _X, const u64 _Y ) const -> T* { return this->Ptr + _Y*this->Stride + _X*this->Depth; }
+		inline auto isEmpty ( void ) const -> bool { return (this->Ptr == nullptr) || (this->size() == 0); }
+		inline auto isContiguous ( void ) const -> bool { return this->Stride == this->Width*this->Depth; }
+		inline auto width ( void ) const -> u64 { return this->Width; }
+		inline auto height ( void ) const -> u64 { return this->Height; }
+		inline auto depth ( void ) const -> u64 { return this->Depth; }
+		inline auto stride ( void ) const -> u64 { return this->Stride; }
+		inline auto size ( void ) const -> u64 { return (this->Width*this->Height*this->Depth); }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Sub rectangle of this view.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto region ( const u64 _X, const u64 _Y, const u64 _Width, const u64 _Height ) const -> ImageView<T>
+		{
+			if((_X + _Width > this->Width) || (_Y + _Height > this->Height)) throw Error("fx"s, "ImageView<T>"s, "region"s, img::ERR_BAD_ARGS, "Region out of bounds."s);
+			return ImageView<T>(this->at(_X, _Y), _Width, _Height, this->Depth, this->Stride);
+		}
+	};
+
 	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 	// Image container.
 	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -110,6 +283,11 @@ namespace fx
 		Image ( const Image<T>& _Original ) { if(this != &_Original) *this = _Original; }
 		template<class C> Image ( const Image<C>& _Original ) { *this = _Original; }
 		Image ( Image<T>&& _Original ) noexcept { if(this != &_Original) *this = std::move(_Original); }
+		explicit Image ( const ImageView<const T>& _View ) : Data(_View.size()), Width(_View.width()), Height(_View.height()), Depth(_View.depth())
+		{
+			const auto RowSize = this->Width*this->Depth;
+			for(auto y = u64(0); y < this->Height; ++y) std::copy(_View.row(y), _View.row(y) + RowSize, this->Data.data() + y*RowSize);
+		}
 
 		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 		// Copy assignment.
@@ -193,12 +371,27 @@ namespace fx
 		inline auto sizeInBytes ( void ) const -> u64 { return (this->size()*sizeof(T)); }
 		inline auto read ( const u64 _X, const u64 _Y, const u64 _D ) -> T { return this->Data[math::index_c(_X, _Y, _D, this->Width, this->Height)]; }
 		inline auto write ( const u64 _X, const u64 _Y, const u64 _D, const T _Val ) -> void { this->Data[math::index_c(_X, _Y, _D, this->Width, this->Height)] = _Val; }
+		inline auto view ( void ) -> ImageView<T> { return ImageView<T>(this->Data.data(), this->Width, this->Height, this->Depth); }
+		inline auto view ( void ) const -> ImageView<const T> { return ImageView<const T>(this->Data.data(), this->Width, this->Height, this->Depth); }
+		inline auto region ( const u64 _X, const u64 _Y, const u64 _Width, const u64 _Height ) -> ImageView<T> { return this->view().region(_X, _Y, _Width, _Height); }
+		inline auto region ( const u64 _X, const u64 _Y, const u64 _Width, const u64 _Height ) const -> ImageView<const T> { return this->view().region(_X, _Y, _Width, _Height); }
 
 		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 		// Copy in sizeInBytes() amount of bytes from _Src.
 		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 		auto copyIn ( const T* _Src ) -> void { std::memcpy(this->Data.data(), _Src, this->sizeInBytes()); }
 
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Change dimensions. Contents are unspecified afterwards, storage is reused when large enough.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto reset ( const u64 _Width, const u64 _Height, const u64 _Depth ) -> void
+		{
+			this->Width = _Width;
+			this->Height = _Height;
+			this->Depth = _Depth;
+			this->Data.resize(this->size());
+		}
+
 		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 		// Load image from file.
 		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -230,18 +423,85 @@ namespace fx
 		}
 
 		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-		// Save image to file.
+		// Encode image into memory. Buffer is cleared, but keeps its capacity, so it can be reused between calls.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto encode ( std::vector<u8>& _Buffer, const img::FileFormat _Format, const img::EncodeOptions& _Options = img::EncodeOptions() ) const -> void
+		{
+			static_assert(std::is_same_v<T, u8>, "fx::Image<T>::encode | Type not implemented.");
+			if(this->isEmpty()) throw Error("fx"s, "Image<T>"s, "encode"s, img::ERR_EMPTY, "Image is empty."s);
+			if((_Format != img::FileFormat::JPG) && (_Format != img::FileFormat::PNG) && (_Format != img::FileFormat::BMP) && (_Format != img::FileFormat::PPM))
+			{
+				throw Error("fx"s, "Image<T>"s, "encode"s, img::ERR_UNKNOWN_FORMAT, "Format can not be encoded. Use JPG, PNG, BMP or PPM."s);
+			}
+
+
+			_Buffer.clear();
+
+			const auto Width = i32(this->Width);
+			const auto Height = i32(this->Height);
+			const auto Depth = i32(this->Depth);
+			auto Result = i32(0);
+
+			if(_Format == img::FileFormat::JPG)
+			{
+				Result = stbi_write_jpg_to_func(img::appendToBuffer, &_Buffer, Width, Height, Depth, this->Data.data(), std::clamp(_Options.Quality, 1, 100));
+			}
+
+			else if(_Format == img::FileFormat::BMP)
+			{
+				Result = stbi_write_bmp_to_func(img::appendToBuffer, &_Buffer, Width, Height, Depth, this->Data.data());
+			}
+
+			else if(_Format == img::FileFormat::PNG)
+			{
+				auto Lock = std::lock_guard<std::mutex>(img::pngSettingsLock());
+				stbi_write_png_compression_level = std::max(_Options.Compression, 0);
+				stbi_write_force_png_filter = std::clamp(_Options.PngFilter, -1, 4);
+				Result = stbi_write_png_to_func(img::appendToBuffer, &_Buffer, Width, Height, Depth, this->Data.data(), Width * Depth);
+			}
+
+			else if(_Format == img::FileFormat::PPM)
+			{
+				if((this->Depth != 1) && (this->Depth != 3)) throw Error("fx"s, "Image<T>"s, "encode"s, img::ERR_BAD_ARGS, "PPM needs depth 1 or 3."s);
+
+				const auto Header = ((this->Depth == 1) ? "P5\n"s : "P6\n"s) + std::to_string(this->Width) + " "s + std::to_string(this->Height) + "\n255\n"s;
+				_Buffer.insert(_Buffer.end(), Header.begin(), Header.end());
+				_Buffer.insert(_Buffer.end(), this->Data.begin(), this->Data.end());
+				Result = 1;
+			}
+
+			if(Result == 0) throw Error("fx"s, "Image<T>"s, "encode"s, img::ERR_ENCODE_FAILED, "stbi_write returned 0."s);
+		}
+
+		auto encode ( const img::FileFormat _Format, const img::EncodeOptions& _Options = img::EncodeOptions() ) const -> std::vector<u8>
+		{
+			auto Buffer = std::vector<u8>();
+			this->encode(Buffer, _Format, _Options);
+			return Buffer;
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Save image to file. AUTO picks format from file extension.
 		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-		auto save ( const str& _Filename, const img::FileFormat _Format = img::FileFormat::AUTO ) const -> void
+		auto save ( const str& _Filename, const img::FileFormat _Format = img::FileFormat::AUTO, const img::EncodeOptions& _Options = img::EncodeOptions() ) const -> void
 		{
 			static_assert(std::is_same_v<T, u8>, "fx::Image<T>::save | Type not implemented.");
 			if(this->isEmpty()) throw Error("fx"s, "Image<T>"s, "save"s, img::ERR_EMPTY, "Image is empty: "s + _Filename);
-			
 
-			if(_Format == img::FileFormat::AUTO) stbi_write_jpg(_Filename.c_str(), i32(this->Width), i32(this->Height), i32(this->Depth), this->Data.data(), 90);
-			else if(_Format == img::FileFormat::JPG) stbi_write_jpg(_Filename.c_str(), i32(this->Width), i32(this->Height), i32(this->Depth), this->Data.data(), 90);
-			else if(_Format == img::FileFormat::BMP) stbi_write_bmp(_Filename.c_str(), i32(this->Width), i32(this->Height), i32(this->Depth), this->Data.data());
-			else if(_Format == img::FileFormat::PNG) stbi_write_png(_Filename.c_str(), i32(this->Width), i32(this->Height), i32(this->Depth), this->Data.data(), i32(this->Width) * i32(this->Depth));
+
+			auto Format = _Format;
+			if(Format == img::FileFormat::AUTO) Format = img::formatFromExtension(_Filename);
+			if(Format == img::FileFormat::UNDEFINED) throw Error("fx"s, "Image<T>"s, "save"s, img::ERR_UNKNOWN_FORMAT, "Can not deduce format from extension: "s + _Filename);
+
+			auto Buffer = std::vector<u8>();
+			this->encode(Buffer, Format, _Options);
+
+
+			auto File = std::ofstream(_Filename, std::ios::binary);
+			if(!File.is_open()) throw Error("fx"s, "Image<T>"s, "save"s, img::ERR_FAILED_TO_OPEN, "Failed to open file: "s + _Filename);
+
+			File.write(reinterpret_cast<const char*>(Buffer.data()), std::streamsize(Buffer.size()));
+			if(!File.good()) throw Error("fx"s, "Image<T>"s, "save"s, img::ERR_SAVE_FAILED, "Failed to write file: "s + _Filename);
 		}
 	};
 }
@@ -272,11 +532,11 @@ namespace fx::img
 	}
 
 	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-	// Flatten image to single channel.
+	// Flatten image to single channel. With SRGB transfer MEAN averages in linear light, so u8 and r32 values are taken as sRGB encoded.
 	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 	enum struct OpFlatten { KEEP_RED, KEEP_GREEN, KEEP_BLUE, KEEP_ALPHA, MEAN };
 	
-	template<class T> auto flatten ( const Image<T>& _Src, const OpFlatten _Op ) -> Image<T>
+	template<class T> auto flatten ( const Image<T>& _Src, const OpFlatten _Op, const Transfer _Transfer = Transfer::NONE ) -> Image<T>
 	{
 		if(_Src.isEmpty()) throw Error("fx::img", "", "flatten", img::ERR_EMPTY, "Image is empty.");
 		
@@ -295,6 +555,27 @@ namespace fx::img
 			for(auto IdxColSrc = u64(0); IdxColSrc < _Src.size(); IdxColSrc += _Src.depth()) { NewImage[IdxColDst] = _Src[IdxColSrc+Offset]; ++IdxColDst; }
 		}
 
+		else if((_Op == OpFlatten::MEAN) && (_Transfer == Transfer::SRGB))
+		{
+			if constexpr((std::is_same_v<T, u8>) || (std::is_same_v<T, r32>))
+			{
+				const auto Scale = 1.0f / r32(_Src.depth());
+
+				for(auto IdxColSrc = u64(0); IdxColSrc < _Src.size(); IdxColSrc += _Src.depth())
+				{
+					auto Sum = 0.0f;
+					for(auto IdxCh = u64(0); IdxCh < _Src.depth(); ++IdxCh) Sum += srgbToLinear(_Src[IdxColSrc+IdxCh]);
+
+					if constexpr(std::is_same_v<T, u8>) NewImage[IdxColDst] = linearToSrgb8(Sum * Scale);
+					else NewImage[IdxColDst] = linearToSrgb(Sum * Scale);
+
+					++IdxColDst;
+				}
+			}
+
+			else throw Error("fx::img", "", "flatten", img::ERR_BAD_ARGS, "sRGB transfer needs u8 or r32 image.");
+		}
+
 		else if(_Op == OpFlatten::MEAN)
 		{
 			for(auto IdxColSrc = u64(0); IdxColSrc < _Src.size(); IdxColSrc += _Src.depth())
@@ -391,9 +672,9 @@ namespace fx::img
 	}
 
 	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-	// Resize image.
+	// Resize image. With SRGB transfer filtering happens in linear light; for 2 and 4 channels last channel is alpha and stays linear.
 	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-	template<class T> auto resize ( const Image<T>& _Src, const u64 _Width, const u64 _Height ) -> Image<T>
+	template<class T> auto resize ( const Image<T>& _Src, const u64 _Width, const u64 _Height, const Transfer _Transfer = Transfer::NONE ) -> Image<T>
 	{
 		if(_Src.isEmpty()) throw Error("fx::img", "", "resize", img::ERR_EMPTY, "Image is empty.");
 		static_assert(((std::is_same_v<T, u8>) || (std::is_same_v<T, r32>)), "fx::img::resize | Type not implemented.");
@@ -401,6 +682,16 @@ namespace fx::img
 
 		auto NewImage = Image<T>(_Width, _Height, _Src.depth());
 
+		if(_Transfer == Transfer::SRGB)
+		{
+			const auto Alpha = ((_Src.depth() == 2) || (_Src.depth() == 4)) ? i32(_Src.depth() - 1) : STBIR_ALPHA_CHANNEL_NONE;
+
+			if constexpr(std::is_same_v<T, u8>) stbir_resize_uint8_srgb(_Src.data(), i32(_Src.width()), i32(_Src.height()), 0, NewImage.data(), i32(_Width), i32(_Height), 0, i32(_Src.depth()), Alpha, 0);
+			if constexpr(std::is_same_v<T, r32>) stbir_resize_float_generic(_Src.data(), i32(_Src.width()), i32(_Src.height()), 0, NewImage.data(), i32(_Width), i32(_Height), 0, i32(_Src.depth()), Alpha, 0, STBIR_EDGE_CLAMP, STBIR_FILTER_DEFAULT, STBIR_COLORSPACE_SRGB, nullptr);
+
+			return NewImage;
+		}
+
 		if constexpr(std::is_same_v<T, u8>) stbir_resize_uint8(_Src.data(), i32(_Src.width()), i32(_Src.height()), 0, NewImage.data(), i32(_Width), i32(_Height), 0, i32(_Src.depth()));
 		if constexpr(std::is_same_v<T, r32>) stbir_resize_float(_Src.data(), i32(_Src.width()), i32(_Src.height()), 0, NewImage.data(), i32(_Width), i32(_Height), 0, i32(_Src.depth()));
 
@@ -0,0 +1,355 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include "./Error.hpp"
+#include "./Image.hpp"
+#include "./Threads.hpp"
+#include "./magic.hpp"
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Blending arithmetic.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Round(_Val / 255) for 0 <= _Val <= 65535, without division. Exact over whole range, so products of two u8 values scale back without drift.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr inline auto div255 ( const u32 _Val ) -> u32
+	{
+		const auto Biased = _Val + 128;
+		return (Biased + (Biased >> 8)) >> 8;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Reciprocal table: (c * table[a] + 32768) >> 16 is c * 255 / a to within one, without division. Entry 0 is zero, fully transparent pixels stay black.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto unpremultiplyTable ( void ) -> const std::array<u32, 256>&
+	{
+		static const auto Table = []
+		{
+			auto Values = std::array<u32, 256>();
+			for(auto a = u32(1); a < 256; ++a) Values[a] = (255u * 65536u + a / 2) / a;
+			return Values;
+		}();
+
+		return Table;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Separable blend modes (W3C compositing). Mode decides colour where both layers are present, alpha always composes as source over.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	enum struct OpBlend { NORMAL, MULTIPLY, SCREEN, OVERLAY, DARKEN, LIGHTEN, ADD, DIFFERENCE };
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Blend backdrop _B with source _S. u8 works on 0-255 integers, r32 on 0-1 values.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<OpBlend OP, class T> constexpr inline auto blendChannel ( const T _B, const T _S ) -> T
+	{
+		if constexpr(std::is_same_v<T, u8>)
+		{
+			const auto B = u32(_B), S = u32(_S);
+			if constexpr(OP == OpBlend::NORMAL) return _S;
+			else if constexpr(OP == OpBlend::MULTIPLY) return u8(div255(B * S));
+			else if constexpr(OP == OpBlend::SCREEN) return u8(B + S - div255(B * S));
+			else if constexpr(OP == OpBlend::OVERLAY) return u8((B < 128) ? div255(2 * B * S) : 255 - div255(2 * (255 - B) * (255 - S)));
+			else if constexpr(OP == OpBlend::DARKEN) return std::min(_B, _S);
+			else if constexpr(OP == OpBlend::LIGHTEN) return std::max(_B, _S);
+			else if constexpr(OP == OpBlend::ADD) return u8(std::min(u32(255), B + S));
+			else if constexpr(OP == OpBlend::DIFFERENCE) return u8((B > S) ? B - S : S - B);
+		}
+		else
+		{
+			if constexpr(OP == OpBlend::NORMAL) return _S;
+			else if constexpr(OP == OpBlend::MULTIPLY) return _B * _S;
+			else if constexpr(OP == OpBlend::SCREEN) return _B + _S - _B * _S;
+			else if constexpr(OP == OpBlend::OVERLAY) return (_B < T(0.5)) ? T(2) * _B * _S : T(1) - T(2) * (T(1) - _B) * (T(1) - _S);
+			else if constexpr(OP == OpBlend::DARKEN) return std::min(_B, _S);
+			else if constexpr(OP == OpBlend::LIGHTEN) return std::max(_B, _S);
+			else if constexpr(OP == OpBlend::ADD) return std::min(T(1), _B + _S);
+			else if constexpr(OP == OpBlend::DIFFERENCE) return std::abs(_B - _S);
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Blending internals.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img::impl
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Run _Fn(Row, Width) over every row of view in parallel.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T, class F> auto forEachRow ( const ImageView<T>& _Image, F&& _Fn ) -> void
+	{
+		thr::parallelFor(0, _Image.height(), std::max(u64(1), u64(16384) / (_Image.width() * _Image.depth())), [&]( const u64 _Lo, const u64 _Hi )
+		{
+			for(auto y = _Lo; y < _Hi; ++y) _Fn(_Image.row(y), y);
+		});
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Alpha must be last of 2 or 4 channels.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto checkAlpha ( const ImageView<T>& _Image, const str& _Func ) -> void
+	{
+		if(_Image.isEmpty()) throw Error("fx::img"s, ""s, _Func, ERR_EMPTY, "Image is empty."s);
+		if((_Image.depth() != 2) && (_Image.depth() != 4)) throw Error("fx::img"s, ""s, _Func, ERR_BAD_ARGS, "Image needs alpha as last of 2 or 4 channels."s);
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Overlap of _Src placed at (_X, _Y) with _Dst. Returns false when they do not overlap.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class D, class S> auto clipPlacement ( const ImageView<D>& _Dst, const ImageView<S>& _Src, const i64 _X, const i64 _Y, ImageView<D>& _DstOut, ImageView<S>& _SrcOut ) -> bool
+	{
+		const auto X0 = std::max(i64(0), _X);
+		const auto Y0 = std::max(i64(0), _Y);
+		const auto X1 = std::min(i64(_Dst.width()), _X + i64(_Src.width()));
+		const auto Y1 = std::min(i64(_Dst.height()), _Y + i64(_Src.height()));
+		if((X1 <= X0) || (Y1 <= Y0)) return false;
+
+		_DstOut = _Dst.region(u64(X0), u64(Y0), u64(X1 - X0), u64(Y1 - Y0));
+		_SrcOut = _Src.region(u64(X0 - _X), u64(Y0 - _Y), u64(X1 - X0), u64(Y1 - Y0));
+		return true;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Blend straight alpha source row over destination row. Destination without alpha channel is opaque.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<OpBlend OP, u64 COLORS, bool DST_ALPHA, class T> auto blendRow ( T* _Dst, const T* _Src, const u64 _Width ) -> void
+	{
+		constexpr auto DD = COLORS + (DST_ALPHA ? 1 : 0);
+		constexpr auto SD = COLORS + 1;
+
+		for(auto x = u64(0); x < _Width; ++x, _Dst += DD, _Src += SD)
+		{
+			if constexpr(std::is_same_v<T, u8>)
+			{
+				const auto As = u32(_Src[COLORS]);
+				if(As == 0) continue;
+
+				if constexpr(!DST_ALPHA)
+				{
+					for(auto c = u64(0); c < COLORS; ++c) _Dst[c] = u8(div255(As * blendChannel<OP>(_Dst[c], _Src[c]) + (255 - As) * _Dst[c]));
+				}
+				else
+				{
+					// Result alpha times 255, kept unrounded: dividing by it directly avoids amplifying rounding error where alpha is small.
+					const auto Ab = u32(_Dst[COLORS]);
+					const auto Den = As * 255 + Ab * (255 - As);
+
+					for(auto c = u64(0); c < COLORS; ++c)
+					{
+						// Source colour where backdrop shows through is mixed with blend result, then both layers compose premultiplied.
+						const auto Mixed = div255((255 - Ab) * _Src[c] + Ab * blendChannel<OP>(_Dst[c], _Src[c]));
+						_Dst[c] = u8((As * Mixed * 255 + (255 - As) * Ab * _Dst[c] + Den / 2) / Den);
+					}
+					_Dst[COLORS] = u8(div255(Den));
+				}
+			}
+			else
+			{
+				const auto As = _Src[COLORS];
+				if(As <= T(0)) continue;
+
+				if constexpr(!DST_ALPHA)
+				{
+					for(auto c = u64(0); c < COLORS; ++c) _Dst[c] = As * blendChannel<OP>(_Dst[c], _Src[c]) + (T(1) - As) * _Dst[c];
+				}
+				else
+				{
+					const auto Ab = _Dst[COLORS];
+					const auto Ao = As + Ab * (T(1) - As);
+					const auto Inv = (Ao > T(0)) ? T(1) / Ao : T(0);
+
+					for(auto c = u64(0); c < COLORS; ++c)
+					{
+						const auto Mixed = (T(1) - Ab) * _Src[c] + Ab * blendChannel<OP>(_Dst[c], _Src[c]);
+						_Dst[c] = (As * Mixed + (T(1) - As) * Ab * _Dst[c]) * Inv;
+					}
+					_Dst[COLORS] = Ao;
+				}
+			}
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Alpha.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Multiply colour channels by alpha in place. Alpha is last of 2 or 4 channels.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto premultiply ( const ImageView<T>& _Image ) -> void
+	{
+		static_assert(std::is_same_v<T, u8> || std::is_same_v<T, r32>, "fx::img::premultiply | Type not implemented.");
+		impl::checkAlpha(_Image, "premultiply"s);
+
+		mgx::withDepth(_Image.depth(), [&]( auto _Depth )
+		{
+			constexpr auto D = decltype(_Depth)::value;
+			if constexpr((D == 2) || (D == 4)) impl::forEachRow(_Image, [&]( T* _Row, u64 )
+			{
+				for(auto x = u64(0); x < _Image.width(); ++x, _Row += D)
+				{
+					if constexpr(std::is_same_v<T, u8>) for(auto c = u64(0); c < D - 1; ++c) _Row[c] = u8(div255(u32(_Row[c]) * _Row[D - 1]));
+					else for(auto c = u64(0); c < D - 1; ++c) _Row[c] *= _Row[D - 1];
+				}
+			});
+		});
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Divide colour channels by alpha in place. Fully transparent pixels become zero. u8 divides through reciprocal table.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto unpremultiply ( const ImageView<T>& _Image ) -> void
+	{
+		static_assert(std::is_same_v<T, u8> || std::is_same_v<T, r32>, "fx::img::unpremultiply | Type not implemented.");
+		impl::checkAlpha(_Image, "unpremultiply"s);
+
+		const auto& Table = unpremultiplyTable();
+
+		mgx::withDepth(_Image.depth(), [&]( auto _Depth )
+		{
+			constexpr auto D = decltype(_Depth)::value;
+			if constexpr((D == 2) || (D == 4)) impl::forEachRow(_Image, [&]( T* _Row, u64 )
+			{
+				for(auto x = u64(0); x < _Image.width(); ++x, _Row += D)
+				{
+					if constexpr(std::is_same_v<T, u8>)
+					{
+						const auto Recip = Table[_Row[D - 1]];
+						for(auto c = u64(0); c < D - 1; ++c) _Row[c] = u8(std::min(u32(255), (u32(_Row[c]) * Recip + 32768) >> 16));
+					}
+					else
+					{
+						const auto Inv = (_Row[D - 1] > 0) ? T(1) / _Row[D - 1] : T(0);
+						for(auto c = u64(0); c < D - 1; ++c) _Row[c] *= Inv;
+					}
+				}
+			});
+		});
+	}
+
+	template<class T> auto premultiply ( Image<T>& _Image ) -> void { premultiply(_Image.view()); }
+	template<class T> auto unpremultiply ( Image<T>& _Image ) -> void { unpremultiply(_Image.view()); }
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Compositing.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Blend straight alpha _Src over _Dst with top left corner at (_X, _Y). Parts outside _Dst are clipped, nothing is allocated.
+	// _Src carries alpha as last channel (RGBA or GA). _Dst has same layout, or same colours without alpha, which is treated as opaque.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto blendOver ( const ImageView<T>& _Dst, const ImageView<const mgx::identity_t<T>>& _Src, const i64 _X = 0, const i64 _Y = 0, const OpBlend _Op = OpBlend::NORMAL ) -> void
+	{
+		static_assert(std::is_same_v<T, u8> || std::is_same_v<T, r32>, "fx::img::blendOver | Type not implemented.");
+		impl::checkAlpha(_Src, "blendOver"s);
+		if(_Dst.isEmpty()) throw Error("fx::img"s, ""s, "blendOver"s, ERR_EMPTY, "Image is empty."s);
+		if((_Dst.depth() != _Src.depth()) && (_Dst.depth() + 1 != _Src.depth())) throw Error("fx::img"s, ""s, "blendOver"s, ERR_INCONSISTENT_DIM, "Destination must have source colours, with or without alpha."s);
+
+		auto Dst = ImageView<T>();
+		auto Src = ImageView<const T>();
+		if(!impl::clipPlacement(_Dst, _Src, _X, _Y, Dst, Src)) return;
+
+		const auto Run = [&]( auto _Op, auto _Colors, auto _DstAlpha )
+		{
+			constexpr auto OP = decltype(_Op)::value;
+			constexpr auto COLORS = decltype(_Colors)::value;
+			constexpr auto DST_ALPHA = decltype(_DstAlpha)::value;
+
+			impl::forEachRow(Dst, [&]( T* _Row, const u64 _Y ) { impl::blendRow<OP, COLORS, DST_ALPHA>(_Row, Src.row(_Y), Dst.width()); });
+		};
+
+		const auto WithShape = [&]( auto _Op )
+		{
+			const auto DstAlpha = (_Dst.depth() == _Src.depth());
+			if(_Src.depth() == 4)
+			{
+				if(DstAlpha) Run(_Op, std::integral_constant<u64, 3>(), std::true_type());
+				else Run(_Op, std::integral_constant<u64, 3>(), std::false_type());
+			}
+			else
+			{
+				if(DstAlpha) Run(_Op, std::integral_constant<u64, 1>(), std::true_type());
+				else Run(_Op, std::integral_constant<u64, 1>(), std::false_type());
+			}
+		};
+
+		switch(_Op)
+		{
+			case OpBlend::NORMAL: WithShape(std::integral_constant<OpBlend, OpBlend::NORMAL>()); break;
+			case OpBlend::MULTIPLY: WithShape(std::integral_constant<OpBlend, OpBlend::MULTIPLY>()); break;
+			case OpBlend::SCREEN: WithShape(std::integral_constant<OpBlend, OpBlend::SCREEN>()); break;
+			case OpBlend::OVERLAY: WithShape(std::integral_constant<OpBlend, OpBlend::OVERLAY>()); break;
+			case OpBlend::DARKEN: WithShape(std::integral_constant<OpBlend, OpBlend::DARKEN>()); break;
+			case OpBlend::LIGHTEN: WithShape(std::integral_constant<OpBlend, OpBlend::LIGHTEN>()); break;
+			case OpBlend::ADD: WithShape(std::integral_constant<OpBlend, OpBlend::ADD>()); break;
+			case OpBlend::DIFFERENCE: WithShape(std::integral_constant<OpBlend, OpBlend::DIFFERENCE>()); break;
+		}
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Porter-Duff source over for premultiplied images: Dst = Src + Dst * (1 - Src alpha), every channel alike. Cheapest way to stack many layers.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto compositeOver ( const ImageView<T>& _Dst, const ImageView<const mgx::identity_t<T>>& _Src, const i64 _X = 0, const i64 _Y = 0 ) -> void
+	{
+		static_assert(std::is_same_v<T, u8> || std::is_same_v<T, r32>, "fx::img::compositeOver | Type not implemented.");
+		impl::checkAlpha(_Src, "compositeOver"s);
+		if(_Dst.depth() != _Src.depth()) throw Error("fx::img"s, ""s, "compositeOver"s, ERR_INCONSISTENT_DIM, "Inconsistent depth."s);
+
+		auto Dst = ImageView<T>();
+		auto Src = ImageView<const T>();
+		if(!impl::clipPlacement(_Dst, _Src, _X, _Y, Dst, Src)) return;
+
+		mgx::withDepth(Dst.depth(), [&]( auto _Depth )
+		{
+			constexpr auto D = decltype(_Depth)::value;
+			if constexpr((D == 2) || (D == 4)) impl::forEachRow(Dst, [&]( T* _Row, const u64 _Y )
+			{
+				auto In = Src.row(_Y);
+
+				for(auto x = u64(0); x < Dst.width(); ++x, _Row += D, In += D)
+				{
+					if constexpr(std::is_same_v<T, u8>)
+					{
+						const auto Keep = 255 - u32(In[D - 1]);
+						for(auto c = u64(0); c < D; ++c) _Row[c] = u8(std::min(u32(255), In[c] + div255(Keep * _Row[c])));
+					}
+					else
+					{
+						const auto Keep = T(1) - In[D - 1];
+						for(auto c = u64(0); c < D; ++c) _Row[c] = In[c] + Keep * _Row[c];
+					}
+				}
+			});
+		});
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Image overloads.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto blendOver ( Image<T>& _Dst, const Image<T>& _Src, const i64 _X = 0, const i64 _Y = 0, const OpBlend _Op = OpBlend::NORMAL ) -> void
+	{
+		blendOver<T>(_Dst.view(), _Src.view(), _X, _Y, _Op);
+	}
+
+	template<class T> auto compositeOver ( Image<T>& _Dst, const Image<T>& _Src, const i64 _X = 0, const i64 _Y = 0 ) -> void
+	{
+		compositeOver<T>(_Dst.view(), _Src.view(), _X, _Y);
+	}
+}
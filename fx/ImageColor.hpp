@@ -0,0 +1,537 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include "./Error.hpp"
+#include "./Image.hpp"
+#include "./Threads.hpp"
+#include "./magic.hpp"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Colour space options.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// YCbCr coefficient set. BT601 is used by JPEG and SD video, BT709 by HD video.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	enum struct ColorStandard { BT601, BT709 };
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// YCbCr range. FULL uses 0-255 for all components, LIMITED (studio swing) uses 16-235 for luma and 16-240 for chroma.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	enum struct ColorRange { FULL, LIMITED };
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Planar 4:2:0 layouts. I420 stores U plane then V plane, NV12 stores one plane of interleaved UV pairs.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	enum struct YuvLayout { I420, NV12 };
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Affine colour transform: Out[i] = sum(M[i][j] * In[j]) + Offset[i]. Expressed for 0-255 values, floats scale offsets by 1/255.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	struct ColorTransform
+	{
+		r64 M[3][3];
+		r64 Offset[3];
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// RGB to YCbCr transform for given standard and range.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto rgbToYCbCrTransform ( const ColorStandard _Standard = ColorStandard::BT601, const ColorRange _Range = ColorRange::FULL ) -> ColorTransform
+	{
+		const auto Kr = (_Standard == ColorStandard::BT601) ? 0.299 : 0.2126;
+		const auto Kb = (_Standard == ColorStandard::BT601) ? 0.114 : 0.0722;
+		const auto Kg = 1.0 - Kr - Kb;
+		const auto Ys = (_Range == ColorRange::FULL) ? 1.0 : 219.0 / 255.0;
+		const auto Cs = (_Range == ColorRange::FULL) ? 1.0 : 224.0 / 255.0;
+		const auto Yo = (_Range == ColorRange::FULL) ? 0.0 : 16.0;
+		const auto Cb = Cs * 0.5 / (1.0 - Kb);
+		const auto Cr = Cs * 0.5 / (1.0 - Kr);
+
+		return ColorTransform
+		{
+			{
+				{ Ys * Kr, Ys * Kg, Ys * Kb },
+				{ -Cb * Kr, -Cb * Kg, Cb * (1.0 - Kb) },
+				{ Cr * (1.0 - Kr), -Cr * Kg, -Cr * Kb }
+			},
+			{ Yo, 128.0, 128.0 }
+		};
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Inverse of affine colour transform.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto invert ( const ColorTransform& _Transform ) -> ColorTransform
+	{
+		const auto& M = _Transform.M;
+		const auto Det = M[0][0] * (M[1][1] * M[2][2] - M[1][2] * M[2][1]) - M[0][1] * (M[1][0] * M[2][2] - M[1][2] * M[2][0]) + M[0][2] * (M[1][0] * M[2][1] - M[1][1] * M[2][0]);
+		if(Det == 0) throw Error("fx::img"s, ""s, "invert"s, ERR_BAD_ARGS, "Colour transform is singular."s);
+
+		auto Result = ColorTransform();
+		auto& I = Result.M;
+		I[0][0] = (M[1][1] * M[2][2] - M[1][2] * M[2][1]) / Det;
+		I[0][1] = (M[0][2] * M[2][1] - M[0][1] * M[2][2]) / Det;
+		I[0][2] = (M[0][1] * M[1][2] - M[0][2] * M[1][1]) / Det;
+		I[1][0] = (M[1][2] * M[2][0] - M[1][0] * M[2][2]) / Det;
+		I[1][1] = (M[0][0] * M[2][2] - M[0][2] * M[2][0]) / Det;
+		I[1][2] = (M[0][2] * M[1][0] - M[0][0] * M[1][2]) / Det;
+		I[2][0] = (M[1][0] * M[2][1] - M[1][1] * M[2][0]) / Det;
+		I[2][1] = (M[0][1] * M[2][0] - M[0][0] * M[2][1]) / Det;
+		I[2][2] = (M[0][0] * M[1][1] - M[0][1] * M[1][0]) / Det;
+
+		for(auto i = 0; i < 3; ++i) Result.Offset[i] = -(I[i][0] * _Transform.Offset[0] + I[i][1] * _Transform.Offset[1] + I[i][2] * _Transform.Offset[2]);
+
+		return Result;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Colour conversion internals.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img::impl
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// u8 transforms run in 14 bit fixed point: products and sums of three 0-255 values stay well inside i32.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr auto COLOR_SHIFT = i32(14);
+
+	struct FixedTransform
+	{
+		i32 M[3][3];
+		i32 Offset[3];
+
+		FixedTransform ( const ColorTransform& _Transform )
+		{
+			for(auto i = 0; i < 3; ++i)
+			{
+				for(auto j = 0; j < 3; ++j) this->M[i][j] = i32(std::lround(_Transform.M[i][j] * r64(1 << COLOR_SHIFT)));
+				this->Offset[i] = i32(std::lround(_Transform.Offset[i] * r64(1 << COLOR_SHIFT))) + (1 << (COLOR_SHIFT - 1));
+			}
+		}
+
+		inline auto apply ( const i32 _A, const i32 _B, const i32 _C, const i32 _Row ) const -> u8
+		{
+			return u8(std::clamp((this->M[_Row][0] * _A + this->M[_Row][1] * _B + this->M[_Row][2] * _C + this->Offset[_Row]) >> COLOR_SHIFT, 0, 255));
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Check that source has at least three channels and destination matches it.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class A, class B> auto checkColor ( const ImageView<A>& _Src, const ImageView<B>& _Dst, const str& _Func ) -> void
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, _Func, ERR_EMPTY, "Image is empty."s);
+		if(_Src.depth() < 3) throw Error("fx::img"s, ""s, _Func, ERR_BAD_ARGS, "Image needs at least three channels."s);
+		if((_Src.width() != _Dst.width()) || (_Src.height() != _Dst.height()) || (_Src.depth() != _Dst.depth())) throw Error("fx::img"s, ""s, _Func, ERR_INCONSISTENT_DIM, "Inconsistent dimensions."s);
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Run _Fn(SrcPixel, DstPixel) over every pixel, rows in parallel. Depth is compile time constant for 3 and 4 channels, channels past third are copied.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class S, class T, class F> auto forEachPixel ( const ImageView<S>& _Src, const ImageView<T>& _Dst, F&& _Fn ) -> void
+	{
+		const auto W = _Src.width();
+		const auto D = _Src.depth();
+
+		thr::parallelFor(0, _Src.height(), std::max(u64(1), u64(16384) / (W * D)), [&]( const u64 _Lo, const u64 _Hi )
+		{
+			mgx::withDepth(D, [&]( auto _Depth )
+			{
+				constexpr auto FIXED = decltype(_Depth)::value;
+				const auto Dc = (FIXED == 0) ? D : FIXED;
+
+				for(auto y = _Lo; y < _Hi; ++y)
+				{
+					const auto In = _Src.row(y);
+					auto Out = _Dst.row(y);
+
+					for(auto x = u64(0); x < W; ++x)
+					{
+						_Fn(In + x * Dc, Out + x * Dc);
+						for(auto c = u64(3); c < Dc; ++c) Out[x * Dc + c] = In[x * Dc + c];
+					}
+				}
+			});
+		});
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Colour conversion.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Apply affine colour transform to first three channels. u8 runs in fixed point, r32 in multiply-add on 0-1 values.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto transformColor ( const ImageView<const mgx::identity_t<T>>& _Src, const ImageView<T>& _Dst, const ColorTransform& _Transform ) -> void
+	{
+		impl::checkColor(_Src, _Dst, "transformColor"s);
+
+		if constexpr(std::is_same_v<T, u8>)
+		{
+			const auto F = impl::FixedTransform(_Transform);
+
+			impl::forEachPixel(_Src, _Dst, [&]( const u8* _In, u8* _Out )
+			{
+				const auto A = i32(_In[0]), B = i32(_In[1]), C = i32(_In[2]);
+				_Out[0] = F.apply(A, B, C, 0);
+				_Out[1] = F.apply(A, B, C, 1);
+				_Out[2] = F.apply(A, B, C, 2);
+			});
+		}
+
+		else if constexpr(std::is_same_v<T, r32>)
+		{
+			r32 M[3][3], O[3];
+			for(auto i = 0; i < 3; ++i) { for(auto j = 0; j < 3; ++j) M[i][j] = r32(_Transform.M[i][j]); O[i] = r32(_Transform.Offset[i] / 255.0); }
+
+			impl::forEachPixel(_Src, _Dst, [&]( const r32* _In, r32* _Out )
+			{
+				const auto A = _In[0], B = _In[1], C = _In[2];
+				_Out[0] = std::fma(M[0][0], A, std::fma(M[0][1], B, std::fma(M[0][2], C, O[0])));
+				_Out[1] = std::fma(M[1][0], A, std::fma(M[1][1], B, std::fma(M[1][2], C, O[1])));
+				_Out[2] = std::fma(M[2][0], A, std::fma(M[2][1], B, std::fma(M[2][2], C, O[2])));
+			});
+		}
+
+		else static_assert(false, "fx::img::transformColor | Type not implemented.");
+	}
+
+	template<class T> auto transformColor ( const Image<T>& _Src, const ColorTransform& _Transform ) -> Image<T>
+	{
+		auto NewImage = Image<T>(_Src.width(), _Src.height(), _Src.depth());
+		transformColor<T>(_Src.view(), NewImage.view(), _Transform);
+		return NewImage;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// RGB to YCbCr and back. Chroma is centered at 128 for u8 and at 0.5 for r32.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto rgbToYCbCr ( const Image<T>& _Src, const ColorStandard _Standard = ColorStandard::BT601, const ColorRange _Range = ColorRange::FULL ) -> Image<T>
+	{
+		return transformColor(_Src, rgbToYCbCrTransform(_Standard, _Range));
+	}
+
+	template<class T> auto yCbCrToRgb ( const Image<T>& _Src, const ColorStandard _Standard = ColorStandard::BT601, const ColorRange _Range = ColorRange::FULL ) -> Image<T>
+	{
+		return transformColor(_Src, invert(rgbToYCbCrTransform(_Standard, _Range)));
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Packed RGB(A) to planar 4:2:0 stored in single channel image of width x (height * 3 / 2). Y plane comes first, then chroma in chosen layout.
+	// Chroma of every 2x2 block is taken from average of its four pixels. Width and height must be even.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto rgbToYuv420 ( const Image<u8>& _Src, const YuvLayout _Layout = YuvLayout::I420, const ColorStandard _Standard = ColorStandard::BT601, const ColorRange _Range = ColorRange::LIMITED ) -> Image<u8>
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "rgbToYuv420"s, ERR_EMPTY, "Image is empty."s);
+		if(_Src.depth() < 3) throw Error("fx::img"s, ""s, "rgbToYuv420"s, ERR_BAD_ARGS, "Image needs at least three channels."s);
+		if(!math::isEven(_Src.width()) || !math::isEven(_Src.height())) throw Error("fx::img"s, ""s, "rgbToYuv420"s, ERR_BAD_ARGS, "Width and height must be even."s);
+
+		const auto W = _Src.width();
+		const auto H = _Src.height();
+		const auto D = _Src.depth();
+		const auto F = impl::FixedTransform(rgbToYCbCrTransform(_Standard, _Range));
+
+		auto NewImage = Image<u8>(W, H + H / 2, 1);
+		const auto Luma = NewImage.data();
+		const auto ChromaU = Luma + W * H;
+		const auto ChromaV = ChromaU + (W / 2) * (H / 2);
+
+		thr::parallelFor(0, H / 2, std::max(u64(1), u64(8192) / (W * D)), [&]( const u64 _Lo, const u64 _Hi )
+		{
+			mgx::withDepth(D, [&]( auto _Depth )
+			{
+				constexpr auto FIXED = decltype(_Depth)::value;
+				const auto Dc = (FIXED == 0) ? D : FIXED;
+
+				for(auto y = _Lo; y < _Hi; ++y)
+				{
+					const auto R0 = _Src.data() + (2 * y) * W * Dc;
+					const auto R1 = R0 + W * Dc;
+					auto Y0 = Luma + (2 * y) * W;
+					auto Y1 = Y0 + W;
+
+					for(auto x = u64(0); x < W; ++x)
+					{
+						Y0[x] = F.apply(R0[x * Dc], R0[x * Dc + 1], R0[x * Dc + 2], 0);
+						Y1[x] = F.apply(R1[x * Dc], R1[x * Dc + 1], R1[x * Dc + 2], 0);
+					}
+
+					for(auto x = u64(0); x < W / 2; ++x)
+					{
+						const auto P = 2 * x * Dc;
+						const auto R = (i32(R0[P]) + R0[P + Dc] + R1[P] + R1[P + Dc] + 2) >> 2;
+						const auto G = (i32(R0[P + 1]) + R0[P + Dc + 1] + R1[P + 1] + R1[P + Dc + 1] + 2) >> 2;
+						const auto B = (i32(R0[P + 2]) + R0[P + Dc + 2] + R1[P + 2] + R1[P + Dc + 2] + 2) >> 2;
+						const auto U = F.apply(R, G, B, 1);
+						const auto V = F.apply(R, G, B, 2);
+
+						if(_Layout == YuvLayout::I420) { ChromaU[y * (W / 2) + x] = U; ChromaV[y * (W / 2) + x] = V; }
+						else { ChromaU[y * W + 2 * x] = U; ChromaU[y * W + 2 * x + 1] = V; }
+					}
+				}
+			});
+		});
+
+		return NewImage;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Planar 4:2:0 in single channel image of width x (height * 3 / 2) to packed RGB. Chroma is upsampled by repeating it over its 2x2 block.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto yuv420ToRgb ( const Image<u8>& _Src, const YuvLayout _Layout = YuvLayout::I420, const ColorStandard _Standard = ColorStandard::BT601, const ColorRange _Range = ColorRange::LIMITED ) -> Image<u8>
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "yuv420ToRgb"s, ERR_EMPTY, "Image is empty."s);
+		if((_Src.depth() != 1) || !math::isEven(_Src.width()) || (_Src.height() % 3 != 0) || !math::isEven(_Src.height() / 3))
+		{
+			throw Error("fx::img"s, ""s, "yuv420ToRgb"s, ERR_BAD_ARGS, "Image is not 4:2:0 frame of even size."s);
+		}
+
+		const auto W = _Src.width();
+		const auto H = (_Src.height() / 3) * 2;
+		const auto F = impl::FixedTransform(invert(rgbToYCbCrTransform(_Standard, _Range)));
+
+		auto NewImage = Image<u8>(W, H, 3);
+		const auto Luma = _Src.data();
+		const auto ChromaU = Luma + W * H;
+		const auto ChromaV = ChromaU + (W / 2) * (H / 2);
+
+		thr::parallelFor(0, H / 2, std::max(u64(1), u64(8192) / (W * 3)), [&]( const u64 _Lo, const u64 _Hi )
+		{
+			for(auto y = _Lo; y < _Hi; ++y)
+			{
+				for(auto x = u64(0); x < W / 2; ++x)
+				{
+					const auto U = i32((_Layout == YuvLayout::I420) ? ChromaU[y * (W / 2) + x] : ChromaU[y * W + 2 * x]);
+					const auto V = i32((_Layout == YuvLayout::I420) ? ChromaV[y * (W / 2) + x] : ChromaU[y * W + 2 * x + 1]);
+
+					for(auto dy = u64(0); dy < 2; ++dy)
+					{
+						for(auto dx = u64(0); dx < 2; ++dx)
+						{
+							const auto Px = 2 * x + dx;
+							const auto Py = 2 * y + dy;
+							const auto L = i32(Luma[Py * W + Px]);
+							auto Out = NewImage.data() + (Py * W + Px) * 3;
+							Out[0] = F.apply(L, U, V, 0);
+							Out[1] = F.apply(L, U, V, 1);
+							Out[2] = F.apply(L, U, V, 2);
+						}
+					}
+				}
+			}
+		});
+
+		return NewImage;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// RGB to HSV and back. For r32 all components are 0-1, hue 1 wraps to 0. For u8 all components are 0-255, full hue circle maps to 0-255.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto rgbToHsv ( const Image<T>& _Src ) -> Image<T>
+	{
+		static_assert(std::is_same_v<T, u8> || std::is_same_v<T, r32>, "fx::img::rgbToHsv | Type not implemented.");
+
+		auto NewImage = Image<T>(_Src.width(), _Src.height(), _Src.depth());
+		impl::checkColor(_Src.view(), NewImage.view(), "rgbToHsv"s);
+
+		impl::forEachPixel(_Src.view(), NewImage.view(), [&]( const T* _In, T* _Out )
+		{
+			const auto R = r32(_In[0]), G = r32(_In[1]), B = r32(_In[2]);
+			const auto Max = std::max(R, std::max(G, B));
+			const auto Min = std::min(R, std::min(G, B));
+			const auto Chroma = Max - Min;
+			const auto Inv = (Chroma > 0) ? r32(1) / Chroma : r32(0);
+
+			auto Hue = (Max == R) ? (G - B) * Inv : (Max == G) ? r32(2) + (B - R) * Inv : r32(4) + (R - G) * Inv;
+			Hue *= r32(1.0 / 6.0);
+			if(Hue < 0) Hue += r32(1);
+			const auto Sat = (Max > 0) ? Chroma / Max : r32(0);
+
+			if constexpr(std::is_same_v<T, u8>)
+			{
+				_Out[0] = u8(i32(Hue * 256.0f + 0.5f) & 0xFF);
+				_Out[1] = u8(Sat * 255.0f + 0.5f);
+				_Out[2] = u8(Max);
+			}
+			else
+			{
+				_Out[0] = Hue;
+				_Out[1] = Sat;
+				_Out[2] = Max;
+			}
+		});
+
+		return NewImage;
+	}
+
+	template<class T> auto hsvToRgb ( const Image<T>& _Src ) -> Image<T>
+	{
+		static_assert(std::is_same_v<T, u8> || std::is_same_v<T, r32>, "fx::img::hsvToRgb | Type not implemented.");
+
+		auto NewImage = Image<T>(_Src.width(), _Src.height(), _Src.depth());
+		impl::checkColor(_Src.view(), NewImage.view(), "hsvToRgb"s);
+
+		impl::forEachPixel(_Src.view(), NewImage.view(), [&]( const T* _In, T* _Out )
+		{
+			const auto Hue = std::is_same_v<T, u8> ? r32(_In[0]) * r32(6.0 / 256.0) : r32(_In[0]) * r32(6);
+			const auto Sat = std::is_same_v<T, u8> ? r32(_In[1]) * r32(1.0 / 255.0) : r32(_In[1]);
+			const auto Val = r32(_In[2]);
+
+			// Each component is V - V * S * clamp(min(k, 4 - k), 0, 1) with k = (n + H * 6) mod 6, branch free.
+			const auto Component = [&]( const r32 _N )
+			{
+				auto K = _N + Hue;
+				K -= (K >= r32(6)) ? r32(6) : r32(0);
+				return Val - Val * Sat * std::clamp(std::min(K, r32(4) - K), r32(0), r32(1));
+			};
+
+			if constexpr(std::is_same_v<T, u8>)
+			{
+				_Out[0] = u8(Component(5) + 0.5f);
+				_Out[1] = u8(Component(3) + 0.5f);
+				_Out[2] = u8(Component(1) + 0.5f);
+			}
+			else
+			{
+				_Out[0] = Component(5);
+				_Out[1] = Component(3);
+				_Out[2] = Component(1);
+			}
+		});
+
+		return NewImage;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Linear sRGB (0-1, D65) to CIE L*a*b* and back. L is 0-100, a and b are roughly -128 to 127.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto linearRgbToLab ( const Image<r32>& _Src ) -> Image<r32>
+	{
+		constexpr auto EPS = r32(216.0 / 24389.0);
+		constexpr auto KAPPA = r32(24389.0 / 27.0);
+
+		auto NewImage = Image<r32>(_Src.width(), _Src.height(), _Src.depth());
+		impl::checkColor(_Src.view(), NewImage.view(), "linearRgbToLab"s);
+
+		impl::forEachPixel(_Src.view(), NewImage.view(), [&]( const r32* _In, r32* _Out )
+		{
+			const auto R = _In[0], G = _In[1], B = _In[2];
+
+			// sRGB to XYZ, already divided by D65 white point.
+			const auto X = std::fma(r32(0.4339499), R, std::fma(r32(0.3762098), G, r32(0.1898403) * B));
+			const auto Y = std::fma(r32(0.2126729), R, std::fma(r32(0.7151521), G, r32(0.0721750) * B));
+			const auto Z = std::fma(r32(0.0177566), R, std::fma(r32(0.1094680), G, r32(0.8727755) * B));
+
+			const auto F = [&]( const r32 _T ) { return (_T > EPS) ? std::cbrt(_T) : (KAPPA * _T + r32(16)) / r32(116); };
+			const auto Fx = F(X), Fy = F(Y), Fz = F(Z);
+
+			_Out[0] = r32(116) * Fy - r32(16);
+			_Out[1] = r32(500) * (Fx - Fy);
+			_Out[2] = r32(200) * (Fy - Fz);
+		});
+
+		return NewImage;
+	}
+
+	inline auto labToLinearRgb ( const Image<r32>& _Src ) -> Image<r32>
+	{
+		constexpr auto EPS = r32(6.0 / 29.0);
+		constexpr auto KAPPA = r32(24389.0 / 27.0);
+
+		auto NewImage = Image<r32>(_Src.width(), _Src.height(), _Src.depth());
+		impl::checkColor(_Src.view(), NewImage.view(), "labToLinearRgb"s);
+
+		impl::forEachPixel(_Src.view(), NewImage.view(), [&]( const r32* _In, r32* _Out )
+		{
+			const auto Fy = (_In[0] + r32(16)) / r32(116);
+			const auto Fx = std::fma(_In[1], r32(1.0 / 500.0), Fy);
+			const auto Fz = std::fma(_In[2], r32(-1.0 / 200.0), Fy);
+
+			const auto F = [&]( const r32 _T ) { return (_T > EPS) ? _T * _T * _T : (r32(116) * _T - r32(16)) / KAPPA; };
+			const auto X = F(Fx), Y = F(Fy), Z = F(Fz);
+
+			// XYZ relative to D65 white back to sRGB.
+			_Out[0] = std::fma(r32(3.0799551), X, std::fma(r32(-1.5371390), Y, r32(-0.5428161) * Z));
+			_Out[1] = std::fma(r32(-0.9212586), X, std::fma(r32(1.8760111), Y, r32(0.0452475) * Z));
+			_Out[2] = std::fma(r32(0.0528874), X, std::fma(r32(-0.2040259), Y, r32(1.1511385) * Z));
+		});
+
+		return NewImage;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: sRGB transfer.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Decode sRGB u8 image to linear light r32 (0-1) through 256 entry table. For 2 and 4 channels last channel is alpha and is only scaled.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto srgbToLinear ( const Image<u8>& _Src ) -> Image<r32>
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "srgbToLinear"s, ERR_EMPTY, "Image is empty."s);
+
+		const auto& Table = srgbDecodeTable();
+		const auto D = _Src.depth();
+		const auto Colors = ((D == 2) || (D == 4)) ? D - 1 : D;
+		auto NewImage = Image<r32>(_Src.width(), _Src.height(), D);
+
+		thr::parallelFor(0, _Src.height(), std::max(u64(1), u64(16384) / (_Src.width() * D)), [&]( const u64 _Lo, const u64 _Hi )
+		{
+			const auto In = _Src.data() + _Lo * _Src.width() * D;
+			auto Out = NewImage.data() + _Lo * _Src.width() * D;
+			const auto Count = (_Hi - _Lo) * _Src.width() * D;
+
+			for(auto i = u64(0); i < Count; ++i) Out[i] = Table[In[i]];
+			if(Colors != D) for(auto i = Colors; i < Count; i += D) Out[i] = r32(In[i]) * (1.0f / 255.0f);
+		});
+
+		return NewImage;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Encode linear light r32 image to sRGB u8 through interpolated table. For 2 and 4 channels last channel is alpha and is only scaled.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto linearToSrgb ( const Image<r32>& _Src ) -> Image<u8>
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "linearToSrgb"s, ERR_EMPTY, "Image is empty."s);
+
+		const auto& Table = srgbEncodeTable();
+		const auto D = _Src.depth();
+		const auto Colors = ((D == 2) || (D == 4)) ? D - 1 : D;
+		auto NewImage = Image<u8>(_Src.width(), _Src.height(), D);
+
+		thr::parallelFor(0, _Src.height(), std::max(u64(1), u64(16384) / (_Src.width() * D)), [&]( const u64 _Lo, const u64 _Hi )
+		{
+			const auto In = _Src.data() + _Lo * _Src.width() * D;
+			auto Out = NewImage.data() + _Lo * _Src.width() * D;
+			const auto Count = (_Hi - _Lo) * _Src.width() * D;
+
+			for(auto i = u64(0); i < Count; ++i)
+			{
+				const auto Pos = std::clamp(In[i], 0.0f, 1.0f) * r32(SRGB_ENCODE_STEPS);
+				const auto Idx = u32(Pos);
+				Out[i] = u8(Table[Idx] + (Table[Idx + 1] - Table[Idx]) * (Pos - r32(Idx)) + 0.5f);
+			}
+
+			if(Colors != D) for(auto i = Colors; i < Count; i += D) Out[i] = u8(std::clamp(In[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+		});
+
+		return NewImage;
+	}
+}
@@ -0,0 +1,135 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include "./Error.hpp"
+#include "./Image.hpp"
+#include "./Threads.hpp"
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Distance transform internals.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img::impl
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Lower envelope of parabolas (q - i)^2 + _F[i] over row of _Count samples (P. Felzenszwalb, D. Huttenlocher). Writes squared distances to _Out.
+	// _V and _Z are scratch of _Count and _Count + 1 entries.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto lowerEnvelope ( const r64* _F, const u64 _Count, r64* _Out, i64* _V, r64* _Z ) -> void
+	{
+		auto K = i64(0);
+		_V[0] = 0;
+		_Z[0] = -std::numeric_limits<r64>::infinity();
+		_Z[1] = std::numeric_limits<r64>::infinity();
+
+		for(auto q = i64(1); q < i64(_Count); ++q)
+		{
+			auto S = r64(0);
+			while(true)
+			{
+				const auto P = _V[K];
+				S = ((_F[q] + r64(q * q)) - (_F[P] + r64(P * P))) / r64(2 * (q - P));
+				if((S > _Z[K]) || (K == 0)) break;
+				--K;
+			}
+
+			++K;
+			_V[K] = q;
+			_Z[K] = S;
+			_Z[K + 1] = std::numeric_limits<r64>::infinity();
+		}
+
+		K = 0;
+		for(auto q = i64(0); q < i64(_Count); ++q)
+		{
+			while(_Z[K + 1] < r64(q)) ++K;
+			const auto P = _V[K];
+			_Out[q] = r64((q - P) * (q - P)) + _F[P];
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Distance transform.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Exact Euclidean distance of every pixel to nearest zero pixel of single channel mask, zero pixels get 0. Mask without zero pixels gives infinity everywhere.
+	// Column pass is two linear scans over whole rows in parallel blocks of columns, row pass is linear lower envelope of parabolas on rows in parallel.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto distanceTransform ( const Image<u8>& _Src ) -> Image<r32>
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "distanceTransform"s, ERR_EMPTY, "Image is empty."s);
+		if(_Src.depth() != 1) throw Error("fx::img"s, ""s, "distanceTransform"s, ERR_NOT_FLAT, "Image is not flat."s);
+
+		const auto W = _Src.width();
+		const auto H = _Src.height();
+
+		// Stands for column without zero pixel. Larger than any real distance, small enough to stay exact when squared.
+		const auto Far = r32(W + H);
+
+		auto NewImage = Image<r32>(W, H, 1);
+
+		// Vertical distance to nearest zero in column, kept in output until row pass. Column blocks give every thread about four blocks,
+		// whole 64 byte lines of r32 and at least 64 columns, so rows of block still stream.
+		const auto Block = std::clamp((W / ((thr::sharedPool().size() + 1) * 4) + 15) & ~u64(15), u64(64), u64(1024));
+		thr::parallelFor(0, (W + Block - 1) / Block, 1, [&]( const u64 _Lo, const u64 _Hi )
+		{
+			for(auto b = _Lo; b < _Hi; ++b)
+			{
+				const auto X0 = b * Block;
+				const auto N = std::min(W, X0 + Block) - X0;
+
+				const auto First = _Src.data() + X0;
+				for(auto i = u64(0); i < N; ++i) NewImage[X0 + i] = (First[i] == 0) ? 0.0f : Far;
+
+				for(auto y = u64(1); y < H; ++y)
+				{
+					const auto In = _Src.data() + y * W + X0;
+					const auto Above = NewImage.data() + (y - 1) * W + X0;
+					auto Out = NewImage.data() + y * W + X0;
+					for(auto i = u64(0); i < N; ++i) Out[i] = (In[i] == 0) ? 0.0f : std::min(Far, Above[i] + 1.0f);
+				}
+
+				for(auto y = H - 1; y > 0; --y)
+				{
+					const auto Below = NewImage.data() + y * W + X0;
+					auto Out = NewImage.data() + (y - 1) * W + X0;
+					for(auto i = u64(0); i < N; ++i) Out[i] = std::min(Out[i], Below[i] + 1.0f);
+				}
+			}
+		});
+
+		const auto FarSqr = r64(Far) * r64(Far);
+
+		thr::parallelFor(0, H, std::max(u64(1), u64(4096) / W), [&]( const u64 _Lo, const u64 _Hi )
+		{
+			auto F = std::vector<r64>(W);
+			auto D = std::vector<r64>(W);
+			auto V = std::vector<i64>(W);
+			auto Z = std::vector<r64>(W + 1);
+
+			for(auto y = _Lo; y < _Hi; ++y)
+			{
+				auto Row = NewImage.data() + y * W;
+				for(auto x = u64(0); x < W; ++x) F[x] = r64(Row[x]) * r64(Row[x]);
+
+				impl::lowerEnvelope(F.data(), W, D.data(), V.data(), Z.data());
+
+				for(auto x = u64(0); x < W; ++x) Row[x] = (D[x] >= FarSqr) ? std::numeric_limits<r32>::infinity() : r32(std::sqrt(D[x]));
+			}
+		});
+
+		return NewImage;
+	}
+}
@@ -0,0 +1,288 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include "./Error.hpp"
+#include "./Image.hpp"
+#include "./Threads.hpp"
+#include "./ImageFilter.hpp"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Gradients.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// 3x3 derivative operators. SOBEL smooths across derivative with [1 2 1], SCHARR with [3 10 3] for better rotational symmetry.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	enum struct OpGradient { SOBEL, SCHARR };
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Gradient magnitude and direction. Direction is atan2(dy, dx) in radians, y pointing down.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	struct Gradient
+	{
+		Image<r32> Magnitude;
+		Image<r32> Direction;
+	};
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Edge internals.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img::impl
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Derivatives of _Count pixels from three rows padded by one pixel on each side. Output pixel x is centered on padded x + 1.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto gradientRow ( const r32* _Up, const r32* _Mid, const r32* _Down, const u64 _Count, const r32 _Side, const r32 _Center, r32* _Dx, r32* _Dy ) -> void
+	{
+		for(auto x = u64(0); x < _Count; ++x)
+		{
+			_Dx[x] = _Side * (_Up[x + 2] - _Up[x]) + _Center * (_Mid[x + 2] - _Mid[x]) + _Side * (_Down[x + 2] - _Down[x]);
+			_Dy[x] = _Side * (_Down[x] - _Up[x]) + _Center * (_Down[x + 1] - _Up[x + 1]) + _Side * (_Down[x + 2] - _Up[x + 2]);
+		}
+	}
+
+	inline auto gradientWeights ( const OpGradient _Op ) -> std::pair<r32, r32>
+	{
+		return (_Op == OpGradient::SCHARR) ? std::pair<r32, r32>(3.0f, 10.0f) : std::pair<r32, r32>(1.0f, 2.0f);
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Canny tile. Output tile plus halo of two pixels for gradients and suppression plus kernel radius for blur.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr auto CANNY_TILE_W = u64(256);
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Hysteresis marks.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr auto CANNY_WEAK = u8(1);
+	constexpr auto CANNY_STRONG = u8(2);
+	constexpr auto CANNY_EDGE = u8(255);
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Gradients.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Gradient magnitude and direction of single channel image. Each row is computed straight from three padded source rows, no full size derivative images.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto gradient ( const Image<T>& _Src, const OpGradient _Op = OpGradient::SOBEL, const Border _Border = Border::REFLECT ) -> Gradient
+	{
+		static_assert(std::is_arithmetic_v<T>, "fx::img::gradient | Type not implemented.");
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "gradient"s, ERR_EMPTY, "Image is empty."s);
+		if(_Src.depth() != 1) throw Error("fx::img"s, ""s, "gradient"s, ERR_NOT_FLAT, "Image is not flat."s);
+
+		const auto W = _Src.width();
+		const auto H = _Src.height();
+		const auto [Side, Center] = impl::gradientWeights(_Op);
+
+		auto Result = Gradient{ Image<r32>(W, H, 1), Image<r32>(W, H, 1) };
+
+		thr::parallelFor(0, H, std::max(u64(1), u64(16384) / W), [&]( const u64 _Lo, const u64 _Hi )
+		{
+			auto Rows = std::vector<r32>(3 * (W + 2));
+			auto Dx = std::vector<r32>(W);
+			auto Dy = std::vector<r32>(W);
+
+			for(auto y = _Lo; y < _Hi; ++y)
+			{
+				for(auto k = 0; k < 3; ++k)
+				{
+					const auto SrcY = u64(borderIndex(i64(y) + k - 1, i64(H), _Border));
+					impl::padRow(_Src.data() + SrcY * W, W, 1, 1, _Border, Rows.data() + k * (W + 2));
+				}
+
+				impl::gradientRow(Rows.data(), Rows.data() + (W + 2), Rows.data() + 2 * (W + 2), W, Side, Center, Dx.data(), Dy.data());
+
+				auto Mag = Result.Magnitude.data() + y * W;
+				auto Dir = Result.Direction.data() + y * W;
+				for(auto x = u64(0); x < W; ++x) Mag[x] = std::sqrt(Dx[x] * Dx[x] + Dy[x] * Dy[x]);
+				for(auto x = u64(0); x < W; ++x) Dir[x] = std::atan2(Dy[x], Dx[x]);
+			}
+		});
+
+		return Result;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Canny edge detector. Returns 255 on edges, 0 elsewhere. Thresholds are in units of Sobel magnitude of blurred image.
+	// Blur, gradients and non-maximum suppression run together per tile in parallel, so intermediates never leave tile sized buffers. Only weak / strong marks
+	// are stored at full size, then hysteresis links weak pixels to strong ones with explicit stack. Zero or negative sigma skips blur.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto canny ( const Image<u8>& _Src, const r32 _Low, const r32 _High, const r64 _Sigma = 1.4, const Border _Border = Border::REFLECT ) -> Image<u8>
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "canny"s, ERR_EMPTY, "Image is empty."s);
+		if(_Src.depth() != 1) throw Error("fx::img"s, ""s, "canny"s, ERR_NOT_FLAT, "Image is not flat."s);
+		if(_Low > _High) throw Error("fx::img"s, ""s, "canny"s, ERR_BAD_ARGS, "Low threshold is above high threshold."s);
+
+		const auto W = _Src.width();
+		const auto H = _Src.height();
+		const auto Blur = (_Sigma > 0) ? kernelGaussian(_Sigma) : kernelIdentity();
+		const auto R = Blur.radius();
+		const auto Taps = Blur.size();
+		const auto TileW = impl::CANNY_TILE_W;
+		const auto TileH = impl::stripeRows(TileW * 6 * sizeof(r32), R + 2);
+		const auto TilesX = (W + TileW - 1) / TileW;
+		const auto TilesY = (H + TileH - 1) / TileH;
+
+		// tan(22.5) and tan(67.5) split gradient directions into four sectors.
+		constexpr auto TAN_LOW = 0.41421356f;
+		constexpr auto TAN_HIGH = 2.41421356f;
+
+		auto Marks = Image<u8>(W, H, 1);
+
+		thr::parallelFor(0, TilesX * TilesY, 1, [&]( const u64 _Lo, const u64 _Hi )
+		{
+			// Logical columns of tile: source needs X0 - 2 - R .. X1 + 2 + R, blurred X0 - 2 .. X1 + 2, magnitude X0 - 1 .. X1 + 1.
+			const auto MaxB = TileW + 4;
+			const auto MaxS = MaxB + 2 * R;
+			auto SrcX = std::vector<u64>(MaxS);
+			auto SrcRow = std::vector<r32>(MaxS);
+			auto Horizontal = std::vector<r32>((TileH + 4 + 2 * R) * MaxB);
+			auto Blurred = std::vector<r32>((TileH + 4) * MaxB);
+			auto Mag = std::vector<r32>((TileH + 2) * (TileW + 2));
+			auto Dx = std::vector<r32>((TileH + 2) * (TileW + 2));
+			auto Dy = std::vector<r32>((TileH + 2) * (TileW + 2));
+
+			for(auto t = _Lo; t < _Hi; ++t)
+			{
+				const auto X0 = (t % TilesX) * TileW;
+				const auto Y0 = (t / TilesX) * TileH;
+				const auto Nx = std::min(W, X0 + TileW) - X0;
+				const auto Ny = std::min(H, Y0 + TileH) - Y0;
+				const auto Bw = Nx + 4;
+				const auto Sw = Bw + 2 * R;
+				const auto Mw = Nx + 2;
+
+				for(auto i = u64(0); i < Sw; ++i) SrcX[i] = u64(borderIndex(i64(X0 + i) - i64(R) - 2, i64(W), _Border));
+
+				// Blur rows.
+				for(auto i = u64(0); i < Ny + 4 + 2 * R; ++i)
+				{
+					const auto Row = _Src.data() + u64(borderIndex(i64(Y0 + i) - i64(R) - 2, i64(H), _Border)) * W;
+					for(auto j = u64(0); j < Sw; ++j) SrcRow[j] = r32(Row[SrcX[j]]);
+
+					auto Out = Horizontal.data() + i * MaxB;
+					std::fill(Out, Out + Bw, 0.0f);
+					for(auto k = u64(0); k < Taps; ++k)
+					{
+						const auto Tap = Blur.Taps[k];
+						const auto In = SrcRow.data() + k;
+						for(auto j = u64(0); j < Bw; ++j) Out[j] += Tap * In[j];
+					}
+				}
+
+				// Blur columns.
+				for(auto i = u64(0); i < Ny + 4; ++i)
+				{
+					auto Out = Blurred.data() + i * MaxB;
+					std::fill(Out, Out + Bw, 0.0f);
+					for(auto k = u64(0); k < Taps; ++k)
+					{
+						const auto Tap = Blur.Taps[k];
+						const auto In = Horizontal.data() + (i + k) * MaxB;
+						for(auto j = u64(0); j < Bw; ++j) Out[j] += Tap * In[j];
+					}
+				}
+
+				// Sobel gradients.
+				for(auto i = u64(0); i < Ny + 2; ++i)
+				{
+					const auto Up = Blurred.data() + i * MaxB;
+					const auto GDx = Dx.data() + i * Mw;
+					const auto GDy = Dy.data() + i * Mw;
+					impl::gradientRow(Up, Up + MaxB, Up + 2 * MaxB, Mw, 1.0f, 2.0f, GDx, GDy);
+
+					auto M = Mag.data() + i * Mw;
+					for(auto j = u64(0); j < Mw; ++j) M[j] = std::sqrt(GDx[j] * GDx[j] + GDy[j] * GDy[j]);
+				}
+
+				// Non-maximum suppression along gradient direction, ties broken towards lower neighbour.
+				for(auto i = u64(0); i < Ny; ++i)
+				{
+					const auto Above = Mag.data() + i * Mw;
+					const auto Here = Above + Mw;
+					const auto Below = Here + Mw;
+					const auto GDx = Dx.data() + (i + 1) * Mw;
+					const auto GDy = Dy.data() + (i + 1) * Mw;
+					auto Out = Marks.data() + (Y0 + i) * W + X0;
+
+					for(auto j = u64(0); j < Nx; ++j)
+					{
+						const auto M = Here[j + 1];
+						if(M <= _Low) { Out[j] = 0; continue; }
+
+						const auto Ax = std::abs(GDx[j + 1]);
+						const auto Ay = std::abs(GDy[j + 1]);
+						auto Before = r32(0);
+						auto After = r32(0);
+
+						if(Ay <= Ax * TAN_LOW) { Before = Here[j]; After = Here[j + 2]; }
+						else if(Ay >= Ax * TAN_HIGH) { Before = Above[j + 1]; After = Below[j + 1]; }
+						else if((GDx[j + 1] > 0) == (GDy[j + 1] > 0)) { Before = Above[j]; After = Below[j + 2]; }
+						else { Before = Above[j + 2]; After = Below[j]; }
+
+						Out[j] = ((M > Before) && (M >= After)) ? ((M > _High) ? impl::CANNY_STRONG : impl::CANNY_WEAK) : u8(0);
+					}
+				}
+			}
+		});
+
+		// Hysteresis: flood from strong pixels through weak ones.
+		auto Stack = std::vector<u64>();
+		for(auto p = u64(0); p < W * H; ++p)
+		{
+			if(Marks[p] != impl::CANNY_STRONG) continue;
+
+			Marks[p] = impl::CANNY_EDGE;
+			Stack.push_back(p);
+
+			while(!Stack.empty())
+			{
+				const auto Q = Stack.back();
+				Stack.pop_back();
+
+				const auto X = Q % W;
+				const auto Y = Q / W;
+				const auto XLo = (X > 0) ? X - 1 : X;
+				const auto XHi = std::min(W - 1, X + 1);
+				const auto YLo = (Y > 0) ? Y - 1 : Y;
+				const auto YHi = std::min(H - 1, Y + 1);
+
+				for(auto Ny = YLo; Ny <= YHi; ++Ny)
+				{
+					for(auto Nx = XLo; Nx <= XHi; ++Nx)
+					{
+						const auto N = Ny * W + Nx;
+						if((Marks[N] != impl::CANNY_WEAK) && (Marks[N] != impl::CANNY_STRONG)) continue;
+
+						Marks[N] = impl::CANNY_EDGE;
+						Stack.push_back(N);
+					}
+				}
+			}
+		}
+
+		thr::parallelFor(0, H, std::max(u64(1), u64(65536) / W), [&]( const u64 _Lo, const u64 _Hi )
+		{
+			auto Ptr = Marks.data() + _Lo * W;
+			const auto End = Marks.data() + _Hi * W;
+			for(; Ptr < End; ++Ptr) *Ptr = (*Ptr == impl::CANNY_EDGE) ? impl::CANNY_EDGE : u8(0);
+		});
+
+		return Marks;
+	}
+}
@@ -0,0 +1,725 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include "./Error.hpp"
+#include "./Image.hpp"
+#include "./Threads.hpp"
+#include "./magic.hpp"
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <type_traits>
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Filter kernels and border handling.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// What lies beyond image edge. CLAMP repeats edge pixel (aaa|abcd|ddd), REFLECT mirrors without repeating it (cb|abcd|cb), WRAP tiles image (cd|abcd|ab).
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	enum struct Border { CLAMP, REFLECT, WRAP };
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Map coordinate outside [0, _Size) back inside.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr inline auto borderIndex ( i64 _Index, const i64 _Size, const Border _Border ) -> i64
+	{
+		if((_Index >= 0) && (_Index < _Size)) return _Index;
+
+		if(_Border == Border::CLAMP) return (_Index < 0) ? 0 : _Size - 1;
+
+		if(_Border == Border::WRAP) return ((_Index % _Size) + _Size) % _Size;
+
+		if(_Size == 1) return 0;
+		const auto Period = 2 * _Size - 2;
+		_Index = std::abs(_Index) % Period;
+		return (_Index < _Size) ? _Index : Period - _Index;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// 1D kernel. Odd number of taps, centered. Taps are applied as correlation: tap i weighs pixel at offset i - radius().
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	struct Kernel
+	{
+		std::vector<r32> Taps;
+
+		inline auto size ( void ) const -> u64 { return this->Taps.size(); }
+		inline auto radius ( void ) const -> u64 { return this->Taps.size() / 2; }
+		inline auto sum ( void ) const -> r64 { auto S = r64(0); for(auto W : this->Taps) S += W; return S; }
+		inline auto sumAbs ( void ) const -> r64 { auto S = r64(0); for(auto W : this->Taps) S += std::abs(W); return S; }
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Custom kernel from taps.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto kernel ( const std::vector<r32>& _Taps ) -> Kernel
+	{
+		if(_Taps.empty() || math::isEven(_Taps.size())) throw Error("fx::img"s, ""s, "kernel"s, ERR_BAD_ARGS, "Kernel needs odd number of taps."s);
+		return Kernel{ _Taps };
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Normalized box kernel of 2 * _Radius + 1 taps.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto kernelBox ( const u64 _Radius ) -> Kernel
+	{
+		return Kernel{ std::vector<r32>(2 * _Radius + 1, r32(1.0 / r64(2 * _Radius + 1))) };
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Normalized Gaussian kernel. Zero radius picks ceil(3 * sigma).
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto kernelGaussian ( const r64 _Sigma, const u64 _Radius = 0 ) -> Kernel
+	{
+		if(_Sigma <= 0) throw Error("fx::img"s, ""s, "kernelGaussian"s, ERR_BAD_ARGS, "Sigma must be positive."s);
+
+		const auto Radius = (_Radius == 0) ? std::max(u64(1), u64(std::ceil(3.0 * _Sigma))) : _Radius;
+		auto Taps = std::vector<r64>(2 * Radius + 1);
+		auto Sum = r64(0);
+
+		for(auto i = u64(0); i < Taps.size(); ++i)
+		{
+			const auto X = r64(i) - r64(Radius);
+			Taps[i] = std::exp(-(X * X) / (2.0 * _Sigma * _Sigma));
+			Sum += Taps[i];
+		}
+
+		auto Result = Kernel();
+		for(auto W : Taps) Result.Taps.push_back(r32(W / Sum));
+		return Result;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// 3 tap Sobel factors. Order 0 smooths [1 2 1], order 1 differentiates [-1 0 1], order 2 is [1 -2 1].
+	// Sobel X is kernelSobel(1) horizontally with kernelSobel(0) vertically.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto kernelSobel ( const u64 _Order ) -> Kernel
+	{
+		if(_Order == 0) return Kernel{ { 1, 2, 1 } };
+		if(_Order == 1) return Kernel{ { -1, 0, 1 } };
+		if(_Order == 2) return Kernel{ { 1, -2, 1 } };
+		throw Error("fx::img"s, ""s, "kernelSobel"s, ERR_BAD_ARGS, "Order must be 0, 1 or 2."s);
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Identity kernel. Use to filter in one direction only.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto kernelIdentity ( void ) -> Kernel { return Kernel{ { 1 } }; }
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Convert accumulated value to output type. Integers are rounded and saturated.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class O, class A> constexpr inline auto saturate ( const A _Val ) -> O
+	{
+		if constexpr(std::is_floating_point_v<O>) return O(_Val);
+		else
+		{
+			const auto Rounded = std::nearbyint(r64(_Val));
+			return O(std::clamp(Rounded, r64(std::numeric_limits<O>::lowest()), r64(std::numeric_limits<O>::max())));
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Separable convolution internals.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img::impl
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Rows of horizontal pass kept per stripe. Sized so intermediate rows of one stripe stay in L2.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr auto STRIPE_BYTES = u64(256) << 10;
+	constexpr auto FIXED_MAX_TAPS = u64(15);
+
+	inline auto stripeRows ( const u64 _RowBytes, const u64 _Halo ) -> u64
+	{
+		const auto Fit = STRIPE_BYTES / std::max(u64(1), _RowBytes);
+		return std::max(u64(8), (Fit > 2 * _Halo) ? Fit - 2 * _Halo : u64(0));
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Quantize taps to integers scaled by 2^_Shift. Rounding error is folded into center tap, so flat areas keep exact level.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto quantize ( const Kernel& _Kernel, const i32 _Shift ) -> std::vector<i32>
+	{
+		auto Taps = std::vector<i32>(_Kernel.size());
+		auto Sum = i64(0);
+
+		for(auto i = u64(0); i < Taps.size(); ++i) { Taps[i] = i32(std::lround(r64(_Kernel.Taps[i]) * r64(1 << _Shift))); Sum += Taps[i]; }
+		Taps[_Kernel.radius()] += i32(std::llround(_Kernel.sum() * r64(1 << _Shift)) - Sum);
+
+		return Taps;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Copy source row into padded buffer, filling _Radius pixels on each side per border rule.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T, class B> auto padRow ( const T* _Row, const u64 _Width, const u64 _Depth, const u64 _Radius, const Border _Border, B* _Dst ) -> void
+	{
+		for(auto i = u64(0); i < _Width * _Depth; ++i) _Dst[_Radius * _Depth + i] = B(_Row[i]);
+
+		for(auto k = u64(0); k < _Radius; ++k)
+		{
+			const auto Left = u64(borderIndex(i64(k) - i64(_Radius), i64(_Width), _Border));
+			const auto Right = u64(borderIndex(i64(_Width + k), i64(_Width), _Border));
+
+			for(auto c = u64(0); c < _Depth; ++c)
+			{
+				_Dst[k * _Depth + c] = B(_Row[Left * _Depth + c]);
+				_Dst[(_Radius + _Width + k) * _Depth + c] = B(_Row[Right * _Depth + c]);
+			}
+		}
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Shared stripe driver. _Horizontal(SrcRowIndex, HBufRow) fills one intermediate row, _Vertical(Rows[], DstRow) combines them.
+	// Stripes run in parallel, each owns its intermediate buffer. Callbacks are shared by all threads, so their own scratch must be thread_local.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class H, class FH, class FV> auto runStripes ( const u64 _Width, const u64 _Height, const u64 _Depth, const u64 _RadiusY, const Border _Border, FH&& _Horizontal, FV&& _Vertical ) -> void
+	{
+		const auto RowSize = _Width * _Depth;
+		const auto Rows = stripeRows(RowSize * sizeof(H), _RadiusY);
+		const auto Stripes = (_Height + Rows - 1) / Rows;
+
+		thr::parallelFor(0, Stripes, 1, [&]( const u64 _Lo, const u64 _Hi )
+		{
+			auto Buffer = std::vector<H>((Rows + 2 * _RadiusY) * RowSize);
+			auto Pointers = std::vector<const H*>(2 * _RadiusY + 1);
+
+			for(auto S = _Lo; S < _Hi; ++S)
+			{
+				const auto Y0 = S * Rows;
+				const auto Y1 = std::min(_Height, Y0 + Rows);
+				const auto Count = (Y1 - Y0) + 2 * _RadiusY;
+
+				for(auto r = u64(0); r < Count; ++r)
+				{
+					const auto SrcY = u64(borderIndex(i64(Y0 + r) - i64(_RadiusY), i64(_Height), _Border));
+					_Horizontal(SrcY, Buffer.data() + r * RowSize);
+				}
+
+				for(auto Y = Y0; Y < Y1; ++Y)
+				{
+					for(auto k = u64(0); k < Pointers.size(); ++k) Pointers[k] = Buffer.data() + (Y - Y0 + k) * RowSize;
+					_Vertical(Pointers.data(), Y);
+				}
+			}
+		});
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Separable convolution.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Separable convolution of _Src into _Dst with _KernelX along rows and _KernelY along columns.
+	// u8 to u8 with kernels up to 15 taps runs in fixed point: 32 bit accumulators, horizontal sums rounded into 16 bit intermediate rows.
+	// Result stays within 1 of correctly rounded r32 convolution.
+	// Everything else runs in r32 with multiply-add over whole rows, so compiler emits FMA where target has it.
+	// Work is cut in horizontal stripes whose intermediate rows fit L2, stripes run in parallel.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T, class O> auto convolve ( const ImageView<const mgx::identity_t<T>>& _Src, const ImageView<O>& _Dst, const Kernel& _KernelX, const Kernel& _KernelY, const Border _Border = Border::CLAMP ) -> void
+	{
+		static_assert(std::is_arithmetic_v<T> && std::is_arithmetic_v<O>, "fx::img::convolve | Type not implemented.");
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "convolve"s, ERR_EMPTY, "Image is empty."s);
+		if((_Src.width() != _Dst.width()) || (_Src.height() != _Dst.height()) || (_Src.depth() != _Dst.depth())) throw Error("fx::img"s, ""s, "convolve"s, ERR_INCONSISTENT_DIM, "Inconsistent dimensions."s);
+		if(_KernelX.Taps.empty() || _KernelY.Taps.empty() || math::isEven(_KernelX.size()) || math::isEven(_KernelY.size()))
+		{
+			throw Error("fx::img"s, ""s, "convolve"s, ERR_BAD_ARGS, "Kernels need odd number of taps."s);
+		}
+
+		const auto W = _Src.width();
+		const auto H = _Src.height();
+		const auto D = _Src.depth();
+		const auto RowSize = W * D;
+		const auto Rx = _KernelX.radius();
+		const auto Ry = _KernelY.radius();
+
+		const auto UseFixed = std::is_same_v<T, u8> && std::is_same_v<O, u8> && (_KernelX.size() <= impl::FIXED_MAX_TAPS) && (_KernelY.size() <= impl::FIXED_MAX_TAPS);
+
+		if constexpr(std::is_same_v<T, u8> && std::is_same_v<O, u8>) if(UseFixed)
+		{
+			// Taps get 14 bit precision scaled down by kernel gain. Horizontal sums are rounded to Frac fractional bits, the most that keeps
+			// 255 * sum|q| within i16, instead of quantizing taps themselves that coarsely.
+			const auto ShiftX = std::clamp(i32(14 - std::ceil(std::log2(std::max(1.0, _KernelX.sumAbs())))), 0, 14);
+			const auto Qx = impl::quantize(_KernelX, ShiftX);
+			auto GainX = i64(0);
+			for(auto Q : Qx) GainX += std::abs(Q);
+
+			auto Frac = ShiftX;
+			while((Frac > 0) && ((((255 * GainX) >> (ShiftX - Frac)) + 1) > 32767)) --Frac;
+			const auto DropX = ShiftX - Frac;
+			const auto RoundX = (DropX > 0) ? (i32(1) << (DropX - 1)) : 0;
+
+			const auto ShiftY = std::clamp(i32(14 - std::ceil(std::log2(std::max(1.0, _KernelY.sumAbs())))), 0, 14);
+			const auto Qy = impl::quantize(_KernelY, ShiftY);
+			const auto Shift = Frac + ShiftY;
+			const auto Round = (Shift > 0) ? (i32(1) << (Shift - 1)) : 0;
+
+			impl::runStripes<i16>(W, H, D, Ry, _Border,
+				[&]( const u64 _Y, i16* _Out )
+				{
+					thread_local auto Padded = std::vector<u8>();
+					thread_local auto Sums = std::vector<i32>();
+					Padded.resize((W + 2 * Rx) * D);
+					impl::padRow(_Src.row(_Y), W, D, Rx, _Border, Padded.data());
+					Sums.assign(RowSize, RoundX);
+
+					for(auto k = u64(0); k < Qx.size(); ++k)
+					{
+						const auto Q = Qx[k];
+						const auto In = Padded.data() + k * D;
+						if(Q != 0) for(auto i = u64(0); i < RowSize; ++i) Sums[i] += Q * i32(In[i]);
+					}
+
+					for(auto i = u64(0); i < RowSize; ++i) _Out[i] = i16(Sums[i] >> DropX);
+				},
+				[&]( const i16* const* _Rows, const u64 _Y )
+				{
+					thread_local auto Acc = std::vector<i32>();
+					Acc.assign(RowSize, Round);
+
+					for(auto k = u64(0); k < Qy.size(); ++k)
+					{
+						const auto Q = Qy[k];
+						const auto In = _Rows[k];
+						if(Q != 0) for(auto i = u64(0); i < RowSize; ++i) Acc[i] += Q * i32(In[i]);
+					}
+
+					auto Out = _Dst.row(_Y);
+					for(auto i = u64(0); i < RowSize; ++i) Out[i] = u8(std::clamp(Acc[i] >> Shift, 0, 255));
+				});
+
+			return;
+		}
+
+
+		impl::runStripes<r32>(W, H, D, Ry, _Border,
+			[&]( const u64 _Y, r32* _Out )
+			{
+				thread_local auto Padded = std::vector<r32>();
+				Padded.resize((W + 2 * Rx) * D);
+				impl::padRow(_Src.row(_Y), W, D, Rx, _Border, Padded.data());
+				std::fill(_Out, _Out + RowSize, r32(0));
+
+				for(auto k = u64(0); k < _KernelX.size(); ++k)
+				{
+					const auto Wk = _KernelX.Taps[k];
+					const auto In = Padded.data() + k * D;
+					if(Wk != 0) for(auto i = u64(0); i < RowSize; ++i) _Out[i] += Wk * In[i];
+				}
+			},
+			[&]( const r32* const* _Rows, const u64 _Y )
+			{
+				thread_local auto Acc = std::vector<r32>();
+				Acc.assign(RowSize, r32(0));
+
+				for(auto k = u64(0); k < _KernelY.size(); ++k)
+				{
+					const auto Wk = _KernelY.Taps[k];
+					const auto In = _Rows[k];
+					if(Wk != 0) for(auto i = u64(0); i < RowSize; ++i) Acc[i] += Wk * In[i];
+				}
+
+				auto Out = _Dst.row(_Y);
+				if constexpr(std::is_same_v<O, r32>) std::copy(Acc.begin(), Acc.end(), Out);
+				else for(auto i = u64(0); i < RowSize; ++i) Out[i] = saturate<O>(Acc[i]);
+			});
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Separable convolution into new image of type O (same type as source by default).
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class O = void, class T> auto convolve ( const Image<T>& _Src, const Kernel& _KernelX, const Kernel& _KernelY, const Border _Border = Border::CLAMP )
+	{
+		using Out = std::conditional_t<std::is_void_v<O>, T, O>;
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "convolve"s, ERR_EMPTY, "Image is empty."s);
+
+		auto NewImage = Image<Out>(_Src.width(), _Src.height(), _Src.depth());
+		convolve<T, Out>(_Src.view(), NewImage.view(), _KernelX, _KernelY, _Border);
+
+		return NewImage;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Gaussian blur. Zero radius picks ceil(3 * sigma).
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto gaussianBlur ( const Image<T>& _Src, const r64 _Sigma, const u64 _Radius = 0, const Border _Border = Border::CLAMP ) -> Image<T>
+	{
+		const auto K = kernelGaussian(_Sigma, _Radius);
+		return convolve(_Src, K, K, _Border);
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Integral image.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Default summed area table accumulator. u8 and u16 use u32: table may wrap on huge images, but box sums are differences, so they stay exact while box itself sums below 2^32.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> using IntegralAcc = std::conditional_t<std::is_floating_point_v<T>, r64, std::conditional_t<(sizeof(T) <= 2) && std::is_unsigned_v<T>, u32, std::conditional_t<std::is_signed_v<T>, i64, u64>>>;
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Summed area table of (width + 1) x (height + 1), per channel. First row and column are zero, so I(x, y) is sum of all pixels above and left of (x, y).
+	// Rows are prefix scanned in parallel, then columns are accumulated down in parallel blocks of whole vectors.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class A = void, class T> auto integral ( const ImageView<const T>& _Src )
+	{
+		using Acc = std::conditional_t<std::is_void_v<A>, IntegralAcc<std::remove_const_t<T>>, A>;
+		static_assert(std::is_arithmetic_v<Acc>, "fx::img::integral | Type not implemented.");
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "integral"s, ERR_EMPTY, "Image is empty."s);
+
+		const auto W = _Src.width();
+		const auto H = _Src.height();
+		const auto D = _Src.depth();
+		const auto OutRow = (W + 1) * D;
+
+		auto Table = Image<Acc>(W + 1, H + 1, D);
+		std::fill(Table.data(), Table.data() + OutRow, Acc(0));
+
+		thr::parallelFor(0, H, std::max(u64(1), u64(16384) / OutRow), [&]( const u64 _Lo, const u64 _Hi )
+		{
+			for(auto y = _Lo; y < _Hi; ++y)
+			{
+				const auto In = _Src.row(y);
+				auto Out = Table.data() + (y + 1) * OutRow;
+
+				for(auto c = u64(0); c < D; ++c) Out[c] = Acc(0);
+				for(auto i = u64(0); i < W * D; ++i) Out[D + i] = Out[i] + Acc(In[i]);
+			}
+		});
+
+		constexpr auto BLOCK = u64(1024);
+		thr::parallelFor(0, (OutRow + BLOCK - 1) / BLOCK, 1, [&]( const u64 _Lo, const u64 _Hi )
+		{
+			for(auto b = _Lo; b < _Hi; ++b)
+			{
+				const auto I0 = b * BLOCK;
+				const auto I1 = std::min(OutRow, I0 + BLOCK);
+
+				for(auto y = u64(2); y <= H; ++y)
+				{
+					const auto Above = Table.data() + (y - 1) * OutRow;
+					auto Out = Table.data() + y * OutRow;
+					for(auto i = I0; i < I1; ++i) Out[i] += Above[i];
+				}
+			}
+		});
+
+		return Table;
+	}
+
+	template<class A = void, class T> auto integral ( const Image<T>& _Src ) { return integral<A>(_Src.view()); }
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Sum of channel _Channel over pixels [_X0, _X1) x [_Y0, _Y1), read from summed area table.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class A> inline auto boxSum ( const Image<A>& _Table, const u64 _X0, const u64 _Y0, const u64 _X1, const u64 _Y1, const u64 _Channel = 0 ) -> A
+	{
+		const auto W = _Table.width();
+		const auto D = _Table.depth();
+		const auto T = _Table.data();
+
+		return A(A(T[(_Y1 * W + _X1) * D + _Channel] - T[(_Y0 * W + _X1) * D + _Channel]) - A(T[(_Y1 * W + _X0) * D + _Channel] - T[(_Y0 * W + _X0) * D + _Channel]));
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Constant time blur.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Box blur of (2 * _RadiusX + 1) x (2 * _RadiusY + 1) with running sums. Cost per pixel does not depend on radius.
+	// Horizontal pass slides window along each row, vertical pass slides it down blocks of columns. Both run in parallel.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto boxBlur ( const ImageView<const mgx::identity_t<T>>& _Src, const ImageView<T>& _Dst, const u64 _RadiusX, const u64 _RadiusY, const Border _Border = Border::CLAMP ) -> void
+	{
+		static_assert(std::is_arithmetic_v<T>, "fx::img::boxBlur | Type not implemented.");
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "boxBlur"s, ERR_EMPTY, "Image is empty."s);
+		if((_Src.width() != _Dst.width()) || (_Src.height() != _Dst.height()) || (_Src.depth() != _Dst.depth())) throw Error("fx::img"s, ""s, "boxBlur"s, ERR_INCONSISTENT_DIM, "Inconsistent dimensions."s);
+
+		// Floats sum in r64, so adding and removing samples does not drift along long rows.
+		using Acc = std::conditional_t<std::is_floating_point_v<T>, r64, std::conditional_t<(sizeof(T) <= 2) && std::is_unsigned_v<T>, u32, std::conditional_t<std::is_signed_v<T>, i64, u64>>>;
+
+		const auto W = _Src.width();
+		const auto H = _Src.height();
+		const auto D = _Src.depth();
+		const auto RowSize = W * D;
+		const auto Scale = 1.0 / r64((2 * _RadiusX + 1) * (2 * _RadiusY + 1));
+
+		auto Rows = std::vector<Acc>(H * RowSize);
+
+		thr::parallelFor(0, H, std::max(u64(1), u64(16384) / RowSize), [&]( const u64 _Lo, const u64 _Hi )
+		{
+			auto Padded = std::vector<Acc>((W + 2 * _RadiusX) * D);
+
+			for(auto y = _Lo; y < _Hi; ++y)
+			{
+				impl::padRow(_Src.row(y), W, D, _RadiusX, _Border, Padded.data());
+				auto Out = Rows.data() + y * RowSize;
+
+				for(auto c = u64(0); c < D; ++c)
+				{
+					auto Sum = Acc(0);
+					for(auto k = u64(0); k <= 2 * _RadiusX; ++k) Sum += Padded[k * D + c];
+					Out[c] = Sum;
+				}
+
+				const auto Add = Padded.data() + (2 * _RadiusX + 1) * D;
+				const auto Sub = Padded.data();
+				for(auto i = D; i < RowSize; ++i) Out[i] = Out[i - D] + Add[i - D] - Sub[i - D];
+			}
+		});
+
+		constexpr auto BLOCK = u64(1024);
+		thr::parallelFor(0, (RowSize + BLOCK - 1) / BLOCK, 1, [&]( const u64 _Lo, const u64 _Hi )
+		{
+			auto Sum = std::vector<Acc>(BLOCK);
+			const auto Row = [&]( const i64 _Y ){ return Rows.data() + u64(borderIndex(_Y, i64(H), _Border)) * RowSize; };
+
+			for(auto b = _Lo; b < _Hi; ++b)
+			{
+				const auto I0 = b * BLOCK;
+				const auto N = std::min(RowSize, I0 + BLOCK) - I0;
+				std::fill(Sum.begin(), Sum.end(), Acc(0));
+
+				for(auto k = -i64(_RadiusY); k <= i64(_RadiusY); ++k)
+				{
+					const auto In = Row(k) + I0;
+					for(auto i = u64(0); i < N; ++i) Sum[i] += In[i];
+				}
+
+				for(auto y = u64(0); y < H; ++y)
+				{
+					auto Out = _Dst.row(y) + I0;
+					if constexpr(std::is_floating_point_v<T>) for(auto i = u64(0); i < N; ++i) Out[i] = T(r64(Sum[i]) * Scale);
+					else for(auto i = u64(0); i < N; ++i) Out[i] = T(r64(Sum[i]) * Scale + 0.5);
+
+					if(y + 1 == H) break;
+					const auto Add = Row(i64(y + _RadiusY + 1)) + I0;
+					const auto Sub = Row(i64(y) - i64(_RadiusY)) + I0;
+					for(auto i = u64(0); i < N; ++i) Sum[i] = Sum[i] + Add[i] - Sub[i];
+				}
+			}
+		});
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Box blur into new image.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto boxBlur ( const Image<T>& _Src, const u64 _RadiusX, const u64 _RadiusY, const Border _Border = Border::CLAMP ) -> Image<T>
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "boxBlur"s, ERR_EMPTY, "Image is empty."s);
+
+		auto NewImage = Image<T>(_Src.width(), _Src.height(), _Src.depth());
+		boxBlur<T>(_Src.view(), NewImage.view(), _RadiusX, _RadiusY, _Border);
+
+		return NewImage;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Box radii whose repeated passes approximate Gaussian of _Sigma (W. Jarosz / P. Kovesi). Widths are odd and differ by at most two.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto boxRadiiForGaussian ( const r64 _Sigma, const u64 _Passes ) -> std::vector<u64>
+	{
+		if((_Sigma <= 0) || (_Passes == 0)) throw Error("fx::img"s, ""s, "boxRadiiForGaussian"s, ERR_BAD_ARGS, "Sigma and passes must be positive."s);
+
+		const auto N = r64(_Passes);
+		auto Lower = i64(std::floor(std::sqrt(12.0 * _Sigma * _Sigma / N + 1.0)));
+		if(math::isEven(Lower)) --Lower;
+		Lower = std::max(i64(1), Lower);
+
+		const auto L = r64(Lower);
+		const auto M = i64(std::llround((12.0 * _Sigma * _Sigma - N * L * L - 4.0 * N * L - 3.0 * N) / (-4.0 * L - 4.0)));
+
+		auto Radii = std::vector<u64>(_Passes);
+		for(auto i = u64(0); i < _Passes; ++i) Radii[i] = u64(((i64(i) < M) ? Lower : Lower + 2) - 1) / 2;
+		return Radii;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Approximate Gaussian blur from repeated box passes. Cost per pixel does not depend on sigma. Three passes stay within few percent of true Gaussian.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto gaussianBlurApprox ( const Image<T>& _Src, const r64 _Sigma, const u64 _Passes = 3, const Border _Border = Border::CLAMP ) -> Image<T>
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "gaussianBlurApprox"s, ERR_EMPTY, "Image is empty."s);
+
+		auto Front = Image<T>(_Src);
+		auto Back = Image<T>(_Src.width(), _Src.height(), _Src.depth());
+
+		for(auto Radius : boxRadiiForGaussian(_Sigma, _Passes))
+		{
+			boxBlur<T>(Front.view(), Back.view(), Radius, Radius, _Border);
+			std::swap(Front, Back);
+		}
+
+		return Front;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Median filter internals.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img::impl
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Columns handled by one thread. Column histograms of strip plus its halo stay in L2.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr auto MEDIAN_STRIP = u64(256);
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Largest radius whose window count fits u16 histogram bins.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr auto MEDIAN_MAX_RADIUS = u64(127);
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Two level histogram: 16 coarse bins of 16 fine bins each.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	struct MedianHist
+	{
+		u16 Coarse[16];
+		u16 Fine[256];
+	};
+
+	inline auto addHist ( u16* _Dst, const u16* _Add, const u16* _Sub, const u64 _Count ) -> void
+	{
+		for(auto i = u64(0); i < _Count; ++i) _Dst[i] = u16(_Dst[i] + _Add[i] - _Sub[i]);
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Median filter.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Median of (2 * _Radius + 1)^2 window, constant time per pixel (S. Perreault, P. Hebert). Every column keeps histogram of its 2 * _Radius + 1 rows, slid down one row
+	// at a time, and kernel histogram slides right by adding one column histogram and subtracting another. Coarse bins are updated every pixel, fine bins lazily,
+	// only for coarse bin holding median. Strips of columns run in parallel.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto median ( const ImageView<const u8>& _Src, const ImageView<u8>& _Dst, const u64 _Radius, const Border _Border = Border::CLAMP ) -> void
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "median"s, ERR_EMPTY, "Image is empty."s);
+		if((_Src.width() != _Dst.width()) || (_Src.height() != _Dst.height()) || (_Src.depth() != _Dst.depth())) throw Error("fx::img"s, ""s, "median"s, ERR_INCONSISTENT_DIM, "Inconsistent dimensions."s);
+		if(_Radius > impl::MEDIAN_MAX_RADIUS) throw Error("fx::img"s, ""s, "median"s, ERR_BAD_ARGS, "Radius is too large."s);
+
+		const auto W = _Src.width();
+		const auto H = _Src.height();
+		const auto D = _Src.depth();
+
+		if(_Radius == 0)
+		{
+			for(auto y = u64(0); y < H; ++y) std::copy(_Src.row(y), _Src.row(y) + W * D, _Dst.row(y));
+			return;
+		}
+
+		const auto R = i64(_Radius);
+		const auto Size = 2 * _Radius + 1;
+		const auto Rank = u32(Size * Size / 2);
+		const auto Strips = (W + impl::MEDIAN_STRIP - 1) / impl::MEDIAN_STRIP;
+
+		thr::parallelFor(0, Strips, 1, [&]( const u64 _Lo, const u64 _Hi )
+		{
+			auto Columns = std::vector<impl::MedianHist>((impl::MEDIAN_STRIP + 2 * _Radius) * D);
+			auto SrcX = std::vector<u64>(impl::MEDIAN_STRIP + 2 * _Radius);
+
+			for(auto S = _Lo; S < _Hi; ++S)
+			{
+				const auto X0 = S * impl::MEDIAN_STRIP;
+				const auto Ws = std::min(W, X0 + impl::MEDIAN_STRIP) - X0;
+				const auto Qs = Ws + 2 * _Radius;
+
+				// Padded column q reads image column X0 - R + q.
+				for(auto q = u64(0); q < Qs; ++q) SrcX[q] = u64(borderIndex(i64(X0 + q) - R, i64(W), _Border)) * D;
+
+				const auto AddRow = [&]( const i64 _Y, const i32 _Sign )
+				{
+					const auto Row = _Src.row(u64(borderIndex(_Y, i64(H), _Border)));
+					for(auto q = u64(0); q < Qs; ++q)
+					{
+						for(auto c = u64(0); c < D; ++c)
+						{
+							const auto Val = Row[SrcX[q] + c];
+							auto& Col = Columns[q * D + c];
+							Col.Coarse[Val >> 4] = u16(Col.Coarse[Val >> 4] + _Sign);
+							Col.Fine[Val] = u16(Col.Fine[Val] + _Sign);
+						}
+					}
+				};
+
+				std::fill(Columns.begin(), Columns.end(), impl::MedianHist{});
+				for(auto k = -R; k <= R; ++k) AddRow(k, 1);
+
+				for(auto y = u64(0); y < H; ++y)
+				{
+					if(y > 0)
+					{
+						AddRow(i64(y) - R - 1, -1);
+						AddRow(i64(y) + R, 1);
+					}
+
+					auto Out = _Dst.row(y) + X0 * D;
+
+					for(auto c = u64(0); c < D; ++c)
+					{
+						const auto Col = [&]( const u64 _Q ) -> const impl::MedianHist& { return Columns[_Q * D + c]; };
+						auto Kernel = impl::MedianHist{};
+						i64 Fresh[16];
+						for(auto k = 0; k < 16; ++k) Fresh[k] = std::numeric_limits<i64>::min() / 2;
+
+						for(auto q = u64(0); q < Size; ++q) for(auto k = 0; k < 16; ++k) Kernel.Coarse[k] = u16(Kernel.Coarse[k] + Col(q).Coarse[k]);
+
+						for(auto x = u64(0); x < Ws; ++x)
+						{
+							if(x > 0) impl::addHist(Kernel.Coarse, Col(x + 2 * _Radius).Coarse, Col(x - 1).Coarse, 16);
+
+							auto Seen = u32(0);
+							auto K = 0;
+							while(Seen + Kernel.Coarse[K] <= Rank) Seen += Kernel.Coarse[K++];
+
+							// Bring fine bins of coarse bin K up to column x: replay column steps if few were missed, rebuild otherwise.
+							auto Fine = Kernel.Fine + K * 16;
+							if(i64(x) - Fresh[K] > i64(Size))
+							{
+								std::fill(Fine, Fine + 16, u16(0));
+								for(auto q = x; q < x + Size; ++q) for(auto i = 0; i < 16; ++i) Fine[i] = u16(Fine[i] + Col(q).Fine[K * 16 + i]);
+							}
+							else for(auto s = u64(Fresh[K] + 1); s <= x; ++s) impl::addHist(Fine, Col(s + 2 * _Radius).Fine + K * 16, Col(s - 1).Fine + K * 16, 16);
+							Fresh[K] = i64(x);
+
+							auto Bin = 0;
+							while(Seen + Fine[Bin] <= Rank) Seen += Fine[Bin++];
+							Out[x * D + c] = u8(K * 16 + Bin);
+						}
+					}
+				}
+			}
+		});
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Median filter into new image.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto median ( const Image<u8>& _Src, const u64 _Radius, const Border _Border = Border::CLAMP ) -> Image<u8>
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "median"s, ERR_EMPTY, "Image is empty."s);
+
+		auto NewImage = Image<u8>(_Src.width(), _Src.height(), _Src.depth());
+		median(_Src.view(), NewImage.view(), _Radius, _Border);
+
+		return NewImage;
+	}
+}
@@ -0,0 +1,563 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include "./Error.hpp"
+#include "./Image.hpp"
+#include "./ImageStream.hpp"
+#include <array>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Animated GIF decoding internals.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img::impl
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Byte source over memory block or file. File is read through fixed buffer, so memory use does not depend on file size.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	class GifSource
+	{
+		static constexpr auto BUFFER_SIZE = u64(65536);
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		const u8* Ptr;
+		const u8* End;
+		std::ifstream File;
+		std::vector<u8> Buffer;
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		GifSource ( const u8* _Data, const u64 _Size ) : Ptr(_Data), End(_Data + _Size), File(), Buffer() {}
+
+		GifSource ( const str& _Filename ) : Ptr(nullptr), End(nullptr), File(_Filename, std::ios::binary), Buffer(BUFFER_SIZE)
+		{
+			if(!this->File.is_open()) throw Error("fx::img"s, "GifSource"s, "GifSource"s, ERR_FAILED_TO_OPEN, "Failed to open file: "s + _Filename);
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// True once every byte was consumed.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto isDone ( void ) -> bool { return (this->Ptr == this->End) && !this->refill(); }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Next byte or throw.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		inline auto get8 ( void ) -> u32
+		{
+			if((this->Ptr == this->End) && !this->refill()) throw Error("fx::img"s, "GifSource"s, "get8"s, ERR_LOAD_FAILED, "Unexpected end of file."s);
+			return *this->Ptr++;
+		}
+
+		inline auto get16 ( void ) -> u32 { const auto Lo = this->get8(); return Lo | (this->get8() << 8); }
+
+		auto read ( u8* _Dst, u64 _Size ) -> void
+		{
+			while(_Size > 0)
+			{
+				if((this->Ptr == this->End) && !this->refill()) throw Error("fx::img"s, "GifSource"s, "read"s, ERR_LOAD_FAILED, "Unexpected end of file."s);
+				const auto Count = std::min(_Size, u64(this->End - this->Ptr));
+				std::memcpy(_Dst, this->Ptr, Count);
+				this->Ptr += Count;
+				_Dst += Count;
+				_Size -= Count;
+			}
+		}
+
+		auto skip ( u64 _Size ) -> void
+		{
+			while(_Size > 0)
+			{
+				if((this->Ptr == this->End) && !this->refill()) throw Error("fx::img"s, "GifSource"s, "skip"s, ERR_LOAD_FAILED, "Unexpected end of file."s);
+				const auto Count = std::min(_Size, u64(this->End - this->Ptr));
+				this->Ptr += Count;
+				_Size -= Count;
+			}
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Skip data sub-blocks up to and including terminator.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto skipBlocks ( void ) -> void
+		{
+			for(auto Size = this->get8(); Size != 0; Size = this->get8()) this->skip(Size);
+		}
+
+		private:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Load next part of file. Memory sources have nothing more.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto refill ( void ) -> bool
+		{
+			if(!this->File.is_open()) return false;
+
+			this->File.read(reinterpret_cast<char*>(this->Buffer.data()), std::streamsize(this->Buffer.size()));
+			const auto Count = u64(this->File.gcount());
+			this->Ptr = this->Buffer.data();
+			this->End = this->Ptr + Count;
+			return Count > 0;
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// GIF decoder. Frames are composed on RGBA canvas of logical screen size, honouring transparency, interlacing and all disposal methods.
+	// Canvas starts transparent, disposal to background clears to transparent, as browsers do.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	class GifDecoder
+	{
+		static constexpr auto MAX_CODES = u32(4096);
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		GifSource Source;
+		std::array<u8, 256 * 3> GlobalPalette;
+		std::array<u8, 256 * 3> LocalPalette;
+		std::vector<u8> Canvas;
+		std::vector<u8> Previous;
+		std::vector<u8> Indices;
+		std::array<u16, MAX_CODES> Prefix;
+		std::array<u8, MAX_CODES> Suffix;
+		std::array<u8, MAX_CODES> First;
+		std::array<u16, MAX_CODES> Length;
+
+		// Disposal of last emitted frame, applied before next one is drawn.
+		u32 PendingDispose;
+		u64 RectX, RectY, RectW, RectH;
+
+		// Graphic control extension, applies to next image only.
+		u32 Dispose;
+		u32 Delay;
+		i32 Transparent;
+		bool Finished;
+		public:
+
+		u64 Width;
+		u64 Height;
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors. Read header and global colour table.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		GifDecoder ( const u8* _Data, const u64 _Size ) : GifDecoder(GifSource(_Data, _Size)) {}
+		explicit GifDecoder ( const str& _Filename ) : GifDecoder(GifSource(_Filename)) {}
+
+		explicit GifDecoder ( GifSource&& _Source ) :
+			Source(std::move(_Source)), GlobalPalette(), LocalPalette(), PendingDispose(0), RectX(0), RectY(0), RectW(0), RectH(0), Dispose(0), Delay(0), Transparent(-1), Finished(false), Width(0), Height(0)
+		{
+			auto Signature = std::array<u8, 6>();
+			this->Source.read(Signature.data(), Signature.size());
+			if((std::memcmp(Signature.data(), "GIF87a", 6) != 0) && (std::memcmp(Signature.data(), "GIF89a", 6) != 0)) throw Error("fx::img"s, "GifDecoder"s, "GifDecoder"s, ERR_UNKNOWN_FORMAT, "Not a GIF file."s);
+
+			this->Width = this->Source.get16();
+			this->Height = this->Source.get16();
+			const auto Flags = this->Source.get8();
+			this->Source.skip(2);
+			if((this->Width == 0) || (this->Height == 0)) throw Error("fx::img"s, "GifDecoder"s, "GifDecoder"s, ERR_LOAD_FAILED, "Logical screen is empty."s);
+
+			if(Flags & 0x80) this->Source.read(this->GlobalPalette.data(), (u64(2) << (Flags & 7)) * 3);
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Compose next frame into _Dst, Width x Height x 4. Returns false after last frame.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto next ( u8* _Dst, u32& _Delay ) -> bool
+		{
+			if(this->Canvas.empty()) this->Canvas.assign(this->Width * this->Height * 4, 0);
+
+			if(!this->nextImage(true, _Delay)) return false;
+			std::memcpy(_Dst, this->Canvas.data(), this->Canvas.size());
+			return true;
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Move past next frame without decoding it. Returns false after last frame.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto skip ( void ) -> bool { auto Delay = u32(0); return this->nextImage(false, Delay); }
+
+		private:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Walk blocks up to next image descriptor. Stream that ends at block boundary without trailer is accepted as finished.
+		// Graphic control values are handed out through _Delay and reset, so image without extension does not inherit them.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto nextImage ( const bool _Decode, u32& _Delay ) -> bool
+		{
+			while(!this->Finished)
+			{
+				if(this->Source.isDone()) { this->Finished = true; break; }
+				const auto Tag = this->Source.get8();
+
+				if(Tag == 0x3B) { this->Finished = true; break; }
+
+				if(Tag == 0x21)
+				{
+					const auto Label = this->Source.get8();
+					if(Label == 0xF9)
+					{
+						const auto Size = this->Source.get8();
+						if(Size < 4) throw Error("fx::img"s, "GifDecoder"s, "nextImage"s, ERR_LOAD_FAILED, "Corrupt graphic control extension."s);
+
+						const auto Packed = this->Source.get8();
+						this->Dispose = (Packed >> 2) & 7;
+						this->Delay = this->Source.get16() * 10;
+						const auto Index = this->Source.get8();
+						this->Transparent = (Packed & 1) ? i32(Index) : -1;
+						this->Source.skip(Size - 4);
+					}
+					this->Source.skipBlocks();
+					continue;
+				}
+
+				if(Tag != 0x2C) throw Error("fx::img"s, "GifDecoder"s, "nextImage"s, ERR_LOAD_FAILED, "Corrupt block."s);
+
+				const auto X = u64(this->Source.get16());
+				const auto Y = u64(this->Source.get16());
+				const auto W = u64(this->Source.get16());
+				const auto H = u64(this->Source.get16());
+				const auto Flags = this->Source.get8();
+
+				// Frames must lie inside logical screen, so size of index buffer is bounded by header.
+				if((X + W > this->Width) || (Y + H > this->Height)) throw Error("fx::img"s, "GifDecoder"s, "nextImage"s, ERR_LOAD_FAILED, "Frame exceeds logical screen."s);
+
+				auto Palette = this->GlobalPalette.data();
+				if(Flags & 0x80)
+				{
+					this->LocalPalette.fill(0);
+					this->Source.read(this->LocalPalette.data(), (u64(2) << (Flags & 7)) * 3);
+					Palette = this->LocalPalette.data();
+				}
+
+				if(_Decode)
+				{
+					this->dispose();
+					this->decode(W * H);
+					this->draw(X, Y, W, H, (Flags & 0x40) != 0, Palette);
+				}
+
+				else
+				{
+					this->Source.skip(1);
+					this->Source.skipBlocks();
+				}
+
+				_Delay = this->Delay;
+				this->Dispose = 0;
+				this->Delay = 0;
+				this->Transparent = -1;
+				return true;
+			}
+
+			return false;
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Undo last frame as its disposal method asks.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto dispose ( void ) -> void
+		{
+			if((this->PendingDispose == 2) || (this->PendingDispose == 3))
+			{
+				for(auto y = this->RectY; y < this->RectY + this->RectH; ++y)
+				{
+					const auto Offset = (y * this->Width + this->RectX) * 4;
+					if(this->PendingDispose == 2) std::memset(this->Canvas.data() + Offset, 0, this->RectW * 4);
+					else std::memcpy(this->Canvas.data() + Offset, this->Previous.data() + Offset, this->RectW * 4);
+				}
+			}
+
+			this->PendingDispose = 0;
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Draw decoded indices into canvas.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto draw ( const u64 _X, const u64 _Y, const u64 _W, const u64 _H, const bool _Interlaced, const u8* _Palette ) -> void
+		{
+			this->RectX = _X;
+			this->RectY = _Y;
+			this->RectW = _W;
+			this->RectH = _H;
+
+			if(this->Dispose == 3) this->Previous = this->Canvas;
+			this->PendingDispose = this->Dispose;
+
+			// Interlaced rows come in four passes: every 8th from 0, every 8th from 4, every 4th from 2, every 2nd from 1.
+			auto Rows = std::vector<u64>();
+			Rows.reserve(_H);
+			if(_Interlaced) for(const auto& Pass : { std::array<u64, 2>{ 0, 8 }, std::array<u64, 2>{ 4, 8 }, std::array<u64, 2>{ 2, 4 }, std::array<u64, 2>{ 1, 2 } }) for(auto y = Pass[0]; y < _H; y += Pass[1]) Rows.push_back(y);
+			else for(auto y = u64(0); y < _H; ++y) Rows.push_back(y);
+
+			for(auto r = u64(0); r < _H; ++r)
+			{
+				const auto y = Rows[r];
+				const auto Src = this->Indices.data() + r * _W;
+				auto Dst = this->Canvas.data() + ((this->RectY + y) * this->Width + this->RectX) * 4;
+
+				for(auto x = u64(0); x < this->RectW; ++x)
+				{
+					const auto Index = Src[x];
+					if(i32(Index) == this->Transparent) continue;
+
+					Dst[x * 4 + 0] = _Palette[Index * 3 + 0];
+					Dst[x * 4 + 1] = _Palette[Index * 3 + 1];
+					Dst[x * 4 + 2] = _Palette[Index * 3 + 2];
+					Dst[x * 4 + 3] = 255;
+				}
+			}
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// LZW decode _Count indices from image data sub-blocks. Short data leaves remaining indices at zero, surplus data is skipped.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto decode ( const u64 _Count ) -> void
+		{
+			this->Indices.assign(_Count, 0);
+
+			const auto MinSize = this->Source.get8();
+			if((MinSize < 1) || (MinSize > 11)) throw Error("fx::img"s, "GifDecoder"s, "decode"s, ERR_LOAD_FAILED, "Corrupt LZW code size."s);
+
+			const auto Clear = u32(1) << MinSize;
+			const auto EndCode = Clear + 1;
+			for(auto c = u32(0); c < Clear; ++c) { this->Suffix[c] = u8(c); this->First[c] = u8(c); this->Length[c] = 1; }
+
+			auto Next = Clear + 2;
+			auto Size = MinSize + 1;
+			auto Prev = i32(-1);
+			auto Bits = u32(0);
+			auto BitCount = u32(0);
+			auto BlockLeft = u32(0);
+			auto Ended = false;
+			auto Out = u64(0);
+			auto Dst = this->Indices.data();
+
+			while(Out < _Count)
+			{
+				while(!Ended && (BitCount < Size))
+				{
+					if(BlockLeft == 0)
+					{
+						BlockLeft = this->Source.get8();
+						if(BlockLeft == 0) { Ended = true; break; }
+					}
+
+					Bits |= this->Source.get8() << BitCount;
+					BitCount += 8;
+					--BlockLeft;
+				}
+
+				if(BitCount < Size) break;
+
+				const auto Code = Bits & ((u32(1) << Size) - 1);
+				Bits >>= Size;
+				BitCount -= Size;
+
+				if(Code == Clear) { Next = Clear + 2; Size = MinSize + 1; Prev = -1; continue; }
+				if(Code == EndCode) break;
+
+				if(Prev < 0)
+				{
+					if(Code >= Clear) throw Error("fx::img"s, "GifDecoder"s, "decode"s, ERR_LOAD_FAILED, "Corrupt LZW stream."s);
+					Dst[Out++] = u8(Code);
+					Prev = i32(Code);
+					continue;
+				}
+
+				if(Code > Next) throw Error("fx::img"s, "GifDecoder"s, "decode"s, ERR_LOAD_FAILED, "Corrupt LZW stream."s);
+
+				if(Next < MAX_CODES)
+				{
+					this->Prefix[Next] = u16(Prev);
+					this->Suffix[Next] = (Code < Next) ? this->First[Code] : this->First[Prev];
+					this->First[Next] = this->First[Prev];
+					this->Length[Next] = u16(this->Length[Prev] + 1);
+					++Next;
+					if((Next == (u32(1) << Size)) && (Size < 12)) ++Size;
+				}
+
+				// Entries are chains of prefixes, so string is written back to front.
+				const auto Len = u64(this->Length[Code]);
+				const auto Emit = std::min(Len, _Count - Out);
+				auto C = Code;
+				for(auto i = Len; i > 0; --i)
+				{
+					if(i <= Emit) Dst[Out + i - 1] = this->Suffix[C];
+					C = this->Prefix[C];
+				}
+
+				Out += Emit;
+				Prev = i32(Code);
+			}
+
+			if(!Ended)
+			{
+				this->Source.skip(BlockLeft);
+				this->Source.skipBlocks();
+			}
+		}
+	};
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Animated images.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Frame sequence. All frames live in one contiguous allocation, frame(i) gives view into it. Delays are in milliseconds.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	class Frames
+	{
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		std::vector<u8> Data;
+		std::vector<u32> Delays;
+		u64 Width;
+		u64 Height;
+		u64 Depth;
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		Frames ( void ) : Data(), Delays(), Width(0), Height(0), Depth(0) {}
+		Frames ( const u64 _Width, const u64 _Height, const u64 _Depth, const u64 _Count ) : Data(_Width * _Height * _Depth * _Count), Delays(_Count, 0), Width(_Width), Height(_Height), Depth(_Depth) {}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Trivial.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		inline auto width ( void ) const -> u64 { return this->Width; }
+		inline auto height ( void ) const -> u64 { return this->Height; }
+		inline auto depth ( void ) const -> u64 { return this->Depth; }
+		inline auto count ( void ) const -> u64 { return this->Delays.size(); }
+		inline auto isEmpty ( void ) const -> bool { return this->Delays.empty(); }
+		inline auto data ( void ) -> u8* { return this->Data.data(); }
+		inline auto data ( void ) const -> const u8* { return this->Data.data(); }
+		inline auto delay ( const u64 _Index ) const -> u32 { return this->Delays[_Index]; }
+		inline auto delay ( const u64 _Index ) -> u32& { return this->Delays[_Index]; }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// View of single frame.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto frame ( const u64 _Index ) -> ImageView<u8>
+		{
+			if(_Index >= this->count()) throw Error("fx::img"s, "Frames"s, "frame"s, ERR_BAD_ARGS, "Frame index out of range."s);
+			return ImageView<u8>(this->Data.data() + _Index * this->Width * this->Height * this->Depth, this->Width, this->Height, this->Depth);
+		}
+
+		auto frame ( const u64 _Index ) const -> ImageView<const u8>
+		{
+			if(_Index >= this->count()) throw Error("fx::img"s, "Frames"s, "frame"s, ERR_BAD_ARGS, "Frame index out of range."s);
+			return ImageView<const u8>(this->Data.data() + _Index * this->Width * this->Height * this->Depth, this->Width, this->Height, this->Depth);
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Decode every frame of GIF held in memory. Cheap pass over block structure counts frames, so storage is allocated once before decoding. Frames are RGBA.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto loadFrames ( const u8* _Data, const u64 _Size ) -> Frames
+	{
+		auto Count = u64(0);
+		auto Scanner = impl::GifDecoder(_Data, _Size);
+		while(Scanner.skip()) ++Count;
+		if(Count == 0) throw Error("fx::img"s, ""s, "loadFrames"s, ERR_LOAD_FAILED, "GIF has no frames."s);
+
+		auto Result = Frames(Scanner.Width, Scanner.Height, 4, Count);
+		auto Decoder = impl::GifDecoder(_Data, _Size);
+		for(auto i = u64(0); i < Count; ++i) Decoder.next(Result.frame(i).data(), Result.delay(i));
+
+		return Result;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Decode every frame of GIF file. File is read whole, then decoded from memory.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto loadFrames ( const str& _Filename ) -> Frames
+	{
+		const auto Format = peekFormat(_Filename);
+		if(Format == FileFormat::NO_FILE) throw Error("fx::img"s, ""s, "loadFrames"s, ERR_FAILED_TO_OPEN, "Failed to open file: "s + _Filename);
+		if(Format != FileFormat::GIF) throw Error("fx::img"s, ""s, "loadFrames"s, ERR_UNKNOWN_FORMAT, "Not a GIF file: "s + _Filename);
+
+		auto File = std::ifstream(_Filename, std::ios::binary | std::ios::ate);
+		auto Bytes = std::vector<u8>(u64(File.tellg()));
+		File.seekg(0);
+		impl::readExact(File, Bytes.data(), Bytes.size(), "loadFrames");
+
+		return loadFrames(Bytes.data(), Bytes.size());
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Frame by frame GIF reader. Only canvas and current frame are held in memory, file is read as frames are requested.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	class FrameReader
+	{
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		std::unique_ptr<impl::GifDecoder> Decoder;
+		u64 Index;
+		u32 Delay;
+		bool Done;
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors. Only header is read here.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		FrameReader ( const str& _Filename ) : Decoder(), Index(0), Delay(0), Done(false)
+		{
+			const auto Format = peekFormat(_Filename);
+			if(Format == FileFormat::NO_FILE) throw Error("fx::img"s, "FrameReader"s, "FrameReader"s, ERR_FAILED_TO_OPEN, "Failed to open file: "s + _Filename);
+			if(Format != FileFormat::GIF) throw Error("fx::img"s, "FrameReader"s, "FrameReader"s, ERR_UNKNOWN_FORMAT, "Not a GIF file: "s + _Filename);
+
+			this->Decoder = std::make_unique<impl::GifDecoder>(_Filename);
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Trivial.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		inline auto width ( void ) const -> u64 { return this->Decoder->Width; }
+		inline auto height ( void ) const -> u64 { return this->Decoder->Height; }
+		inline auto depth ( void ) const -> u64 { return 4; }
+		inline auto index ( void ) const -> u64 { return this->Index; }
+		inline auto delay ( void ) const -> u32 { return this->Delay; }
+		inline auto isDone ( void ) const -> bool { return this->Done; }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Read next frame into _Frame. Frame storage is reused between calls. Returns false once animation is exhausted.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto read ( Image<u8>& _Frame ) -> bool
+		{
+			if(this->Done) return false;
+
+			_Frame.reset(this->width(), this->height(), 4);
+			if(!this->Decoder->next(_Frame.data(), this->Delay)) { this->Done = true; return false; }
+
+			++this->Index;
+			return true;
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Call _Fn(Frame, Index, Delay) for every remaining frame.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		template<class F> auto forEach ( F&& _Fn ) -> void
+		{
+			auto Frame = Image<u8>();
+			while(this->read(Frame)) _Fn(static_cast<const Image<u8>&>(Frame), this->Index - 1, this->Delay);
+		}
+	};
+}
@@ -0,0 +1,649 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include "./Error.hpp"
+#include "./Image.hpp"
+#include "./Threads.hpp"
+#include "./magic.hpp"
+#include "./ImageFilter.hpp"
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <type_traits>
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#endif
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Orientation internals.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img::impl
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Transposing ops work on square tiles of pixels. Tile edge spans at least one 64 byte cache line of pixels, so every line fetched is used whole;
+	// source and destination tile together stay within L1.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr auto ORIENT_TILE = u64(16);
+
+	inline auto orientTile ( const u64 _PixelBytes ) -> u64
+	{
+		return std::clamp(u64(64) / std::max(u64(1), _PixelBytes), ORIENT_TILE, u64(64));
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Copy one pixel. Fixed depth copies whole pixel as one block, which compiles to single load and store for 1, 2, 4, 8 and 16 byte pixels.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<u64 FIXED, class T> inline auto copyPixel ( T* _Dst, const T* _Src, const u64 _Depth ) -> void
+	{
+		if constexpr(FIXED != 0) std::memcpy(_Dst, _Src, FIXED * sizeof(T));
+		else for(auto c = u64(0); c < _Depth; ++c) _Dst[c] = _Src[c];
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Reverse byte order of 64 bit word. GCC and Clang fold shifts and masks into single bswap, MSVC gets its intrinsic outside constant evaluation.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr inline auto byteSwap64 ( u64 _Val ) -> u64
+	{
+		#if defined(_MSC_VER)
+		if(!std::is_constant_evaluated()) return _byteswap_uint64(_Val);
+		#endif
+
+		_Val = ((_Val & 0x00FF00FF00FF00FFull) << 8) | ((_Val >> 8) & 0x00FF00FF00FF00FFull);
+		_Val = ((_Val & 0x0000FFFF0000FFFFull) << 16) | ((_Val >> 16) & 0x0000FFFF0000FFFFull);
+		return (_Val << 32) | (_Val >> 32);
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Transpose 8x8 block of single byte pixels held as eight 64 bit rows, swapping 1, 2 and 4 byte sub-blocks in three masked stages.
+	// Destination block starts at (_X, _Y). Mirrored source column is loaded byte swapped, so same stages serve all rotations.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> inline auto transposeBlock8 ( const ImageView<const T>& _Src, const ImageView<T>& _Dst, const u64 _X, const u64 _Y, const bool _MirrorX, const bool _MirrorY ) -> void
+	{
+		u64 R[8];
+		const auto Column = _MirrorX ? _Src.width() - 8 - _Y : _Y;
+
+		for(auto k = u64(0); k < 8; ++k)
+		{
+			std::memcpy(&R[k], _Src.row(_MirrorY ? _Src.height() - 1 - (_X + k) : _X + k) + Column, 8);
+			if(_MirrorX) R[k] = byteSwap64(R[k]);
+		}
+
+		const auto Swap = [&]( u64& _A, u64& _B, const u32 _Shift, const u64 _Mask )
+		{
+			const auto T0 = ((_A >> _Shift) ^ _B) & _Mask;
+			_B ^= T0;
+			_A ^= T0 << _Shift;
+		};
+
+		for(auto k = u64(0); k < 8; k += 2) Swap(R[k], R[k + 1], 8, 0x00FF00FF00FF00FFull);
+		for(auto k : { 0, 1, 4, 5 }) Swap(R[k], R[k + 2], 16, 0x0000FFFF0000FFFFull);
+		for(auto k = u64(0); k < 4; ++k) Swap(R[k], R[k + 4], 32, 0x00000000FFFFFFFFull);
+
+		for(auto k = u64(0); k < 8; ++k) std::memcpy(_Dst.row(_Y + k) + _X, &R[k], 8);
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Destination pixel (x, y) takes source pixel (y, x), with x mirrored when _MirrorX and y mirrored when _MirrorY (in source coordinates).
+	// Transpose uses no mirror, clockwise rotation mirrors source y, counter clockwise mirrors source x.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto transposeTiled ( const ImageView<const T>& _Src, const ImageView<T>& _Dst, const bool _MirrorX, const bool _MirrorY ) -> void
+	{
+		const auto SrcW = _Src.width();
+		const auto SrcH = _Src.height();
+		const auto DstW = _Dst.width();
+		const auto DstH = _Dst.height();
+		const auto Tile = orientTile(_Src.depth() * sizeof(T));
+		const auto TilesX = (DstW + Tile - 1) / Tile;
+		const auto TilesY = (DstH + Tile - 1) / Tile;
+		const auto SrcStride = (SrcH > 1) ? i64(_Src.row(1) - _Src.row(0)) : i64(0);
+		const auto Step = _MirrorY ? -SrcStride : SrcStride;
+
+		thr::parallelFor(0, TilesY, 1, [&]( const u64 _Lo, const u64 _Hi )
+		{
+			mgx::withDepth(_Src.depth(), [&]( auto _Depth )
+			{
+				constexpr auto FIXED = decltype(_Depth)::value;
+				const auto Dc = (FIXED == 0) ? _Src.depth() : FIXED;
+
+				for(auto Ty = _Lo; Ty < _Hi; ++Ty)
+				{
+					const auto Y0 = Ty * Tile;
+					const auto Y1 = std::min(DstH, Y0 + Tile);
+
+					for(auto Tx = u64(0); Tx < TilesX; ++Tx)
+					{
+						const auto X0 = Tx * Tile;
+						const auto X1 = std::min(DstW, X0 + Tile);
+						auto Xs = X0;
+
+						// Single byte pixels: full 8x8 blocks transpose in registers, only leftover columns go pixel by pixel.
+						if constexpr((FIXED == 1) && (sizeof(T) == 1))
+						{
+							for(; Xs + 8 <= X1; Xs += 8)
+							{
+								auto y = Y0;
+								for(; y + 8 <= Y1; y += 8) transposeBlock8(_Src, _Dst, Xs, y, _MirrorX, _MirrorY);
+								for(; y < Y1; ++y) for(auto x = Xs; x < Xs + 8; ++x) _Dst.row(y)[x] = _Src.row(_MirrorY ? SrcH - 1 - x : x)[_MirrorX ? SrcW - 1 - y : y];
+							}
+						}
+
+						// Destination rows are written sequentially, source is read down one column per row, all within tile.
+						// Source row of Xs only exists when columns are left, so it is formed inside check.
+						if(Xs < X1)
+						{
+							const auto First = _Src.row(_MirrorY ? SrcH - 1 - Xs : Xs);
+
+							for(auto y = Y0; y < Y1; ++y)
+							{
+								auto In = First + (_MirrorX ? SrcW - 1 - y : y) * Dc;
+								auto Out = _Dst.row(y) + Xs * Dc;
+
+								for(auto x = Xs; x < X1; ++x, In += Step, Out += Dc) copyPixel<FIXED>(Out, In, Dc);
+							}
+						}
+					}
+				}
+			});
+		});
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Copy rows, optionally in reverse row order and / or with pixels of every row reversed.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto flipCopy ( const ImageView<const T>& _Src, const ImageView<T>& _Dst, const bool _Horizontal, const bool _Vertical ) -> void
+	{
+		const auto W = _Src.width();
+		const auto H = _Src.height();
+		const auto RowSize = W * _Src.depth();
+
+		thr::parallelFor(0, H, std::max(u64(1), u64(16384) / RowSize), [&]( const u64 _Lo, const u64 _Hi )
+		{
+			mgx::withDepth(_Src.depth(), [&]( auto _Depth )
+			{
+				constexpr auto FIXED = decltype(_Depth)::value;
+				const auto Dc = (FIXED == 0) ? _Src.depth() : FIXED;
+
+				for(auto y = _Lo; y < _Hi; ++y)
+				{
+					const auto In = _Src.row(_Vertical ? H - 1 - y : y);
+					auto Out = _Dst.row(y);
+
+					if(!_Horizontal) { std::memcpy(Out, In, RowSize * sizeof(T)); continue; }
+					for(auto x = u64(0); x < W; ++x) copyPixel<FIXED>(Out + x * Dc, In + (W - 1 - x) * Dc, Dc);
+				}
+			});
+		});
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Reverse pixels of one row in place.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> inline auto reversePixels ( T* _Row, const u64 _Width, const u64 _Depth ) -> void
+	{
+		for(auto x = u64(0); x < _Width / 2; ++x) std::swap_ranges(_Row + x * _Depth, _Row + (x + 1) * _Depth, _Row + (_Width - 1 - x) * _Depth);
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Orientation.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Swap rows and columns. Works on tiles of pixels, tile rows run in parallel.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto transpose ( const Image<T>& _Src ) -> Image<T>
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "transpose"s, ERR_EMPTY, "Image is empty."s);
+
+		auto NewImage = Image<T>(_Src.height(), _Src.width(), _Src.depth());
+		impl::transposeTiled<T>(_Src.view(), NewImage.view(), false, false);
+		return NewImage;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Rotate by 90 degrees clockwise.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto rotate90 ( const Image<T>& _Src ) -> Image<T>
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "rotate90"s, ERR_EMPTY, "Image is empty."s);
+
+		auto NewImage = Image<T>(_Src.height(), _Src.width(), _Src.depth());
+		impl::transposeTiled<T>(_Src.view(), NewImage.view(), false, true);
+		return NewImage;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Rotate by 180 degrees.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto rotate180 ( const Image<T>& _Src ) -> Image<T>
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "rotate180"s, ERR_EMPTY, "Image is empty."s);
+
+		auto NewImage = Image<T>(_Src.width(), _Src.height(), _Src.depth());
+		impl::flipCopy<T>(_Src.view(), NewImage.view(), true, true);
+		return NewImage;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Rotate by 270 degrees clockwise (90 counter clockwise).
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto rotate270 ( const Image<T>& _Src ) -> Image<T>
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "rotate270"s, ERR_EMPTY, "Image is empty."s);
+
+		auto NewImage = Image<T>(_Src.height(), _Src.width(), _Src.depth());
+		impl::transposeTiled<T>(_Src.view(), NewImage.view(), true, false);
+		return NewImage;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Mirror left to right.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto flipH ( const Image<T>& _Src ) -> Image<T>
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "flipH"s, ERR_EMPTY, "Image is empty."s);
+
+		auto NewImage = Image<T>(_Src.width(), _Src.height(), _Src.depth());
+		impl::flipCopy<T>(_Src.view(), NewImage.view(), true, false);
+		return NewImage;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Mirror top to bottom.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto flipV ( const Image<T>& _Src ) -> Image<T>
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "flipV"s, ERR_EMPTY, "Image is empty."s);
+
+		auto NewImage = Image<T>(_Src.width(), _Src.height(), _Src.depth());
+		impl::flipCopy<T>(_Src.view(), NewImage.view(), false, true);
+		return NewImage;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: In place orientation.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Mirror left to right in place.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto flipHInPlace ( Image<T>& _Image ) -> void
+	{
+		if(_Image.isEmpty()) throw Error("fx::img"s, ""s, "flipHInPlace"s, ERR_EMPTY, "Image is empty."s);
+
+		const auto RowSize = _Image.width() * _Image.depth();
+		thr::parallelFor(0, _Image.height(), std::max(u64(1), u64(16384) / RowSize), [&]( const u64 _Lo, const u64 _Hi )
+		{
+			for(auto y = _Lo; y < _Hi; ++y) impl::reversePixels(_Image.data() + y * RowSize, _Image.width(), _Image.depth());
+		});
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Mirror top to bottom in place.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto flipVInPlace ( Image<T>& _Image ) -> void
+	{
+		if(_Image.isEmpty()) throw Error("fx::img"s, ""s, "flipVInPlace"s, ERR_EMPTY, "Image is empty."s);
+
+		const auto RowSize = _Image.width() * _Image.depth();
+		const auto H = _Image.height();
+		thr::parallelFor(0, H / 2, std::max(u64(1), u64(16384) / RowSize), [&]( const u64 _Lo, const u64 _Hi )
+		{
+			for(auto y = _Lo; y < _Hi; ++y) std::swap_ranges(_Image.data() + y * RowSize, _Image.data() + (y + 1) * RowSize, _Image.data() + (H - 1 - y) * RowSize);
+		});
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Rotate by 180 degrees in place. Row y swaps with row H - 1 - y reversed, middle row of odd height is reversed alone.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto rotate180InPlace ( Image<T>& _Image ) -> void
+	{
+		if(_Image.isEmpty()) throw Error("fx::img"s, ""s, "rotate180InPlace"s, ERR_EMPTY, "Image is empty."s);
+
+		const auto W = _Image.width();
+		const auto H = _Image.height();
+		const auto D = _Image.depth();
+		const auto RowSize = W * D;
+
+		thr::parallelFor(0, (H + 1) / 2, std::max(u64(1), u64(16384) / RowSize), [&]( const u64 _Lo, const u64 _Hi )
+		{
+			for(auto y = _Lo; y < _Hi; ++y)
+			{
+				auto Top = _Image.data() + y * RowSize;
+				auto Bottom = _Image.data() + (H - 1 - y) * RowSize;
+
+				if(Top == Bottom) { impl::reversePixels(Top, W, D); continue; }
+				for(auto x = u64(0); x < W; ++x) std::swap_ranges(Top + x * D, Top + (x + 1) * D, Bottom + (W - 1 - x) * D);
+			}
+		});
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Transpose square image in place. Tiles above diagonal swap with their mirror tiles, diagonal tiles transpose themselves.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto transposeInPlace ( Image<T>& _Image ) -> void
+	{
+		if(_Image.isEmpty()) throw Error("fx::img"s, ""s, "transposeInPlace"s, ERR_EMPTY, "Image is empty."s);
+		if(_Image.width() != _Image.height()) throw Error("fx::img"s, ""s, "transposeInPlace"s, ERR_BAD_ARGS, "In place transpose needs square image."s);
+
+		const auto N = _Image.width();
+		const auto D = _Image.depth();
+		const auto Tile = impl::orientTile(D * sizeof(T));
+		const auto Tiles = (N + Tile - 1) / Tile;
+
+		thr::parallelFor(0, Tiles, 1, [&]( const u64 _Lo, const u64 _Hi )
+		{
+			mgx::withDepth(D, [&]( auto _Depth )
+			{
+				constexpr auto FIXED = decltype(_Depth)::value;
+				const auto Dc = (FIXED == 0) ? D : FIXED;
+				const auto Pixel = [&]( const u64 _X, const u64 _Y ) { return _Image.data() + (_Y * N + _X) * Dc; };
+
+				for(auto Ty = _Lo; Ty < _Hi; ++Ty)
+				{
+					const auto Y0 = Ty * Tile;
+					const auto Y1 = std::min(N, Y0 + Tile);
+
+					for(auto Tx = Ty; Tx < Tiles; ++Tx)
+					{
+						const auto X0 = Tx * Tile;
+						const auto X1 = std::min(N, X0 + Tile);
+
+						for(auto y = Y0; y < Y1; ++y)
+						{
+							for(auto x = std::max(X0, y + 1); x < X1; ++x)
+							{
+								auto A = Pixel(x, y);
+								auto B = Pixel(y, x);
+								for(auto c = u64(0); c < Dc; ++c) std::swap(A[c], B[c]);
+							}
+						}
+					}
+				}
+			});
+		});
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Rotate square image by 90 or 270 degrees clockwise in place.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto rotate90InPlace ( Image<T>& _Image ) -> void
+	{
+		transposeInPlace(_Image);
+		flipHInPlace(_Image);
+	}
+
+	template<class T> auto rotate270InPlace ( Image<T>& _Image ) -> void
+	{
+		transposeInPlace(_Image);
+		flipVInPlace(_Image);
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Warp transforms.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Sampling of source image between pixel centers.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	enum struct OpSample { NEAREST, BILINEAR };
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Affine transform { a, b, c, d, e, f } maps point (x, y) to (a * x + b * y + c, d * x + e * y + f).
+	// Homography { h0 .. h8 } maps (x, y) to ((h0 * x + h1 * y + h2) / w, (h3 * x + h4 * y + h5) / w) with w = h6 * x + h7 * y + h8.
+	// Pixel (x, y) sits at point (x, y).
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	using Affine = std::array<r64, 6>;
+	using Homography = std::array<r64, 9>;
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Rotation by _Angle radians (counter clockwise on screen) and uniform scale about (_Cx, _Cy).
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto affineRotation ( const r64 _Cx, const r64 _Cy, const r64 _Angle, const r64 _Scale = 1.0 ) -> Affine
+	{
+		const auto C = std::cos(_Angle) * _Scale;
+		const auto S = std::sin(_Angle) * _Scale;
+		return Affine{ C, S, _Cx - C * _Cx - S * _Cy, -S, C, _Cy + S * _Cx - C * _Cy };
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Inverse transforms.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto invert ( const Affine& _M ) -> Affine
+	{
+		const auto Det = _M[0] * _M[4] - _M[1] * _M[3];
+		if(Det == 0) throw Error("fx::img"s, ""s, "invert"s, ERR_BAD_ARGS, "Affine transform is singular."s);
+
+		const auto A = _M[4] / Det, B = -_M[1] / Det, D = -_M[3] / Det, E = _M[0] / Det;
+		return Affine{ A, B, -(A * _M[2] + B * _M[5]), D, E, -(D * _M[2] + E * _M[5]) };
+	}
+
+	inline auto invert ( const Homography& _M ) -> Homography
+	{
+		const auto Det = _M[0] * (_M[4] * _M[8] - _M[5] * _M[7]) - _M[1] * (_M[3] * _M[8] - _M[5] * _M[6]) + _M[2] * (_M[3] * _M[7] - _M[4] * _M[6]);
+		if(Det == 0) throw Error("fx::img"s, ""s, "invert"s, ERR_BAD_ARGS, "Homography is singular."s);
+
+		return Homography
+		{
+			(_M[4] * _M[8] - _M[5] * _M[7]) / Det, (_M[2] * _M[7] - _M[1] * _M[8]) / Det, (_M[1] * _M[5] - _M[2] * _M[4]) / Det,
+			(_M[5] * _M[6] - _M[3] * _M[8]) / Det, (_M[0] * _M[8] - _M[2] * _M[6]) / Det, (_M[2] * _M[3] - _M[0] * _M[5]) / Det,
+			(_M[3] * _M[7] - _M[4] * _M[6]) / Det, (_M[1] * _M[6] - _M[0] * _M[7]) / Det, (_M[0] * _M[4] - _M[1] * _M[3]) / Det
+		};
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Warp internals.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img::impl
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Output is produced in tiles, so source pixels touched by rotated or scaled rows are reused from cache by neighbouring rows.
+	// Source coordinates are 16.16 fixed point. Coordinates are clamped to range where that cannot overflow, such points are far outside anyway.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr auto WARP_TILE_W = u64(64);
+	constexpr auto WARP_TILE_H = u64(16);
+	constexpr auto WARP_LIMIT = r64(1 << 30);
+
+	inline auto toFixed16 ( const r64 _Val ) -> i64 { return std::llround(std::clamp(_Val, -WARP_LIMIT, WARP_LIMIT) * 65536.0); }
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Bilinear blend of four neighbours at 16.16 position. u8 uses 8 bit weights in integers, other types interpolate in r32.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> inline auto blend ( const T _A, const T _B, const T _C, const T _E, const i64 _Fx, const i64 _Fy ) -> T
+	{
+		if constexpr(std::is_same_v<T, u8>)
+		{
+			const auto Wx = i32((_Fx >> 8) & 0xFF);
+			const auto Wy = i32((_Fy >> 8) & 0xFF);
+			const auto Top = i32(_A) * (256 - Wx) + i32(_B) * Wx;
+			const auto Bottom = i32(_C) * (256 - Wx) + i32(_E) * Wx;
+			return u8((Top * (256 - Wy) + Bottom * Wy + 32768) >> 16);
+		}
+		else
+		{
+			const auto Rx = r32(_Fx & 0xFFFF) * (1.0f / 65536.0f);
+			const auto Ry = r32(_Fy & 0xFFFF) * (1.0f / 65536.0f);
+			const auto Top = r32(_A) + (r32(_B) - r32(_A)) * Rx;
+			const auto Bottom = r32(_C) + (r32(_E) - r32(_C)) * Rx;
+			return saturate<T>(Top + (Bottom - Top) * Ry);
+		}
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Warp driver. _Map(X0, Y, Count, Fx, Fy) writes 16.16 source coordinates of destination pixels X0 .. X0 + Count - 1 in row Y.
+	// Neighbours outside source take _Fill when given, otherwise come from _Border rule.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T, class F> auto warp ( const ImageView<const T>& _Src, const ImageView<T>& _Dst, const OpSample _Sample, const Border _Border, const T* _Fill, F&& _Map ) -> void
+	{
+		const auto W = i64(_Src.width());
+		const auto H = i64(_Src.height());
+		const auto D = _Src.depth();
+		const auto TilesY = (_Dst.height() + WARP_TILE_H - 1) / WARP_TILE_H;
+		const auto SrcData = _Src.data();
+		const auto Stride = _Src.stride();
+
+		thr::parallelFor(0, TilesY, 1, [&]( const u64 _Lo, const u64 _Hi )
+		{
+			i64 Fx[WARP_TILE_W];
+			i64 Fy[WARP_TILE_W];
+
+			mgx::withDepth(D, [&]( auto _Depth )
+			{
+				constexpr auto FIXED = decltype(_Depth)::value;
+				const auto Dc = (FIXED == 0) ? D : FIXED;
+
+				// Pixel at integer source position, resolving points outside source.
+				const auto Fetch = [&]( i64 _X, i64 _Y, const u64 _C ) -> T
+				{
+					if((_X < 0) || (_Y < 0) || (_X >= W) || (_Y >= H))
+					{
+						if(_Fill) return _Fill[_C];
+						_X = borderIndex(_X, W, _Border);
+						_Y = borderIndex(_Y, H, _Border);
+					}
+					return _Src.row(u64(_Y))[u64(_X) * Dc + _C];
+				};
+
+				for(auto Ty = _Lo; Ty < _Hi; ++Ty)
+				{
+					const auto Y0 = Ty * WARP_TILE_H;
+					const auto Y1 = std::min(_Dst.height(), Y0 + WARP_TILE_H);
+
+					for(auto X0 = u64(0); X0 < _Dst.width(); X0 += WARP_TILE_W)
+					{
+						const auto Count = std::min(WARP_TILE_W, _Dst.width() - X0);
+
+						for(auto y = Y0; y < Y1; ++y)
+						{
+							_Map(X0, y, Count, Fx, Fy);
+							auto Out = _Dst.row(y) + X0 * Dc;
+
+							if(_Sample == OpSample::NEAREST)
+							{
+								for(auto i = u64(0); i < Count; ++i, Out += Dc)
+								{
+									const auto Ix = (Fx[i] + 32768) >> 16;
+									const auto Iy = (Fy[i] + 32768) >> 16;
+
+									if((Ix >= 0) && (Iy >= 0) && (Ix < W) && (Iy < H)) std::memcpy(Out, _Src.row(u64(Iy)) + u64(Ix) * Dc, Dc * sizeof(T));
+									else for(auto c = u64(0); c < Dc; ++c) Out[c] = Fetch(Ix, Iy, c);
+								}
+								continue;
+							}
+
+							for(auto i = u64(0); i < Count; ++i, Out += Dc)
+							{
+								const auto Ix = Fx[i] >> 16;
+								const auto Iy = Fy[i] >> 16;
+
+								if((u64(Ix) < u64(W - 1)) && (u64(Iy) < u64(H - 1)))
+								{
+									const auto P0 = SrcData + u64(Iy) * Stride + u64(Ix) * Dc;
+									const auto P1 = P0 + Stride;
+									for(auto c = u64(0); c < Dc; ++c) Out[c] = blend(P0[c], P0[Dc + c], P1[c], P1[Dc + c], Fx[i], Fy[i]);
+								}
+								else
+								{
+									for(auto c = u64(0); c < Dc; ++c) Out[c] = blend(Fetch(Ix, Iy, c), Fetch(Ix + 1, Iy, c), Fetch(Ix, Iy + 1, c), Fetch(Ix + 1, Iy + 1, c), Fx[i], Fy[i]);
+								}
+							}
+						}
+					}
+				}
+			});
+		});
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Warp transforms.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Warp _Src by affine _Transform (source to destination) into _Dst. Transform is inverted once, then source position advances by constant step along each row segment.
+	// Neighbours outside source take *_Fill per channel when given, otherwise follow _Border.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto warpAffine ( const ImageView<const mgx::identity_t<T>>& _Src, const ImageView<T>& _Dst, const Affine& _Transform, const OpSample _Sample = OpSample::BILINEAR, const Border _Border = Border::CLAMP, const T* _Fill = nullptr ) -> void
+	{
+		static_assert(std::is_arithmetic_v<T>, "fx::img::warpAffine | Type not implemented.");
+		if(_Src.isEmpty() || _Dst.isEmpty()) throw Error("fx::img"s, ""s, "warpAffine"s, ERR_EMPTY, "Image is empty."s);
+		if(_Src.depth() != _Dst.depth()) throw Error("fx::img"s, ""s, "warpAffine"s, ERR_INCONSISTENT_DIM, "Inconsistent depth."s);
+
+		const auto M = invert(_Transform);
+		const auto StepX = impl::toFixed16(M[0]);
+		const auto StepY = impl::toFixed16(M[3]);
+
+		impl::warp<T>(_Src, _Dst, _Sample, _Border, _Fill, [&]( const u64 _X0, const u64 _Y, const u64 _Count, i64* _Fx, i64* _Fy )
+		{
+			// Exact start of every segment keeps fixed point drift below 1/1000 pixel.
+			const auto X = r64(_X0);
+			const auto Y = r64(_Y);
+			auto Sx = impl::toFixed16(M[0] * X + M[1] * Y + M[2]);
+			auto Sy = impl::toFixed16(M[3] * X + M[4] * Y + M[5]);
+
+			for(auto i = u64(0); i < _Count; ++i, Sx += StepX, Sy += StepY) { _Fx[i] = Sx; _Fy[i] = Sy; }
+		});
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Warp _Src by homography _Transform (source to destination) into _Dst. Homogeneous source position advances incrementally, one division per pixel.
+	// Destination pixels whose source point lies behind projection plane map to (-WARP_LIMIT, -WARP_LIMIT): they take *_Fill, or whatever _Border gives there
+	// without fill (top left pixel for CLAMP).
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto warpPerspective ( const ImageView<const mgx::identity_t<T>>& _Src, const ImageView<T>& _Dst, const Homography& _Transform, const OpSample _Sample = OpSample::BILINEAR, const Border _Border = Border::CLAMP, const T* _Fill = nullptr ) -> void
+	{
+		static_assert(std::is_arithmetic_v<T>, "fx::img::warpPerspective | Type not implemented.");
+		if(_Src.isEmpty() || _Dst.isEmpty()) throw Error("fx::img"s, ""s, "warpPerspective"s, ERR_EMPTY, "Image is empty."s);
+		if(_Src.depth() != _Dst.depth()) throw Error("fx::img"s, ""s, "warpPerspective"s, ERR_INCONSISTENT_DIM, "Inconsistent depth."s);
+
+		const auto M = invert(_Transform);
+
+		impl::warp<T>(_Src, _Dst, _Sample, _Border, _Fill, [&]( const u64 _X0, const u64 _Y, const u64 _Count, i64* _Fx, i64* _Fy )
+		{
+			const auto X = r64(_X0);
+			const auto Y = r64(_Y);
+			auto Hx = M[0] * X + M[1] * Y + M[2];
+			auto Hy = M[3] * X + M[4] * Y + M[5];
+			auto Hw = M[6] * X + M[7] * Y + M[8];
+
+			for(auto i = u64(0); i < _Count; ++i, Hx += M[0], Hy += M[3], Hw += M[6])
+			{
+				const auto Inv = (Hw > 0) ? 1.0 / Hw : 0.0;
+				_Fx[i] = (Hw > 0) ? impl::toFixed16(Hx * Inv) : impl::toFixed16(-impl::WARP_LIMIT);
+				_Fy[i] = (Hw > 0) ? impl::toFixed16(Hy * Inv) : impl::toFixed16(-impl::WARP_LIMIT);
+			}
+		});
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Warp into new image of _Width x _Height.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto warpAffine ( const Image<T>& _Src, const Affine& _Transform, const u64 _Width, const u64 _Height, const OpSample _Sample = OpSample::BILINEAR, const Border _Border = Border::CLAMP ) -> Image<T>
+	{
+		auto NewImage = Image<T>(_Width, _Height, _Src.depth());
+		warpAffine<T>(_Src.view(), NewImage.view(), _Transform, _Sample, _Border);
+		return NewImage;
+	}
+
+	template<class T> auto warpPerspective ( const Image<T>& _Src, const Homography& _Transform, const u64 _Width, const u64 _Height, const OpSample _Sample = OpSample::BILINEAR, const Border _Border = Border::CLAMP ) -> Image<T>
+	{
+		auto NewImage = Image<T>(_Width, _Height, _Src.depth());
+		warpPerspective<T>(_Src.view(), NewImage.view(), _Transform, _Sample, _Border);
+		return NewImage;
+	}
+}
@@ -0,0 +1,248 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include "./Error.hpp"
+#include "./Image.hpp"
+#include "./ImagePyramid.hpp"
+#include "./Threads.hpp"
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <mutex>
+#include <numbers>
+#include <type_traits>
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Perceptual hashing.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// 64 bit perceptual hashes. AVERAGE compares 8x8 thumbnail with its mean, DIFFERENCE compares horizontal neighbours of 9x8 thumbnail,
+	// PERCEPTUAL compares lowest 8x8 DCT coefficients of 32x32 thumbnail with their median. Bit i is cell i in row major order.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	enum struct OpHash { AVERAGE, DIFFERENCE, PERCEPTUAL };
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Perceptual hashing internals.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img::impl
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Luma thumbnail of _Width x _Height. Image is halved with box downsample while that leaves at least two pixels per cell, remaining cells are area averaged.
+	// Three or more channels use BT.601 luma weights, fewer use first channel.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto hashThumbnail ( const Image<T>& _Src, const u64 _Width, const u64 _Height ) -> std::vector<r32>
+	{
+		auto Reduced = Image<T>();
+		auto Current = &_Src;
+		while((Current->width() >= 4 * _Width) && (Current->height() >= 4 * _Height))
+		{
+			Reduced = downsample(*Current);
+			Current = &Reduced;
+		}
+
+		const auto W = Current->width();
+		const auto H = Current->height();
+		const auto D = Current->depth();
+		auto Thumb = std::vector<r32>(_Width * _Height, 0.0f);
+
+		for(auto j = u64(0); j < _Height; ++j)
+		{
+			const auto Y0 = (j * H) / _Height;
+			const auto Y1 = std::max(Y0 + 1, ((j + 1) * H) / _Height);
+
+			for(auto i = u64(0); i < _Width; ++i)
+			{
+				const auto X0 = (i * W) / _Width;
+				const auto X1 = std::max(X0 + 1, ((i + 1) * W) / _Width);
+				auto Sum = 0.0f;
+
+				for(auto y = Y0; y < Y1; ++y)
+				{
+					const auto Row = Current->data() + y * W * D;
+					if(D >= 3) for(auto x = X0; x < X1; ++x) Sum += 0.299f * r32(Row[x * D]) + 0.587f * r32(Row[x * D + 1]) + 0.114f * r32(Row[x * D + 2]);
+					else for(auto x = X0; x < X1; ++x) Sum += r32(Row[x * D]);
+				}
+
+				Thumb[j * _Width + i] = Sum / r32((Y1 - Y0) * (X1 - X0));
+			}
+		}
+
+		return Thumb;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// First 8 rows of orthonormal 32 point DCT-II matrix. Only lowest frequencies are needed, so 2D DCT is two small products instead of full transform.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr auto PHASH_SIZE = u64(32);
+	constexpr auto PHASH_KEEP = u64(8);
+
+	inline auto dctRows ( void ) -> const std::array<r32, PHASH_KEEP * PHASH_SIZE>&
+	{
+		static const auto Table = []
+		{
+			auto T = std::array<r32, PHASH_KEEP * PHASH_SIZE>();
+			for(auto k = u64(0); k < PHASH_KEEP; ++k)
+			{
+				const auto Scale = (k == 0) ? std::sqrt(1.0 / r64(PHASH_SIZE)) : std::sqrt(2.0 / r64(PHASH_SIZE));
+				for(auto n = u64(0); n < PHASH_SIZE; ++n) T[k * PHASH_SIZE + n] = r32(Scale * std::cos(std::numbers::pi * (r64(n) + 0.5) * r64(k) / r64(PHASH_SIZE)));
+			}
+			return T;
+		}();
+
+		return Table;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Perceptual hashing.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Average hash.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto ahash ( const Image<T>& _Src ) -> u64
+	{
+		static_assert(std::is_arithmetic_v<T>, "fx::img::ahash | Type not implemented.");
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "ahash"s, ERR_EMPTY, "Image is empty."s);
+
+		const auto Thumb = impl::hashThumbnail(_Src, 8, 8);
+		auto Mean = 0.0f;
+		for(auto V : Thumb) Mean += V;
+		Mean /= 64.0f;
+
+		auto Hash = u64(0);
+		for(auto i = u64(0); i < 64; ++i) if(Thumb[i] > Mean) Hash |= u64(1) << i;
+		return Hash;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Difference hash. Bit is set where brightness rises to the right.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto dhash ( const Image<T>& _Src ) -> u64
+	{
+		static_assert(std::is_arithmetic_v<T>, "fx::img::dhash | Type not implemented.");
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "dhash"s, ERR_EMPTY, "Image is empty."s);
+
+		const auto Thumb = impl::hashThumbnail(_Src, 9, 8);
+
+		auto Hash = u64(0);
+		for(auto y = u64(0); y < 8; ++y) for(auto x = u64(0); x < 8; ++x) if(Thumb[y * 9 + x + 1] > Thumb[y * 9 + x]) Hash |= u64(1) << (y * 8 + x);
+		return Hash;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// DCT hash. Median is taken without DC coefficient, which only carries overall brightness.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto phash ( const Image<T>& _Src ) -> u64
+	{
+		static_assert(std::is_arithmetic_v<T>, "fx::img::phash | Type not implemented.");
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "phash"s, ERR_EMPTY, "Image is empty."s);
+
+		constexpr auto N = impl::PHASH_SIZE;
+		constexpr auto K = impl::PHASH_KEEP;
+		const auto Thumb = impl::hashThumbnail(_Src, N, N);
+		const auto& Dct = impl::dctRows();
+
+		// Rows: R = Thumb * Dct^T, 32 x 8. Then C = Dct * R, 8 x 8.
+		auto Rows = std::array<r32, N * K>();
+		for(auto y = u64(0); y < N; ++y)
+		{
+			for(auto k = u64(0); k < K; ++k)
+			{
+				auto Sum = 0.0f;
+				for(auto n = u64(0); n < N; ++n) Sum += Thumb[y * N + n] * Dct[k * N + n];
+				Rows[y * K + k] = Sum;
+			}
+		}
+
+		auto Coeffs = std::array<r32, K * K>();
+		for(auto k = u64(0); k < K; ++k)
+		{
+			for(auto i = u64(0); i < K; ++i)
+			{
+				auto Sum = 0.0f;
+				for(auto y = u64(0); y < N; ++y) Sum += Dct[k * N + y] * Rows[y * K + i];
+				Coeffs[k * K + i] = Sum;
+			}
+		}
+
+		auto Sorted = std::array<r32, K * K - 1>();
+		std::copy(Coeffs.begin() + 1, Coeffs.end(), Sorted.begin());
+		std::nth_element(Sorted.begin(), Sorted.begin() + Sorted.size() / 2, Sorted.end());
+		const auto Median = Sorted[Sorted.size() / 2];
+
+		auto Hash = u64(0);
+		for(auto i = u64(0); i < K * K; ++i) if(Coeffs[i] > Median) Hash |= u64(1) << i;
+		return Hash;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Hash by operation.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto hash ( const Image<T>& _Src, const OpHash _Op ) -> u64
+	{
+		if(_Op == OpHash::AVERAGE) return ahash(_Src);
+		if(_Op == OpHash::DIFFERENCE) return dhash(_Src);
+		return phash(_Src);
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Hash many images in parallel, one image per task.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto hash ( const std::vector<Image<T>>& _Images, const OpHash _Op ) -> std::vector<u64>
+	{
+		auto Hashes = std::vector<u64>(_Images.size());
+		thr::parallelFor(0, _Images.size(), 1, [&]( const u64 _Lo, const u64 _Hi )
+		{
+			for(auto i = _Lo; i < _Hi; ++i) Hashes[i] = hash(_Images[i], _Op);
+		});
+
+		return Hashes;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Number of differing bits.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr inline auto hammingDistance ( const u64 _A, const u64 _B ) -> u32 { return u32(std::popcount(_A ^ _B)); }
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Indices of all hashes within _MaxDistance bits of _Query, ascending. Array is scanned in parallel chunks.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto hammingSearch ( const u64* _Hashes, const u64 _Count, const u64 _Query, const u32 _MaxDistance ) -> std::vector<u64>
+	{
+		auto Parts = std::vector<std::pair<u64, std::vector<u64>>>();
+		auto Lock = std::mutex();
+
+		thr::parallelFor(0, _Count, u64(1) << 16, [&]( const u64 _Lo, const u64 _Hi )
+		{
+			auto Found = std::vector<u64>();
+			for(auto i = _Lo; i < _Hi; ++i) if(hammingDistance(_Hashes[i], _Query) <= _MaxDistance) Found.push_back(i);
+
+			auto Guard = std::lock_guard<std::mutex>(Lock);
+			Parts.emplace_back(_Lo, std::move(Found));
+		});
+
+		std::sort(Parts.begin(), Parts.end(), []( const auto& _A, const auto& _B ){ return _A.first < _B.first; });
+
+		auto Result = std::vector<u64>();
+		for(auto& Part : Parts) Result.insert(Result.end(), Part.second.begin(), Part.second.end());
+		return Result;
+	}
+
+	inline auto hammingSearch ( const std::vector<u64>& _Hashes, const u64 _Query, const u32 _MaxDistance ) -> std::vector<u64>
+	{
+		return hammingSearch(_Hashes.data(), _Hashes.size(), _Query, _MaxDistance);
+	}
+}
@@ -0,0 +1,292 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include "./Error.hpp"
+#include "./Image.hpp"
+#include "./Threads.hpp"
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Connected components.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Pixel neighbourhood. FOUR joins pixels sharing edge, EIGHT also joins diagonal ones.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	enum struct Connectivity { FOUR, EIGHT };
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// One connected component. Bounding box is inclusive.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	struct Component
+	{
+		u64 Area;
+		u64 MinX;
+		u64 MinY;
+		u64 MaxX;
+		u64 MaxY;
+		r64 CentroidX;
+		r64 CentroidY;
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Result of labeling. Background is 0, component i is stored in Labels as i + 1.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	struct Labeling
+	{
+		Image<u32> Labels;
+		std::vector<Component> Components;
+	};
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Connected components internals.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img::impl
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Union-find over provisional labels. Roots always link to smaller root, so every parent is smaller than its child and one ascending pass flattens whole forest.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto findRoot ( u32* _Parent, u32 _Label ) -> u32
+	{
+		while(_Parent[_Label] < _Label) _Label = _Parent[_Label];
+		return _Label;
+	}
+
+	inline auto unite ( u32* _Parent, const u32 _A, const u32 _B ) -> u32
+	{
+		const auto RootA = findRoot(_Parent, _A);
+		const auto RootB = findRoot(_Parent, _B);
+		const auto Root = std::min(RootA, RootB);
+
+		_Parent[RootA] = Root;
+		_Parent[RootB] = Root;
+		_Parent[_A] = Root;
+		_Parent[_B] = Root;
+		return Root;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Statistics of one provisional label, folded into final components after flattening.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	struct LabelAcc
+	{
+		u64 Area = 0;
+		u64 MinX = std::numeric_limits<u64>::max();
+		u64 MinY = std::numeric_limits<u64>::max();
+		u64 MaxX = 0;
+		u64 MaxY = 0;
+		u64 SumX = 0;
+		u64 SumY = 0;
+
+		inline auto add ( const u64 _X, const u64 _Y ) -> void
+		{
+			++this->Area;
+			this->MinX = std::min(this->MinX, _X);
+			this->MinY = std::min(this->MinY, _Y);
+			this->MaxX = std::max(this->MaxX, _X);
+			this->MaxY = std::max(this->MaxY, _Y);
+			this->SumX += _X;
+			this->SumY += _Y;
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Most provisional labels stripe of _Rows rows can create: isolated pixels on checkerboard (FOUR) or every other pixel of every other row (EIGHT).
+	// Only bounds label count, storage grows with labels actually created.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto labelBudget ( const u64 _Width, const u64 _Rows, const Connectivity _Conn ) -> u64
+	{
+		if(_Conn == Connectivity::FOUR) return (_Width * _Rows + 1) / 2;
+		return ((_Width + 1) / 2) * ((_Rows + 1) / 2);
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// First pass over rows [_Lo, _Hi). Row _Lo is scanned as if nothing was above it, stripes are joined later. Neighbours are visited in decision tree order:
+	// when pixel above is set it already connects left and right neighbours, so they are only looked at when it is not.
+	// Labels are local to stripe, starting at 1. _Parent and _Acc start with background entry and grow by one per new label.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<Connectivity CONN> auto labelStripe ( const Image<u8>& _Src, Image<u32>& _Labels, std::vector<u32>& _Parent, std::vector<LabelAcc>& _Acc, const u64 _Lo, const u64 _Hi ) -> void
+	{
+		const auto W = _Src.width();
+
+		for(auto y = _Lo; y < _Hi; ++y)
+		{
+			const auto In = _Src.data() + y * W;
+			const auto Up = (y > _Lo) ? _Labels.data() + (y - 1) * W : nullptr;
+			auto Out = _Labels.data() + y * W;
+
+			for(auto x = u64(0); x < W; ++x)
+			{
+				if(In[x] == 0) { Out[x] = 0; continue; }
+
+				const auto D = (x > 0) ? Out[x - 1] : 0u;
+				const auto B = Up ? Up[x] : 0u;
+				auto Label = 0u;
+
+				if constexpr(CONN == Connectivity::EIGHT)
+				{
+					const auto A = (Up && x > 0) ? Up[x - 1] : 0u;
+					const auto C = (Up && x + 1 < W) ? Up[x + 1] : 0u;
+
+					if(B) Label = B;
+					else if(C)
+					{
+						if(A) Label = unite(_Parent.data(), C, A);
+						else if(D) Label = unite(_Parent.data(), C, D);
+						else Label = C;
+					}
+					else if(A) Label = A;
+					else if(D) Label = D;
+				}
+				else
+				{
+					if(B && D) Label = (B == D) ? B : unite(_Parent.data(), B, D);
+					else if(B) Label = B;
+					else if(D) Label = D;
+				}
+
+				if(Label == 0)
+				{
+					Label = u32(_Parent.size());
+					_Parent.push_back(Label);
+					_Acc.emplace_back();
+				}
+
+				Out[x] = Label;
+				_Acc[Label].add(x, y);
+			}
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Connected components.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Label connected components of non-zero pixels in single channel mask. Two pass union-find: stripes of rows are scanned in parallel into stripe local labels,
+	// local labels are packed into one global range, stripe seams are joined, forest is flattened to consecutive labels in scan order and second parallel pass
+	// rewrites label image. Union-find and statistics storage grows with labels actually created.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto label ( const Image<u8>& _Src, const Connectivity _Conn = Connectivity::EIGHT ) -> Labeling
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "label"s, ERR_EMPTY, "Image is empty."s);
+		if(_Src.depth() != 1) throw Error("fx::img"s, ""s, "label"s, ERR_NOT_FLAT, "Image is not flat."s);
+
+		const auto W = _Src.width();
+		const auto H = _Src.height();
+		const auto Stripes = std::min(H, std::max(u64(1), (thr::sharedPool().size() + 1) * 2));
+
+		auto Budget = u64(1);
+		for(auto s = u64(0); s < Stripes; ++s) Budget += impl::labelBudget(W, (H * (s + 1)) / Stripes - (H * s) / Stripes, _Conn);
+		if(Budget > u64(std::numeric_limits<u32>::max())) throw Error("fx::img"s, ""s, "label"s, ERR_BAD_ARGS, "Image is too large to label."s);
+
+		auto Result = Labeling{ Image<u32>(W, H, 1), {} };
+		auto Parents = std::vector<std::vector<u32>>(Stripes, std::vector<u32>(1, 0));
+		auto Accs = std::vector<std::vector<impl::LabelAcc>>(Stripes, std::vector<impl::LabelAcc>(1));
+
+		thr::parallelFor(0, Stripes, 1, [&]( const u64 _Lo, const u64 _Hi )
+		{
+			for(auto s = _Lo; s < _Hi; ++s)
+			{
+				const auto RowLo = (H * s) / Stripes;
+				const auto RowHi = (H * (s + 1)) / Stripes;
+
+				if(_Conn == Connectivity::EIGHT) impl::labelStripe<Connectivity::EIGHT>(_Src, Result.Labels, Parents[s], Accs[s], RowLo, RowHi);
+				else impl::labelStripe<Connectivity::FOUR>(_Src, Result.Labels, Parents[s], Accs[s], RowLo, RowHi);
+			}
+		});
+
+		// Stripe local label l becomes global label l + Shifts[s]. Ranges are packed back to back, label 0 stays background.
+		auto Shifts = std::vector<u32>(Stripes, 0);
+		auto Parent = std::vector<u32>(1, 0);
+		for(auto s = u64(0); s < Stripes; ++s)
+		{
+			Shifts[s] = u32(Parent.size() - 1);
+			for(auto l = u64(1); l < Parents[s].size(); ++l) Parent.push_back(Parents[s][l] + Shifts[s]);
+			Parents[s] = {};
+		}
+
+		// Join components across stripe seams.
+		for(auto s = u64(1); s < Stripes; ++s)
+		{
+			const auto Y = (H * s) / Stripes;
+			const auto Up = Result.Labels.data() + (Y - 1) * W;
+			const auto Row = Result.Labels.data() + Y * W;
+			const auto ShiftUp = Shifts[s - 1];
+			const auto ShiftRow = Shifts[s];
+
+			for(auto x = u64(0); x < W; ++x)
+			{
+				if(Row[x] == 0) continue;
+				if(Up[x]) impl::unite(Parent.data(), Row[x] + ShiftRow, Up[x] + ShiftUp);
+
+				if(_Conn == Connectivity::EIGHT)
+				{
+					if(x > 0 && Up[x - 1]) impl::unite(Parent.data(), Row[x] + ShiftRow, Up[x - 1] + ShiftUp);
+					if(x + 1 < W && Up[x + 1]) impl::unite(Parent.data(), Row[x] + ShiftRow, Up[x + 1] + ShiftUp);
+				}
+			}
+		}
+
+		// Flatten to consecutive final labels and fold statistics into components.
+		auto Count = u32(0);
+		for(auto s = u64(0); s < Stripes; ++s)
+		{
+			for(auto l = u64(1); l < Accs[s].size(); ++l)
+			{
+				const auto g = u32(l) + Shifts[s];
+
+				if(Parent[g] == g)
+				{
+					Parent[g] = ++Count;
+					Result.Components.push_back(Component{ 0, std::numeric_limits<u64>::max(), std::numeric_limits<u64>::max(), 0, 0, 0.0, 0.0 });
+				}
+				else Parent[g] = Parent[Parent[g]];
+
+				const auto& Src = Accs[s][l];
+				auto& Dst = Result.Components[Parent[g] - 1];
+				Dst.Area += Src.Area;
+				Dst.MinX = std::min(Dst.MinX, Src.MinX);
+				Dst.MinY = std::min(Dst.MinY, Src.MinY);
+				Dst.MaxX = std::max(Dst.MaxX, Src.MaxX);
+				Dst.MaxY = std::max(Dst.MaxY, Src.MaxY);
+				Dst.CentroidX += r64(Src.SumX);
+				Dst.CentroidY += r64(Src.SumY);
+			}
+
+			Accs[s] = {};
+		}
+
+		for(auto& Comp : Result.Components)
+		{
+			Comp.CentroidX /= r64(Comp.Area);
+			Comp.CentroidY /= r64(Comp.Area);
+		}
+
+		// Second pass: stripe local to final labels.
+		thr::parallelFor(0, Stripes, 1, [&]( const u64 _Lo, const u64 _Hi )
+		{
+			for(auto s = _Lo; s < _Hi; ++s)
+			{
+				auto Ptr = Result.Labels.data() + ((H * s) / Stripes) * W;
+				const auto End = Result.Labels.data() + ((H * (s + 1)) / Stripes) * W;
+				const auto Shift = Shifts[s];
+				for(; Ptr < End; ++Ptr) if(*Ptr) *Ptr = Parent[*Ptr + Shift];
+			}
+		});
+
+		return Result;
+	}
+}
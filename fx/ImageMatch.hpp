@@ -0,0 +1,259 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include "./Error.hpp"
+#include "./Image.hpp"
+#include "./Threads.hpp"
+#include "./ImageFilter.hpp"
+#include "./Fft.hpp"
+#include "./magic.hpp"
+#include <vector>
+#include <complex>
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Template matching.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Match scores. SQDIFF is sum of squared differences (best is lowest), CCORR plain cross-correlation, CCORR_NORMED correlation over product of norms,
+	// CCOEFF_NORMED correlation of mean-subtracted window and template, i.e. Pearson coefficient in [-1, 1].
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	enum struct OpMatch { SQDIFF, CCORR, CCORR_NORMED, CCOEFF_NORMED };
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Template matching internals.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img::impl
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Smallest FFT tile, tiles are at least twice template size so most of every tile yields output.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr auto MATCH_MIN_TILE = u64(64);
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Direct correlation C(x, y) = sum of I(x + i, y + j) * T(i, j) over all channels. Template rows are applied to whole output rows at once.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto correlateSpatial ( const Image<T>& _Src, const std::vector<r64>& _Templ, const u64 _TW, const u64 _TH, Image<r64>& _Dst ) -> void
+	{
+		const auto W = _Src.width();
+		const auto D = _Src.depth();
+		const auto OW = _Dst.width();
+
+		thr::parallelFor(0, _Dst.height(), 1, [&]( const u64 _Lo, const u64 _Hi )
+		{
+			auto Acc = std::vector<r64>(OW * D);
+
+			mgx::withDepth(D, [&]( auto _Depth )
+			{
+				constexpr auto FIXED = decltype(_Depth)::value;
+				const auto Dc = (FIXED == 0) ? D : FIXED;
+
+				for(auto y = _Lo; y < _Hi; ++y)
+				{
+					std::fill(Acc.begin(), Acc.end(), 0.0);
+
+					for(auto j = u64(0); j < _TH; ++j)
+					{
+						const auto Row = _Src.data() + (y + j) * W * Dc;
+						const auto TRow = _Templ.data() + j * _TW * Dc;
+
+						for(auto i = u64(0); i < _TW; ++i)
+						{
+							const auto In = Row + i * Dc;
+							for(auto c = u64(0); c < Dc; ++c)
+							{
+								const auto Tap = TRow[i * Dc + c];
+								if(Tap == 0.0) continue;
+								for(auto x = u64(0); x < OW; ++x) Acc[x * Dc + c] += Tap * r64(In[x * Dc + c]);
+							}
+						}
+					}
+
+					auto Out = _Dst.data() + y * OW;
+					for(auto x = u64(0); x < OW; ++x)
+					{
+						auto Sum = 0.0;
+						for(auto c = u64(0); c < Dc; ++c) Sum += Acc[x * Dc + c];
+						Out[x] = Sum;
+					}
+				}
+			});
+		});
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Overlap-save correlation. Template spectrum is computed once per channel, then P x P tiles of image step by P - template size + 1 and run in parallel.
+	// Product of tile spectrum and conjugate template spectrum is circular correlation, its first (P - w + 1) x (P - h + 1) values are exact.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto correlateFft ( const Image<T>& _Src, const std::vector<r64>& _Templ, const u64 _TW, const u64 _TH, const u64 _Tile, Image<r64>& _Dst ) -> void
+	{
+		const auto W = _Src.width();
+		const auto H = _Src.height();
+		const auto D = _Src.depth();
+		const auto P = _Tile;
+		const auto Plan = math::FftReal2D<r64>(P, P);
+		const auto B = Plan.bins();
+		const auto StepX = P - _TW + 1;
+		const auto StepY = P - _TH + 1;
+		const auto TilesX = (_Dst.width() + StepX - 1) / StepX;
+		const auto TilesY = (_Dst.height() + StepY - 1) / StepY;
+
+		auto Spectra = std::vector<std::complex<r64>>(D * P * B);
+		{
+			auto Tile = std::vector<r64>(P * P);
+			for(auto c = u64(0); c < D; ++c)
+			{
+				std::fill(Tile.begin(), Tile.end(), 0.0);
+				for(auto j = u64(0); j < _TH; ++j) for(auto i = u64(0); i < _TW; ++i) Tile[j * P + i] = _Templ[(j * _TW + i) * D + c];
+				Plan.forward(Tile.data(), Spectra.data() + c * P * B);
+			}
+		}
+
+		thr::parallelFor(0, TilesX * TilesY, 1, [&]( const u64 _Lo, const u64 _Hi )
+		{
+			auto Tile = std::vector<r64>(P * P);
+			auto Spectrum = std::vector<std::complex<r64>>(P * B);
+			auto Sum = std::vector<std::complex<r64>>(P * B);
+
+			for(auto t = _Lo; t < _Hi; ++t)
+			{
+				const auto X0 = (t % TilesX) * StepX;
+				const auto Y0 = (t / TilesX) * StepY;
+				const auto Nx = std::min(W, X0 + P) - X0;
+				const auto Ny = std::min(H, Y0 + P) - Y0;
+				std::fill(Sum.begin(), Sum.end(), std::complex<r64>(0.0, 0.0));
+
+				for(auto c = u64(0); c < D; ++c)
+				{
+					std::fill(Tile.begin(), Tile.end(), 0.0);
+					for(auto j = u64(0); j < Ny; ++j)
+					{
+						const auto In = _Src.data() + ((Y0 + j) * W + X0) * D + c;
+						auto Out = Tile.data() + j * P;
+						for(auto i = u64(0); i < Nx; ++i) Out[i] = r64(In[i * D]);
+					}
+
+					Plan.forward(Tile.data(), Spectrum.data());
+
+					const auto Templ = Spectra.data() + c * P * B;
+					for(auto i = u64(0); i < P * B; ++i) Sum[i] += Spectrum[i] * std::conj(Templ[i]);
+				}
+
+				// Inverse uses Sum as scratch and leaves it undefined, which is fine: it is cleared at start of every tile.
+				Plan.inverse(Sum.data(), Tile.data());
+
+				const auto OutW = std::min(_Dst.width() - X0, StepX);
+				const auto OutH = std::min(_Dst.height() - Y0, StepY);
+				for(auto j = u64(0); j < OutH; ++j) std::copy(Tile.data() + j * P, Tile.data() + j * P + OutW, _Dst.data() + (Y0 + j) * _Dst.width() + X0);
+			}
+		});
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Template matching.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Score every placement of _Templ inside _Src, result is (W - w + 1) x (H - h + 1). Channels are summed.
+	// Correlation is computed directly for small templates and by overlap-save FFT for large ones, whichever estimate is cheaper. Window sums and sums of squares
+	// for normalization come from summed area tables. CCOEFF_NORMED correlates with mean-subtracted template, so no large terms cancel.
+	// Flat windows, which have no defined normalized score, get 0.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto matchTemplate ( const Image<T>& _Src, const Image<T>& _Templ, const OpMatch _Op = OpMatch::CCOEFF_NORMED ) -> Image<r32>
+	{
+		static_assert(std::is_arithmetic_v<T>, "fx::img::matchTemplate | Type not implemented.");
+		if(_Src.isEmpty() || _Templ.isEmpty()) throw Error("fx::img"s, ""s, "matchTemplate"s, ERR_EMPTY, "Image is empty."s);
+		if(_Src.depth() != _Templ.depth()) throw Error("fx::img"s, ""s, "matchTemplate"s, ERR_INCONSISTENT_DIM, "Inconsistent dimensions."s);
+		if((_Templ.width() > _Src.width()) || (_Templ.height() > _Src.height())) throw Error("fx::img"s, ""s, "matchTemplate"s, ERR_BAD_ARGS, "Template is larger than image."s);
+
+		const auto D = _Src.depth();
+		const auto TW = _Templ.width();
+		const auto TH = _Templ.height();
+		const auto OW = _Src.width() - TW + 1;
+		const auto OH = _Src.height() - TH + 1;
+		const auto N = r64(TW * TH * D);
+
+		auto TSum = 0.0;
+		auto TSqr = 0.0;
+		for(auto i = u64(0); i < _Templ.size(); ++i) { TSum += r64(_Templ[i]); TSqr += r64(_Templ[i]) * r64(_Templ[i]); }
+
+		const auto TMean = (_Op == OpMatch::CCOEFF_NORMED) ? TSum / N : 0.0;
+		auto Templ = std::vector<r64>(_Templ.size());
+		for(auto i = u64(0); i < _Templ.size(); ++i) Templ[i] = r64(_Templ[i]) - TMean;
+
+		// Work estimates, in multiply-adds.
+		const auto Tile = std::max(impl::MATCH_MIN_TILE, math::nextFastSize(2 * std::max(TW, TH)));
+		const auto Tiles = r64((OW + Tile - TW) / (Tile - TW + 1)) * r64((OH + Tile - TH) / (Tile - TH + 1));
+		const auto FftCost = Tiles * (r64(D) + 1.0) * 3.0 * r64(Tile * Tile) * std::log2(r64(Tile * Tile));
+		const auto SpatialCost = r64(OW) * r64(OH) * N;
+
+		auto Corr = Image<r64>(OW, OH, 1);
+		if(FftCost < SpatialCost) impl::correlateFft(_Src, Templ, TW, TH, Tile, Corr);
+		else impl::correlateSpatial(_Src, Templ, TW, TH, Corr);
+
+		auto Result = Image<r32>(OW, OH, 1);
+
+		if(_Op == OpMatch::CCORR)
+		{
+			for(auto i = u64(0); i < Corr.size(); ++i) Result[i] = r32(Corr[i]);
+			return Result;
+		}
+
+		// Sum and sum of squares over window, all channels.
+		auto Squares = Image<r64>(_Src.width(), _Src.height(), D);
+		for(auto i = u64(0); i < _Src.size(); ++i) Squares[i] = r64(_Src[i]) * r64(_Src[i]);
+		const auto Sums = integral<r64>(_Src);
+		const auto SqrSums = integral<r64>(Squares);
+
+		const auto TVar = TSqr - TSum * TSum / N;
+
+		thr::parallelFor(0, OH, std::max(u64(1), u64(4096) / OW), [&]( const u64 _Lo, const u64 _Hi )
+		{
+			for(auto y = _Lo; y < _Hi; ++y)
+			{
+				for(auto x = u64(0); x < OW; ++x)
+				{
+					auto S1 = 0.0;
+					auto S2 = 0.0;
+					for(auto c = u64(0); c < D; ++c)
+					{
+						S1 += boxSum(Sums, x, y, x + TW, y + TH, c);
+						S2 += boxSum(SqrSums, x, y, x + TW, y + TH, c);
+					}
+
+					const auto C = Corr[y * OW + x];
+					auto Score = 0.0;
+
+					if(_Op == OpMatch::SQDIFF) Score = std::max(0.0, S2 - 2.0 * C + TSqr);
+					else if(_Op == OpMatch::CCORR_NORMED)
+					{
+						const auto Norm = std::sqrt(std::max(0.0, S2) * TSqr);
+						Score = (Norm > 0.0) ? C / Norm : 0.0;
+					}
+					else
+					{
+						const auto Norm = std::sqrt(std::max(0.0, S2 - S1 * S1 / N) * TVar);
+						Score = (Norm > 1e-9 * N) ? std::clamp(C / Norm, -1.0, 1.0) : 0.0;
+					}
+
+					Result[y * OW + x] = r32(Score);
+				}
+			}
+		});
+
+		return Result;
+	}
+}
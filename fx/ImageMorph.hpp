@@ -0,0 +1,176 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include "./Error.hpp"
+#include "./Image.hpp"
+#include "./Threads.hpp"
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Morphology internals.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img::impl
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Min for erosion, max for dilation. Identity is value that never wins, it pads lines past image edge.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T, bool MAX> struct MorphOp
+	{
+		static constexpr auto identity ( void ) -> T { return MAX ? std::numeric_limits<T>::lowest() : std::numeric_limits<T>::max(); }
+		static inline auto apply ( const T _A, const T _B ) -> T { if constexpr(MAX) return (_A < _B) ? _B : _A; else return (_B < _A) ? _B : _A; }
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Columns processed together by vertical pass. Whole rows of block are combined at once, so inner loops run along contiguous memory.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr auto MORPH_BLOCK = u64(128);
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// van Herk / Gil-Werman running min / max along rows. Padded line is cut in blocks of window size k, G holds prefix results within block,
+	// H suffix results. Window at x is then op(H[x], G[x + k - 1]): three operations per pixel for any window size.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T, bool MAX> auto morphRows ( const Image<T>& _Src, Image<T>& _Dst, const u64 _Radius ) -> void
+	{
+		using Op = MorphOp<T, MAX>;
+		const auto W = _Src.width();
+		const auto K = 2 * _Radius + 1;
+		const auto Padded = ((W + 2 * _Radius + K - 1) / K) * K;
+
+		thr::parallelFor(0, _Src.height(), std::max(u64(1), u64(16384) / W), [&]( const u64 _Lo, const u64 _Hi )
+		{
+			auto Line = std::vector<T>(Padded, Op::identity());
+			auto G = std::vector<T>(Padded);
+			auto H = std::vector<T>(Padded);
+
+			for(auto y = _Lo; y < _Hi; ++y)
+			{
+				std::copy(_Src.data() + y * W, _Src.data() + (y + 1) * W, Line.begin() + _Radius);
+
+				for(auto B = u64(0); B < Padded; B += K)
+				{
+					G[B] = Line[B];
+					for(auto i = B + 1; i < B + K; ++i) G[i] = Op::apply(G[i - 1], Line[i]);
+
+					H[B + K - 1] = Line[B + K - 1];
+					for(auto i = B + K - 1; i > B; --i) H[i - 1] = Op::apply(H[i], Line[i - 1]);
+				}
+
+				auto Out = _Dst.data() + y * W;
+				for(auto x = u64(0); x < W; ++x) Out[x] = Op::apply(H[x], G[x + K - 1]);
+			}
+		});
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Same along columns. Each block of columns runs van Herk / Gil-Werman on rows of MORPH_BLOCK values, so every step is element wise min / max of two arrays.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T, bool MAX> auto morphColumns ( const Image<T>& _Src, Image<T>& _Dst, const u64 _Radius ) -> void
+	{
+		using Op = MorphOp<T, MAX>;
+		const auto W = _Src.width();
+		const auto Height = _Src.height();
+		const auto K = 2 * _Radius + 1;
+		const auto Padded = ((Height + 2 * _Radius + K - 1) / K) * K;
+		const auto Blocks = (W + MORPH_BLOCK - 1) / MORPH_BLOCK;
+
+		thr::parallelFor(0, Blocks, 1, [&]( const u64 _Lo, const u64 _Hi )
+		{
+			auto G = std::vector<T>(Padded * MORPH_BLOCK);
+			auto H = std::vector<T>(Padded * MORPH_BLOCK);
+			auto Identity = std::vector<T>(MORPH_BLOCK, Op::identity());
+
+			for(auto Blk = _Lo; Blk < _Hi; ++Blk)
+			{
+				const auto X0 = Blk * MORPH_BLOCK;
+				const auto N = std::min(W, X0 + MORPH_BLOCK) - X0;
+				const auto Row = [&]( const u64 _P ) -> const T* { return ((_P < _Radius) || (_P >= _Radius + Height)) ? Identity.data() : _Src.data() + (_P - _Radius) * W + X0; };
+
+				for(auto B = u64(0); B < Padded; B += K)
+				{
+					std::copy(Row(B), Row(B) + N, G.data() + B * MORPH_BLOCK);
+					for(auto p = B + 1; p < B + K; ++p)
+					{
+						const auto In = Row(p);
+						const auto Prev = G.data() + (p - 1) * MORPH_BLOCK;
+						auto Out = G.data() + p * MORPH_BLOCK;
+						for(auto i = u64(0); i < N; ++i) Out[i] = Op::apply(Prev[i], In[i]);
+					}
+
+					std::copy(Row(B + K - 1), Row(B + K - 1) + N, H.data() + (B + K - 1) * MORPH_BLOCK);
+					for(auto p = B + K - 1; p > B; --p)
+					{
+						const auto In = Row(p - 1);
+						const auto Next = H.data() + p * MORPH_BLOCK;
+						auto Out = H.data() + (p - 1) * MORPH_BLOCK;
+						for(auto i = u64(0); i < N; ++i) Out[i] = Op::apply(Next[i], In[i]);
+					}
+				}
+
+				for(auto y = u64(0); y < Height; ++y)
+				{
+					const auto A = H.data() + y * MORPH_BLOCK;
+					const auto C = G.data() + (y + K - 1) * MORPH_BLOCK;
+					auto Out = _Dst.data() + y * W + X0;
+					for(auto i = u64(0); i < N; ++i) Out[i] = Op::apply(A[i], C[i]);
+				}
+			}
+		});
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Rectangular erosion (MAX = false) or dilation (MAX = true). Pixels outside image never win.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T, bool MAX> auto morphRect ( const Image<T>& _Src, const u64 _RadiusX, const u64 _RadiusY ) -> Image<T>
+	{
+		auto Temp = Image<T>(_Src.width(), _Src.height(), 1);
+		auto NewImage = Image<T>(_Src.width(), _Src.height(), 1);
+
+		if(_RadiusX > 0) morphRows<T, MAX>(_Src, Temp, _RadiusX);
+		else std::copy(_Src.data(), _Src.data() + _Src.size(), Temp.data());
+
+		if(_RadiusY > 0) morphColumns<T, MAX>(Temp, NewImage, _RadiusY);
+		else std::swap(NewImage, Temp);
+
+		return NewImage;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Morphology.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Morphological operations.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	enum struct OpMorph { ERODE, DILATE, OPEN, CLOSE };
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Apply _Op with (2 * _RadiusX + 1) x (2 * _RadiusY + 1) rectangle to single channel image. Cost per pixel does not depend on rectangle size.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto morphology ( const Image<T>& _Src, const OpMorph _Op, const u64 _RadiusX, const u64 _RadiusY ) -> Image<T>
+	{
+		static_assert(std::is_same_v<T, u8> || std::is_same_v<T, r32>, "fx::img::morphology | Type not implemented.");
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "morphology"s, ERR_EMPTY, "Image is empty."s);
+		if(_Src.depth() != 1) throw Error("fx::img"s, ""s, "morphology"s, ERR_NOT_FLAT, "Image is not flat."s);
+
+		if(_Op == OpMorph::ERODE) return impl::morphRect<T, false>(_Src, _RadiusX, _RadiusY);
+		if(_Op == OpMorph::DILATE) return impl::morphRect<T, true>(_Src, _RadiusX, _RadiusY);
+		if(_Op == OpMorph::OPEN) return impl::morphRect<T, true>(impl::morphRect<T, false>(_Src, _RadiusX, _RadiusY), _RadiusX, _RadiusY);
+		return impl::morphRect<T, false>(impl::morphRect<T, true>(_Src, _RadiusX, _RadiusY), _RadiusX, _RadiusY);
+	}
+
+	template<class T> auto erode ( const Image<T>& _Src, const u64 _RadiusX, const u64 _RadiusY ) -> Image<T> { return morphology(_Src, OpMorph::ERODE, _RadiusX, _RadiusY); }
+	template<class T> auto dilate ( const Image<T>& _Src, const u64 _RadiusX, const u64 _RadiusY ) -> Image<T> { return morphology(_Src, OpMorph::DILATE, _RadiusX, _RadiusY); }
+	template<class T> auto open ( const Image<T>& _Src, const u64 _RadiusX, const u64 _RadiusY ) -> Image<T> { return morphology(_Src, OpMorph::OPEN, _RadiusX, _RadiusY); }
+	template<class T> auto close ( const Image<T>& _Src, const u64 _RadiusX, const u64 _RadiusY ) -> Image<T> { return morphology(_Src, OpMorph::CLOSE, _RadiusX, _RadiusY); }
+}
@@ -0,0 +1,411 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include "./Error.hpp"
+#include "./Image.hpp"
+#include "./Threads.hpp"
+#include "./magic.hpp"
+#include <array>
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Fused pipeline internals.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img::impl
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Pixels pushed through whole stage chain at once. Intermediate chunks of every stage together stay in L1.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr auto PIPE_CHUNK = u64(256);
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Stage interface. depth(D) checks input depth and returns output depth, Out<I> is element type produced from I,
+	// apply(In, Out, Count, D) transforms Count pixels of depth D.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Channel remap with compile time map. Like img::remap, map has one entry per channel, so depth is kept.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<int... MAP> struct StageRemap
+	{
+		template<class I> using Out = I;
+
+		auto depth ( const u64 _Depth ) const -> u64
+		{
+			if(sizeof...(MAP) != _Depth) throw Error("fx::img"s, ""s, "remap"s, ERR_BAD_ARGS, "Map size != depth."s);
+			if(((u64(MAP) >= _Depth) || ...)) throw Error("fx::img"s, ""s, "remap"s, ERR_BAD_ARGS, "Map index >= depth."s);
+			return _Depth;
+		}
+
+		template<class I, class O> auto apply ( const I* _In, O* _Out, const u64 _Count, const u64 _Depth ) const -> void
+		{
+			constexpr auto N = sizeof...(MAP);
+			constexpr auto Map = std::array<u64, N>{ u64(MAP)... };
+
+			mgx::withDepth(_Depth, [&]( auto _Fixed )
+			{
+				constexpr auto FIXED = decltype(_Fixed)::value;
+				const auto D = (FIXED == 0) ? _Depth : FIXED;
+				for(auto p = u64(0); p < _Count; ++p) for(auto c = u64(0); c < N; ++c) _Out[p * N + c] = O(_In[p * D + Map[c]]);
+			});
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Flatten to single channel, same rules as img::flatten.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	struct StageFlatten
+	{
+		OpFlatten Op;
+		Transfer Curve;
+
+		template<class I> using Out = I;
+
+		auto depth ( const u64 _Depth ) const -> u64
+		{
+			if((this->Op != OpFlatten::MEAN) && (this->channel() >= _Depth)) throw Error("fx::img"s, ""s, "flatten"s, ERR_BAD_ARGS, "Channel >= depth."s);
+			return 1;
+		}
+
+		auto channel ( void ) const -> u64
+		{
+			if(this->Op == OpFlatten::KEEP_GREEN) return 1;
+			if(this->Op == OpFlatten::KEEP_BLUE) return 2;
+			if(this->Op == OpFlatten::KEEP_ALPHA) return 3;
+			return 0;
+		}
+
+		template<class I, class O> auto apply ( const I* _In, O* _Out, const u64 _Count, const u64 _Depth ) const -> void
+		{
+			if(this->Op != OpFlatten::MEAN)
+			{
+				const auto Offset = this->channel();
+				for(auto p = u64(0); p < _Count; ++p) _Out[p] = _In[p * _Depth + Offset];
+				return;
+			}
+
+			if(this->Curve == Transfer::SRGB)
+			{
+				if constexpr((std::is_same_v<I, u8>) || (std::is_same_v<I, r32>))
+				{
+					const auto Scale = 1.0f / r32(_Depth);
+
+					for(auto p = u64(0); p < _Count; ++p)
+					{
+						auto Sum = 0.0f;
+						for(auto c = u64(0); c < _Depth; ++c) Sum += srgbToLinear(_In[p * _Depth + c]);
+
+						if constexpr(std::is_same_v<I, u8>) _Out[p] = linearToSrgb8(Sum * Scale);
+						else _Out[p] = linearToSrgb(Sum * Scale);
+					}
+				}
+
+				else throw Error("fx::img"s, ""s, "flatten"s, ERR_BAD_ARGS, "sRGB transfer needs u8 or r32 image."s);
+				return;
+			}
+
+			mgx::withDepth(_Depth, [&]( auto _Fixed )
+			{
+				constexpr auto FIXED = decltype(_Fixed)::value;
+				const auto D = (FIXED == 0) ? _Depth : FIXED;
+
+				for(auto p = u64(0); p < _Count; ++p)
+				{
+					auto Sum = initTypeMax<I>();
+					for(auto c = u64(0); c < D; ++c) Sum += _In[p * D + c];
+					_Out[p] = O(Sum / D);
+				}
+			});
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Replicate single channel to Depth channels.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	struct StageFatten
+	{
+		u64 Depth;
+
+		template<class I> using Out = I;
+
+		auto depth ( const u64 _Depth ) const -> u64
+		{
+			if(_Depth != 1) throw Error("fx::img"s, ""s, "fatten"s, ERR_NOT_FLAT, "Image is not flat."s);
+			if(this->Depth == 0) throw Error("fx::img"s, ""s, "fatten"s, ERR_BAD_ARGS, "Depth must be at least 1."s);
+			return this->Depth;
+		}
+
+		template<class I, class O> auto apply ( const I* _In, O* _Out, const u64 _Count, const u64 ) const -> void
+		{
+			mgx::withDepth(this->Depth, [&]( auto _Fixed )
+			{
+				constexpr auto FIXED = decltype(_Fixed)::value;
+				const auto D = (FIXED == 0) ? this->Depth : FIXED;
+				for(auto p = u64(0); p < _Count; ++p) for(auto c = u64(0); c < D; ++c) _Out[p * D + c] = _In[p];
+			});
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Integer to r32 scaled to 0-1, as Image<r32> conversion does. Real input is passed through.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	struct StageToFloat
+	{
+		template<class I> using Out = r32;
+
+		auto depth ( const u64 _Depth ) const -> u64 { return _Depth; }
+
+		template<class I, class O> auto apply ( const I* _In, O* _Out, const u64 _Count, const u64 _Depth ) const -> void
+		{
+			const auto N = _Count * _Depth;
+			if constexpr(std::is_integral_v<I>) { const auto Scale = r32(1.0) / r32(maxVal<I>()); for(auto i = u64(0); i < N; ++i) _Out[i] = Scale * r32(_In[i]); }
+			else for(auto i = u64(0); i < N; ++i) _Out[i] = r32(_In[i]);
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// 0-1 real to u8 with clamping and rounding. Unlike Image<u8> conversion there is no min-max stretch, which would need whole image.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	struct StageToByte
+	{
+		template<class I> using Out = u8;
+
+		auto depth ( const u64 _Depth ) const -> u64 { return _Depth; }
+
+		template<class I, class O> auto apply ( const I* _In, O* _Out, const u64 _Count, const u64 _Depth ) const -> void
+		{
+			static_assert(std::is_floating_point_v<I>, "fx::img::toByte | Type not implemented.");
+			const auto N = _Count * _Depth;
+			for(auto i = u64(0); i < N; ++i) _Out[i] = u8(std::clamp(_In[i], I(0), I(1)) * I(255) + I(0.5));
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Per channel (V - Mean) / Std. Single value applies to every channel. Reciprocals are taken once here, so chunks only multiply.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	struct StageNormalize
+	{
+		std::vector<r32> Shift;
+		std::vector<r32> Scale;
+
+		template<class I> using Out = I;
+
+		StageNormalize ( std::vector<r32> _Mean, const std::vector<r32>& _Std ) : Shift(std::move(_Mean)), Scale(_Std.size())
+		{
+			if(this->Shift.empty() || _Std.empty()) throw Error("fx::img"s, ""s, "normalize"s, ERR_BAD_ARGS, "Mean and std must not be empty."s);
+
+			for(auto c = u64(0); c < _Std.size(); ++c) this->Scale[c] = 1.0f / _Std[c];
+
+			// Broadcast single value to match per channel one, so both have same length.
+			if((this->Shift.size() == 1) && (this->Scale.size() > 1)) this->Shift.resize(this->Scale.size(), this->Shift[0]);
+			if((this->Scale.size() == 1) && (this->Shift.size() > 1)) this->Scale.resize(this->Shift.size(), this->Scale[0]);
+		}
+
+		auto depth ( const u64 _Depth ) const -> u64
+		{
+			if((this->Shift.size() != 1) && (this->Shift.size() != _Depth)) throw Error("fx::img"s, ""s, "normalize"s, ERR_BAD_ARGS, "Mean and std size != depth."s);
+			return _Depth;
+		}
+
+		template<class I, class O> auto apply ( const I* _In, O* _Out, const u64 _Count, const u64 _Depth ) const -> void
+		{
+			static_assert(std::is_floating_point_v<I>, "fx::img::normalize | Type not implemented.");
+
+			if(this->Shift.size() == 1)
+			{
+				const auto Shift = I(this->Shift[0]);
+				const auto Scale = I(this->Scale[0]);
+				for(auto i = u64(0); i < _Count * _Depth; ++i) _Out[i] = (_In[i] - Shift) * Scale;
+				return;
+			}
+
+			mgx::withDepth(_Depth, [&]( auto _Fixed )
+			{
+				constexpr auto FIXED = decltype(_Fixed)::value;
+				const auto D = (FIXED == 0) ? _Depth : FIXED;
+				const auto Shift = this->Shift.data();
+				const auto Scale = this->Scale.data();
+				for(auto p = u64(0); p < _Count; ++p) for(auto c = u64(0); c < D; ++c) _Out[p * D + c] = (_In[p * D + c] - I(Shift[c])) * I(Scale[c]);
+			});
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Element wise user function. Output type is what function returns.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class F> struct StageMap
+	{
+		F Fn;
+
+		template<class I> using Out = std::decay_t<std::invoke_result_t<const F&, I>>;
+
+		auto depth ( const u64 _Depth ) const -> u64 { return _Depth; }
+
+		template<class I, class O> auto apply ( const I* _In, O* _Out, const u64 _Count, const u64 _Depth ) const -> void
+		{
+			const auto N = _Count * _Depth;
+			for(auto i = u64(0); i < N; ++i) _Out[i] = this->Fn(_In[i]);
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Element types along stage chain, source type first.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class I, class... S> struct PipeChain { using type = std::tuple<I>; };
+
+	template<class I, class S0, class... S> struct PipeChain<I, S0, S...>
+	{
+		using type = decltype(std::tuple_cat(std::tuple<I>(), typename PipeChain<typename S0::template Out<I>, S...>::type()));
+	};
+
+	template<class... T> struct PipeBuffers;
+	template<class I, class... T> struct PipeBuffers<std::tuple<I, T...>> { using type = std::tuple<std::vector<T>...>; };
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Fused pipeline.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Lazy chain of per pixel stages over source view. Nothing runs until eval(), which makes one output image and walks source once.
+	// Rows run in parallel, each row goes through whole chain in chunks of PIPE_CHUNK pixels. Source must outlive pipe.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class S, class... St> class Pipe
+	{
+		using Chain = typename impl::PipeChain<S, St...>::type;
+		using Buffers = typename impl::PipeBuffers<Chain>::type;
+		static constexpr auto STAGES = sizeof...(St);
+
+		public:
+		using Output = std::tuple_element_t<STAGES, Chain>;
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		ImageView<const S> Src;
+		std::tuple<St...> Stages;
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		Pipe ( const ImageView<const S>& _Src, std::tuple<St...> _Stages ) : Src(_Src), Stages(std::move(_Stages)) {}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Append stage.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		template<class N> auto operator| ( N _Stage ) const& -> Pipe<S, St..., N>
+		{
+			return Pipe<S, St..., N>(this->Src, std::tuple_cat(this->Stages, std::tuple<N>(std::move(_Stage))));
+		}
+
+		template<class N> auto operator| ( N _Stage ) && -> Pipe<S, St..., N>
+		{
+			return Pipe<S, St..., N>(this->Src, std::tuple_cat(std::move(this->Stages), std::tuple<N>(std::move(_Stage))));
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Depth after every stage, source depth first. Throws if stage does not fit its input.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto depths ( void ) const -> std::array<u64, STAGES + 1>
+		{
+			auto Depths = std::array<u64, STAGES + 1>();
+			Depths[0] = this->Src.depth();
+			[&]<u64... K>( std::index_sequence<K...> ) { ((Depths[K + 1] = std::get<K>(this->Stages).depth(Depths[K])), ...); }(std::make_index_sequence<STAGES>());
+			return Depths;
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Run chain into _Dst. Storage is reused when dimensions match.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto into ( Image<Output>& _Dst ) const -> void
+		{
+			if((this->Src.width() == 0) || (this->Src.height() == 0)) throw Error("fx::img"s, "Pipe"s, "eval"s, ERR_EMPTY, "Image is empty."s);
+
+			const auto Depths = this->depths();
+			const auto W = this->Src.width();
+			const auto H = this->Src.height();
+			const auto RowSize = W * Depths[STAGES];
+			_Dst.reset(W, H, Depths[STAGES]);
+
+			thr::parallelFor(0, H, std::max(u64(1), u64(16384) / W), [&]( const u64 _Lo, const u64 _Hi )
+			{
+				auto Scratch = Buffers();
+				[&]<u64... K>( std::index_sequence<K...> ) { (std::get<K>(Scratch).resize(impl::PIPE_CHUNK * Depths[K + 1]), ...); }(std::make_index_sequence<STAGES>());
+
+				for(auto y = _Lo; y < _Hi; ++y)
+				{
+					const auto In = this->Src.row(y);
+					auto Out = _Dst.data() + y * RowSize;
+
+					for(auto x = u64(0); x < W; x += impl::PIPE_CHUNK)
+					{
+						const auto Count = std::min(impl::PIPE_CHUNK, W - x);
+						if constexpr(STAGES == 0) std::copy(In + x * Depths[0], In + (x + Count) * Depths[0], Out + x * Depths[0]);
+						else this->template step<0>(Scratch, Depths, In + x * Depths[0], Out + x * Depths[STAGES], Count);
+					}
+				}
+			});
+		}
+
+		auto eval ( void ) const -> Image<Output>
+		{
+			auto Result = Image<Output>();
+			this->into(Result);
+			return Result;
+		}
+
+		operator Image<Output> ( void ) const { return this->eval(); }
+
+		private:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Run stage K on chunk. Last stage writes straight into output.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		template<u64 K> auto step ( Buffers& _Scratch, const std::array<u64, STAGES + 1>& _Depths, const std::tuple_element_t<K, Chain>* _In, Output* _Out, const u64 _Count ) const -> void
+		{
+			const auto& Stage = std::get<K>(this->Stages);
+
+			if constexpr(K + 1 == STAGES) Stage.apply(_In, _Out, _Count, _Depths[K]);
+			else
+			{
+				auto Mid = std::get<K>(_Scratch).data();
+				Stage.apply(_In, Mid, _Count, _Depths[K]);
+				this->template step<K + 1>(_Scratch, _Depths, Mid, _Out, _Count);
+			}
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Start pipeline.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto pipe ( const ImageView<const T>& _Src ) -> Pipe<T> { return Pipe<T>(_Src, std::tuple<>()); }
+	template<class T> auto pipe ( const Image<T>& _Src ) -> Pipe<T> { return Pipe<T>(_Src.view(), std::tuple<>()); }
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Pipeline stages.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<int... MAP> auto remap ( void ) -> impl::StageRemap<MAP...>
+	{
+		static_assert(sizeof...(MAP) > 0, "fx::img::remap | Map is empty.");
+		return impl::StageRemap<MAP...>();
+	}
+
+	inline auto flatten ( const OpFlatten _Op, const Transfer _Transfer = Transfer::NONE ) -> impl::StageFlatten { return impl::StageFlatten{ _Op, _Transfer }; }
+	inline auto fatten ( const u64 _Depth ) -> impl::StageFatten { return impl::StageFatten{ _Depth }; }
+	inline auto toFloat ( void ) -> impl::StageToFloat { return impl::StageToFloat(); }
+	inline auto toByte ( void ) -> impl::StageToByte { return impl::StageToByte(); }
+	inline auto normalize ( const r32 _Mean, const r32 _Std ) -> impl::StageNormalize { return impl::StageNormalize({ _Mean }, { _Std }); }
+	inline auto normalize ( std::vector<r32> _Mean, const std::vector<r32>& _Std ) -> impl::StageNormalize { return impl::StageNormalize(std::move(_Mean), _Std); }
+	template<class F> auto map ( F&& _Fn ) -> impl::StageMap<std::decay_t<F>> { return impl::StageMap<std::decay_t<F>>{ std::forward<F>(_Fn) }; }
+}
@@ -0,0 +1,237 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include "./Error.hpp"
+#include "./Image.hpp"
+#include "./Threads.hpp"
+#include "./magic.hpp"
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Image downsampling.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Downsample filters. BOX averages 2x2 blocks. GAUSSIAN uses separable 5 tap [1 4 6 4 1] / 16 binomial kernel.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	enum struct OpDownsample { BOX, GAUSSIAN };
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Size of half resolution image. Odd sizes round up, so last column and row are kept.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr inline auto halfSize ( const u64 _Size ) -> u64 { return (_Size + 1) / 2; }
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Halve _Src into _Dst. _Dst must be halfSize() of _Src in both directions, same depth. Rows run in parallel.
+	// Integer types accumulate in wider integers and round to nearest, edges are clamped.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto downsample ( const ImageView<const mgx::identity_t<T>>& _Src, const ImageView<T>& _Dst, const OpDownsample _Op = OpDownsample::BOX ) -> void
+	{
+		static_assert(std::is_arithmetic_v<T>, "fx::img::downsample | Type not implemented.");
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "downsample"s, ERR_EMPTY, "Image is empty."s);
+		if((_Dst.width() != halfSize(_Src.width())) || (_Dst.height() != halfSize(_Src.height())) || (_Dst.depth() != _Src.depth()))
+		{
+			throw Error("fx::img"s, ""s, "downsample"s, ERR_INCONSISTENT_DIM, "Destination must be half of source."s);
+		}
+
+		// u8 sums stay below 65536 for both filters, so 16 bit lanes are enough and twice as many fit in vector register.
+		using Wide = std::conditional_t<std::is_signed_v<T>, i64, u64>;
+		using Acc = std::conditional_t<std::is_floating_point_v<T>, T, std::conditional_t<std::is_same_v<T, u8>, u16, Wide>>;
+
+		const auto D = _Src.depth();
+		const auto SrcW = _Src.width();
+		const auto SrcH = _Src.height();
+		const auto SrcRow = SrcW * D;
+		const auto DstRow = _Dst.width() * D;
+		const auto Grain = std::max(u64(1), u64(16384) / std::max(u64(1), DstRow));
+
+		if(_Op == OpDownsample::BOX)
+		{
+			thr::parallelFor(0, _Dst.height(), Grain, [&]( const u64 _Lo, const u64 _Hi )
+			{
+				auto Column = std::vector<Acc>(SrcRow + D);
+
+				for(auto y = _Lo; y < _Hi; ++y)
+				{
+					const auto R0 = _Src.row(std::min(2*y, SrcH - 1));
+					const auto R1 = _Src.row(std::min(2*y + 1, SrcH - 1));
+					for(auto i = u64(0); i < SrcRow; ++i) Column[i] = Acc(R0[i]) + Acc(R1[i]);
+
+					// Odd width: repeat last column, so every output pixel has both neighbours.
+					for(auto c = u64(0); c < D; ++c) Column[SrcRow + c] = Column[SrcRow - D + c];
+
+					mgx::withDepth(D, [&]( auto _Depth )
+					{
+						constexpr auto FIXED = decltype(_Depth)::value;
+						const auto Dc = (FIXED == 0) ? D : FIXED;
+						auto Out = _Dst.row(y);
+						const auto Col = Column.data();
+
+						for(auto x = u64(0); x < _Dst.width(); ++x)
+						{
+							for(auto c = u64(0); c < Dc; ++c)
+							{
+								const auto Sum = Col[2*x*Dc + c] + Col[(2*x + 1)*Dc + c];
+								if constexpr(std::is_floating_point_v<T>) Out[x*Dc + c] = Sum * T(0.25);
+								else Out[x*Dc + c] = T((Sum + Acc(2)) >> 2);
+							}
+						}
+					});
+				}
+			});
+		}
+
+		else if(_Op == OpDownsample::GAUSSIAN)
+		{
+			const auto SrcHi = i64(SrcH);
+
+			thr::parallelFor(0, _Dst.height(), Grain, [&]( const u64 _Lo, const u64 _Hi )
+			{
+				// Two clamped columns on each side, plus one more on right for odd width.
+				auto Padded = std::vector<Acc>(SrcRow + 5*D);
+
+				for(auto y = _Lo; y < _Hi; ++y)
+				{
+					const auto Cy = i64(2*y);
+					const auto R0 = _Src.row(u64(std::clamp(Cy - 2, i64(0), SrcHi - 1)));
+					const auto R1 = _Src.row(u64(std::clamp(Cy - 1, i64(0), SrcHi - 1)));
+					const auto R2 = _Src.row(u64(std::clamp(Cy, i64(0), SrcHi - 1)));
+					const auto R3 = _Src.row(u64(std::clamp(Cy + 1, i64(0), SrcHi - 1)));
+					const auto R4 = _Src.row(u64(std::clamp(Cy + 2, i64(0), SrcHi - 1)));
+
+					// Vertical taps over full row first, this loop is plain element wise and vectorizes.
+					auto Column = Padded.data() + 2*D;
+					for(auto i = u64(0); i < SrcRow; ++i) Column[i] = Acc(R0[i]) + Acc(4)*(Acc(R1[i]) + Acc(R3[i])) + Acc(6)*Acc(R2[i]) + Acc(R4[i]);
+
+					for(auto c = u64(0); c < D; ++c)
+					{
+						Padded[c] = Padded[D + c] = Column[c];
+						Column[SrcRow + c] = Column[SrcRow + D + c] = Column[SrcRow + 2*D + c] = Column[SrcRow - D + c];
+					}
+
+					mgx::withDepth(D, [&]( auto _Depth )
+					{
+						constexpr auto FIXED = decltype(_Depth)::value;
+						const auto Dc = (FIXED == 0) ? D : FIXED;
+						auto Out = _Dst.row(y);
+						const auto Col = Padded.data();
+
+						for(auto x = u64(0); x < _Dst.width(); ++x)
+						{
+							const auto P = Col + 2*x*Dc;
+
+							for(auto c = u64(0); c < Dc; ++c)
+							{
+								const auto Sum = P[c] + Acc(4)*(P[Dc + c] + P[3*Dc + c]) + Acc(6)*P[2*Dc + c] + P[4*Dc + c];
+								if constexpr(std::is_floating_point_v<T>) Out[x*Dc + c] = Sum * T(1.0 / 256.0);
+								else Out[x*Dc + c] = T((Sum + Acc(128)) >> 8);
+							}
+						}
+					});
+				}
+			});
+		}
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Halve image.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto downsample ( const Image<T>& _Src, const OpDownsample _Op = OpDownsample::BOX ) -> Image<T>
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "downsample"s, ERR_EMPTY, "Image is empty."s);
+
+		auto NewImage = Image<T>(halfSize(_Src.width()), halfSize(_Src.height()), _Src.depth());
+		downsample(_Src.view(), NewImage.view(), _Op);
+
+		return NewImage;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Image pyramid.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Mipmap / Gaussian pyramid. Level 0 is copy of source, every next level is half of previous one.
+	// All levels live in one allocation, so rebuilding pyramid of same size does not allocate.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> class Pyramid
+	{
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		std::vector<T> Data;
+		std::vector<u64> Offsets;
+		std::vector<u64> Widths;
+		std::vector<u64> Heights;
+		u64 Depth;
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors. Zero levels means go down to 1x1.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		Pyramid ( void ) : Data(), Offsets(), Widths(), Heights(), Depth(0) {}
+		Pyramid ( const Image<T>& _Src, const u64 _Levels = 0, const OpDownsample _Op = OpDownsample::BOX ) : Pyramid() { this->build(_Src, _Levels, _Op); }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Trivial.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		inline auto isEmpty ( void ) const -> bool { return this->Offsets.empty(); }
+		inline auto levels ( void ) const -> u64 { return this->Offsets.size(); }
+		inline auto depth ( void ) const -> u64 { return this->Depth; }
+		inline auto width ( const u64 _Level ) const -> u64 { return this->Widths[_Level]; }
+		inline auto height ( const u64 _Level ) const -> u64 { return this->Heights[_Level]; }
+		inline auto sizeInBytes ( void ) const -> u64 { return this->Data.size() * sizeof(T); }
+		inline auto level ( const u64 _Level ) -> ImageView<T> { return ImageView<T>(this->Data.data() + this->Offsets[_Level], this->Widths[_Level], this->Heights[_Level], this->Depth); }
+		inline auto level ( const u64 _Level ) const -> ImageView<const T> { return ImageView<const T>(this->Data.data() + this->Offsets[_Level], this->Widths[_Level], this->Heights[_Level], this->Depth); }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Build levels from source. Each level is filtered from previous one, not from full resolution.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto build ( const Image<T>& _Src, const u64 _Levels = 0, const OpDownsample _Op = OpDownsample::BOX ) -> void
+		{
+			if(_Src.isEmpty()) throw Error("fx::img"s, "Pyramid<T>"s, "build"s, ERR_EMPTY, "Image is empty."s);
+
+			this->Offsets.clear();
+			this->Widths.clear();
+			this->Heights.clear();
+			this->Depth = _Src.depth();
+
+			auto Width = _Src.width();
+			auto Height = _Src.height();
+			auto Total = u64(0);
+
+			while(true)
+			{
+				this->Offsets.push_back(Total);
+				this->Widths.push_back(Width);
+				this->Heights.push_back(Height);
+				Total += Width * Height * this->Depth;
+
+				if((_Levels != 0) && (this->Offsets.size() == _Levels)) break;
+				if((Width == 1) && (Height == 1)) break;
+
+				Width = halfSize(Width);
+				Height = halfSize(Height);
+			}
+
+			this->Data.resize(Total);
+			std::copy(_Src.data(), _Src.data() + _Src.size(), this->Data.begin());
+
+			for(auto L = u64(1); L < this->levels(); ++L)
+			{
+				downsample<T>(this->level(L - 1), this->level(L), _Op);
+			}
+		}
+	};
+}
@@ -0,0 +1,278 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include "./Error.hpp"
+#include "./Image.hpp"
+#include "./ImageFilter.hpp"
+#include "./ImagePyramid.hpp"
+#include "./Threads.hpp"
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Image quality.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Score of every channel and their mean.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	struct QualityScore
+	{
+		std::vector<r64> Channels;
+		r64 Mean;
+	};
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Image quality internals.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img::impl
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// SSIM window and constants (Z. Wang et al.): 11 tap Gaussian of sigma 1.5, K1 = 0.01, K2 = 0.03 of dynamic range.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr auto SSIM_SIGMA = 1.5;
+	constexpr auto SSIM_RADIUS = u64(5);
+	constexpr auto SSIM_C1 = r32(0.01 * 0.01);
+	constexpr auto SSIM_C2 = r32(0.03 * 0.03);
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// MS-SSIM scale weights, finest first.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr auto MSSSIM_WEIGHTS = std::array<r64, 5>{ 0.0448, 0.2856, 0.3001, 0.2363, 0.1333 };
+
+	template<class T> auto checkPair ( const Image<T>& _A, const Image<T>& _B, const str& _Func ) -> void
+	{
+		if(_A.isEmpty() || _B.isEmpty()) throw Error("fx::img"s, ""s, _Func, ERR_EMPTY, "Image is empty."s);
+		if((_A.width() != _B.width()) || (_A.height() != _B.height()) || (_A.depth() != _B.depth())) throw Error("fx::img"s, ""s, _Func, ERR_INCONSISTENT_DIM, "Inconsistent dimensions."s);
+	}
+
+	inline auto score ( std::vector<r64> _Channels ) -> QualityScore
+	{
+		auto Sum = 0.0;
+		for(auto V : _Channels) Sum += V;
+		const auto Mean = Sum / r64(_Channels.size());
+		return QualityScore{ std::move(_Channels), Mean };
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Per channel mean SSIM and mean contrast-structure term of two images in [0, 1]. All five moments come from one separable pass: horizontal pass filters
+	// a, b, a^2, b^2 and ab of each source row into stripe buffer, vertical pass combines them and folds SSIM map straight into per row sums.
+	// Map is averaged over pixels whose window lies inside image. Images smaller than window use reflected border and average everything.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto ssimTerms ( const Image<r32>& _A, const Image<r32>& _B ) -> std::pair<std::vector<r64>, std::vector<r64>>
+	{
+		const auto W = _A.width();
+		const auto H = _A.height();
+		const auto D = _A.depth();
+		const auto RowSize = W * D;
+		const auto K = kernelGaussian(SSIM_SIGMA, SSIM_RADIUS);
+		const auto R = K.radius();
+
+		const auto Valid = (W > 2 * R) && (H > 2 * R);
+		const auto X0 = Valid ? R : u64(0);
+		const auto X1 = Valid ? W - R : W;
+		const auto Y0 = Valid ? R : u64(0);
+		const auto Y1 = Valid ? H - R : H;
+
+		auto RowSsim = std::vector<r64>(H * D, 0.0);
+		auto RowCs = std::vector<r64>(H * D, 0.0);
+
+		runStripes<r32>(W, H, 5 * D, R, Border::REFLECT,
+			[&]( const u64 _Y, r32* _Out )
+			{
+				const auto Padded = (W + 2 * R) * D;
+				thread_local auto Products = std::vector<r32>();
+				Products.resize(5 * Padded);
+
+				auto Pa = Products.data();
+				auto Pb = Pa + Padded;
+				auto Paa = Pb + Padded;
+				auto Pbb = Paa + Padded;
+				auto Pab = Pbb + Padded;
+				padRow(_A.data() + _Y * RowSize, W, D, R, Border::REFLECT, Pa);
+				padRow(_B.data() + _Y * RowSize, W, D, R, Border::REFLECT, Pb);
+				for(auto i = u64(0); i < Padded; ++i)
+				{
+					Paa[i] = Pa[i] * Pa[i];
+					Pbb[i] = Pb[i] * Pb[i];
+					Pab[i] = Pa[i] * Pb[i];
+				}
+
+				std::fill(_Out, _Out + 5 * RowSize, 0.0f);
+				for(auto p = u64(0); p < 5; ++p)
+				{
+					auto Out = _Out + p * RowSize;
+					for(auto k = u64(0); k < K.size(); ++k)
+					{
+						const auto Tap = K.Taps[k];
+						const auto In = Products.data() + p * Padded + k * D;
+						for(auto i = u64(0); i < RowSize; ++i) Out[i] += Tap * In[i];
+					}
+				}
+			},
+			[&]( const r32* const* _Rows, const u64 _Y )
+			{
+				thread_local auto Moments = std::vector<r32>();
+				Moments.assign(5 * RowSize, 0.0f);
+
+				for(auto k = u64(0); k < K.size(); ++k)
+				{
+					const auto Tap = K.Taps[k];
+					const auto In = _Rows[k];
+					for(auto i = u64(0); i < 5 * RowSize; ++i) Moments[i] += Tap * In[i];
+				}
+
+				if((_Y < Y0) || (_Y >= Y1)) return;
+
+				const auto Ma = Moments.data();
+				const auto Mb = Ma + RowSize;
+				const auto Saa = Mb + RowSize;
+				const auto Sbb = Saa + RowSize;
+				const auto Sab = Sbb + RowSize;
+
+				for(auto x = X0; x < X1; ++x)
+				{
+					for(auto c = u64(0); c < D; ++c)
+					{
+						const auto i = x * D + c;
+						const auto VarA = Saa[i] - Ma[i] * Ma[i];
+						const auto VarB = Sbb[i] - Mb[i] * Mb[i];
+						const auto Cov = Sab[i] - Ma[i] * Mb[i];
+						const auto Cs = (2.0f * Cov + SSIM_C2) / (VarA + VarB + SSIM_C2);
+						const auto Lum = (2.0f * Ma[i] * Mb[i] + SSIM_C1) / (Ma[i] * Ma[i] + Mb[i] * Mb[i] + SSIM_C1);
+
+						RowSsim[_Y * D + c] += r64(Lum * Cs);
+						RowCs[_Y * D + c] += r64(Cs);
+					}
+				}
+			});
+
+		const auto Count = r64((X1 - X0) * (Y1 - Y0));
+		auto Ssim = std::vector<r64>(D, 0.0);
+		auto Cs = std::vector<r64>(D, 0.0);
+		for(auto y = Y0; y < Y1; ++y)
+		{
+			for(auto c = u64(0); c < D; ++c)
+			{
+				Ssim[c] += RowSsim[y * D + c];
+				Cs[c] += RowCs[y * D + c];
+			}
+		}
+		for(auto c = u64(0); c < D; ++c) { Ssim[c] /= Count; Cs[c] /= Count; }
+
+		return { Ssim, Cs };
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Image in [0, 1] as r32. u8 conversion already normalizes.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto unitImage ( const Image<T>& _Src ) -> Image<r32>
+	{
+		static_assert(std::is_same_v<T, u8> || std::is_same_v<T, r32>, "fx::img::quality | Type not implemented.");
+		return Image<r32>(_Src);
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Image quality.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Peak signal to noise ratio in dB, per channel. Peak is 255 for u8 and 1 for r32. Identical channels score infinity. u8 errors are summed exactly.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto psnr ( const Image<T>& _A, const Image<T>& _B ) -> QualityScore
+	{
+		static_assert(std::is_same_v<T, u8> || std::is_same_v<T, r32>, "fx::img::psnr | Type not implemented.");
+		impl::checkPair(_A, _B, "psnr"s);
+
+		using Acc = std::conditional_t<std::is_same_v<T, u8>, u64, r64>;
+		const auto W = _A.width();
+		const auto D = _A.depth();
+		const auto Peak = std::is_same_v<T, u8> ? 255.0 : 1.0;
+
+		auto Total = std::vector<Acc>(D, Acc(0));
+		auto Lock = std::mutex();
+
+		thr::parallelFor(0, _A.height(), std::max(u64(1), u64(65536) / (W * D)), [&]( const u64 _Lo, const u64 _Hi )
+		{
+			auto Local = std::vector<Acc>(D, Acc(0));
+			auto Row = std::vector<Acc>(W * D);
+
+			for(auto y = _Lo; y < _Hi; ++y)
+			{
+				const auto A = _A.data() + y * W * D;
+				const auto B = _B.data() + y * W * D;
+
+				if constexpr(std::is_same_v<T, u8>) for(auto i = u64(0); i < W * D; ++i) { const auto Diff = i32(A[i]) - i32(B[i]); Row[i] = Acc(Diff * Diff); }
+				else for(auto i = u64(0); i < W * D; ++i) { const auto Diff = r64(A[i]) - r64(B[i]); Row[i] = Diff * Diff; }
+
+				for(auto x = u64(0); x < W; ++x) for(auto c = u64(0); c < D; ++c) Local[c] += Row[x * D + c];
+			}
+
+			auto Guard = std::lock_guard<std::mutex>(Lock);
+			for(auto c = u64(0); c < D; ++c) Total[c] += Local[c];
+		});
+
+		const auto Count = r64(W * _A.height());
+		auto Channels = std::vector<r64>(D);
+		for(auto c = u64(0); c < D; ++c)
+		{
+			const auto Mse = r64(Total[c]) / Count;
+			Channels[c] = (Mse == 0.0) ? std::numeric_limits<r64>::infinity() : 10.0 * std::log10(Peak * Peak / Mse);
+		}
+
+		return impl::score(std::move(Channels));
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Structural similarity, per channel mean of SSIM map. r32 images are expected in [0, 1].
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto ssim ( const Image<T>& _A, const Image<T>& _B ) -> QualityScore
+	{
+		impl::checkPair(_A, _B, "ssim"s);
+		return impl::score(impl::ssimTerms(impl::unitImage(_A), impl::unitImage(_B)).first);
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Multi-scale SSIM over five scales halved with box downsample. Contrast-structure terms of four finest scales and full SSIM of coarsest are combined
+	// with standard weights. Negative terms are clamped to zero. Scales stop early when image gets smaller than window.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto msssim ( const Image<T>& _A, const Image<T>& _B ) -> QualityScore
+	{
+		impl::checkPair(_A, _B, "msssim"s);
+
+		const auto D = _A.depth();
+		auto A = impl::unitImage(_A);
+		auto B = impl::unitImage(_B);
+		auto Channels = std::vector<r64>(D, 1.0);
+		const auto Scales = impl::MSSSIM_WEIGHTS.size();
+
+		for(auto s = u64(0); s < Scales; ++s)
+		{
+			const auto Last = (s + 1 == Scales) || (halfSize(A.width()) <= 2 * impl::SSIM_RADIUS) || (halfSize(A.height()) <= 2 * impl::SSIM_RADIUS);
+			const auto [Ssim, Cs] = impl::ssimTerms(A, B);
+
+			for(auto c = u64(0); c < D; ++c) Channels[c] *= std::pow(std::max(0.0, Last ? Ssim[c] : Cs[c]), impl::MSSSIM_WEIGHTS[s]);
+			if(Last) break;
+
+			A = downsample(A);
+			B = downsample(B);
+		}
+
+		return impl::score(std::move(Channels));
+	}
+}
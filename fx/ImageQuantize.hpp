@@ -0,0 +1,397 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include "./Error.hpp"
+#include "./Image.hpp"
+#include "./Threads.hpp"
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <mutex>
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Colour quantization.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Palette construction. MEDIAN_CUT splits colour boxes at median of their widest channel, KMEANS refines median cut palette with Lloyd iterations.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	enum struct OpPalette { MEDIAN_CUT, KMEANS };
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Error diffusion when mapping to palette.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	enum struct Dither { NONE, FLOYD_STEINBERG };
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Indexed image. Palette is count x 1 image of same depth as source.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	struct Quantized
+	{
+		Image<u8> Indices;
+		Image<u8> Palette;
+	};
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Colour quantization internals.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img::impl
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Palette building works on at most this many pixels, sampled evenly.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr auto QUANTIZE_SAMPLES = u64(1) << 18;
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Rows per dithering strip. Error does not cross strip edges, so strips run in parallel.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr auto DITHER_STRIP = u64(32);
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Nearest palette entry by squared distance. Palette is kept channel by channel and padded to multiple of 8 with far away entries, so distance loop runs over whole
+	// vectors of entries. Recent colours are remembered in small direct mapped cache. Each thread uses its own matcher.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	class PaletteMatcher
+	{
+		struct Entry
+		{
+			u32 Key;
+			i32 Index;
+		};
+
+		static constexpr auto CACHE_BITS = 12;
+		static constexpr auto FAR = i32(1) << 12;
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		u64 Depth;
+		u64 Padded;
+		std::vector<i32> Channels;
+		std::vector<i32> Distances;
+		std::vector<Entry> Cache;
+
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		PaletteMatcher ( const u8* _Palette, const u64 _Count, const u64 _Depth ) :
+			Depth(_Depth), Padded((_Count + 7) & ~u64(7)), Channels(_Depth * Padded, FAR), Distances(Padded), Cache(u64(1) << CACHE_BITS, Entry{ 0, -1 })
+		{
+			for(auto j = u64(0); j < _Count; ++j) for(auto c = u64(0); c < _Depth; ++c) this->Channels[c * this->Padded + j] = i32(_Palette[j * _Depth + c]);
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Index of nearest entry to colour of Depth channels in 0..255.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto nearest ( const i32* _Color ) -> u8
+		{
+			auto Key = u32(0);
+			for(auto c = u64(0); c < this->Depth; ++c) Key |= u32(_Color[c]) << (8 * c);
+
+			auto& Slot = this->Cache[((Key * 2654435761u) >> (32 - CACHE_BITS))];
+			if((Slot.Index >= 0) && (Slot.Key == Key)) return u8(Slot.Index);
+
+			auto Dist = this->Distances.data();
+			std::fill(Dist, Dist + this->Padded, 0);
+			for(auto c = u64(0); c < this->Depth; ++c)
+			{
+				const auto Val = _Color[c];
+				const auto Col = this->Channels.data() + c * this->Padded;
+				for(auto j = u64(0); j < this->Padded; ++j) { const auto Diff = Val - Col[j]; Dist[j] += Diff * Diff; }
+			}
+
+			auto Best = u64(0);
+			for(auto j = u64(1); j < this->Padded; ++j) if(Dist[j] < Dist[Best]) Best = j;
+
+			Slot = Entry{ Key, i32(Best) };
+			return u8(Best);
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Evenly spaced pixel sample, at most QUANTIZE_SAMPLES pixels, 4 bytes each.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto samplePixels ( const Image<u8>& _Src ) -> std::vector<std::array<u8, 4>>
+	{
+		const auto D = _Src.depth();
+		const auto Pixels = _Src.width() * _Src.height();
+		const auto Step = (Pixels + QUANTIZE_SAMPLES - 1) / QUANTIZE_SAMPLES;
+
+		auto Samples = std::vector<std::array<u8, 4>>();
+		Samples.reserve(Pixels / Step + 1);
+		for(auto p = u64(0); p < Pixels; p += Step)
+		{
+			auto Color = std::array<u8, 4>{ 0, 0, 0, 0 };
+			for(auto c = u64(0); c < D; ++c) Color[c] = _Src[p * D + c];
+			Samples.push_back(Color);
+		}
+
+		return Samples;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Median cut. Box with widest channel is split at median of that channel until _Count boxes exist or no box holds two distinct colours. Entries are box means.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto medianCut ( std::vector<std::array<u8, 4>>& _Samples, const u64 _Depth, const u64 _Count ) -> std::vector<u8>
+	{
+		struct Box
+		{
+			u64 Begin;
+			u64 End;
+			u64 Channel;
+			u32 Range;
+		};
+
+		const auto Measure = [&]( const u64 _Begin, const u64 _End ) -> Box
+		{
+			auto Lo = std::array<u8, 4>{ 255, 255, 255, 255 };
+			auto Hi = std::array<u8, 4>{ 0, 0, 0, 0 };
+			for(auto i = _Begin; i < _End; ++i) for(auto c = u64(0); c < _Depth; ++c) { Lo[c] = std::min(Lo[c], _Samples[i][c]); Hi[c] = std::max(Hi[c], _Samples[i][c]); }
+
+			auto Result = Box{ _Begin, _End, 0, 0 };
+			for(auto c = u64(0); c < _Depth; ++c) if(u32(Hi[c] - Lo[c]) > Result.Range) { Result.Range = u32(Hi[c] - Lo[c]); Result.Channel = c; }
+			return Result;
+		};
+
+		auto Boxes = std::vector<Box>{ Measure(0, _Samples.size()) };
+
+		while(Boxes.size() < _Count)
+		{
+			auto Pick = Boxes.end();
+			for(auto It = Boxes.begin(); It != Boxes.end(); ++It) if((It->Range > 0) && ((Pick == Boxes.end()) || (It->Range > Pick->Range))) Pick = It;
+			if(Pick == Boxes.end()) break;
+
+			const auto Split = *Pick;
+			const auto Mid = Split.Begin + (Split.End - Split.Begin) / 2;
+			const auto Channel = Split.Channel;
+			std::nth_element(_Samples.begin() + Split.Begin, _Samples.begin() + Mid, _Samples.begin() + Split.End, [&]( const auto& _A, const auto& _B ){ return _A[Channel] < _B[Channel]; });
+
+			*Pick = Measure(Split.Begin, Mid);
+			Boxes.push_back(Measure(Mid, Split.End));
+		}
+
+		auto Palette = std::vector<u8>(Boxes.size() * _Depth);
+		for(auto b = u64(0); b < Boxes.size(); ++b)
+		{
+			const auto N = Boxes[b].End - Boxes[b].Begin;
+			for(auto c = u64(0); c < _Depth; ++c)
+			{
+				auto Sum = u64(0);
+				for(auto i = Boxes[b].Begin; i < Boxes[b].End; ++i) Sum += _Samples[i][c];
+				Palette[b * _Depth + c] = u8((Sum + N / 2) / N);
+			}
+		}
+
+		return Palette;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Lloyd iterations. Assignment runs over sample chunks in parallel, chunk sums are merged under lock. Empty clusters keep their colour.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto kmeans ( const std::vector<std::array<u8, 4>>& _Samples, const u64 _Depth, std::vector<u8> _Palette, const u64 _Iterations ) -> std::vector<u8>
+	{
+		const auto K = _Palette.size() / _Depth;
+
+		for(auto Iter = u64(0); Iter < _Iterations; ++Iter)
+		{
+			auto Sums = std::vector<u64>(K * _Depth, 0);
+			auto Counts = std::vector<u64>(K, 0);
+			auto Lock = std::mutex();
+
+			thr::parallelFor(0, _Samples.size(), 8192, [&]( const u64 _Lo, const u64 _Hi )
+			{
+				auto Matcher = PaletteMatcher(_Palette.data(), K, _Depth);
+				auto LocalSums = std::vector<u64>(K * _Depth, 0);
+				auto LocalCounts = std::vector<u64>(K, 0);
+				auto Color = std::array<i32, 4>();
+
+				for(auto i = _Lo; i < _Hi; ++i)
+				{
+					for(auto c = u64(0); c < _Depth; ++c) Color[c] = _Samples[i][c];
+					const auto Best = Matcher.nearest(Color.data());
+					++LocalCounts[Best];
+					for(auto c = u64(0); c < _Depth; ++c) LocalSums[Best * _Depth + c] += _Samples[i][c];
+				}
+
+				auto Guard = std::lock_guard<std::mutex>(Lock);
+				for(auto i = u64(0); i < Sums.size(); ++i) Sums[i] += LocalSums[i];
+				for(auto i = u64(0); i < K; ++i) Counts[i] += LocalCounts[i];
+			});
+
+			auto Changed = false;
+			for(auto k = u64(0); k < K; ++k)
+			{
+				if(Counts[k] == 0) continue;
+				for(auto c = u64(0); c < _Depth; ++c)
+				{
+					const auto Val = u8((Sums[k * _Depth + c] + Counts[k] / 2) / Counts[k]);
+					Changed |= (Val != _Palette[k * _Depth + c]);
+					_Palette[k * _Depth + c] = Val;
+				}
+			}
+
+			if(!Changed) break;
+		}
+
+		return _Palette;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Colour quantization.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Build palette of at most _Count colours, 1 to 256. Images with fewer distinct colours get smaller palette. Depth 1 to 4.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto palette ( const Image<u8>& _Src, const u64 _Count, const OpPalette _Op = OpPalette::KMEANS, const u64 _Iterations = 8 ) -> Image<u8>
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "palette"s, ERR_EMPTY, "Image is empty."s);
+		if((_Src.depth() == 0) || (_Src.depth() > 4)) throw Error("fx::img"s, ""s, "palette"s, ERR_BAD_ARGS, "Depth must be 1 to 4."s);
+		if((_Count == 0) || (_Count > 256)) throw Error("fx::img"s, ""s, "palette"s, ERR_BAD_ARGS, "Palette must have 1 to 256 colours."s);
+
+		const auto D = _Src.depth();
+		auto Samples = impl::samplePixels(_Src);
+		auto Colors = impl::medianCut(Samples, D, _Count);
+		if(_Op == OpPalette::KMEANS) Colors = impl::kmeans(Samples, D, std::move(Colors), _Iterations);
+
+		auto Result = Image<u8>(Colors.size() / D, 1, D);
+		std::copy(Colors.begin(), Colors.end(), Result.data());
+		return Result;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Index of nearest palette colour for every pixel. Without dithering rows run in parallel. Floyd-Steinberg diffuses error inside strips of rows,
+	// strips run in parallel.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto mapToPalette ( const Image<u8>& _Src, const Image<u8>& _Palette, const Dither _Dither = Dither::NONE ) -> Image<u8>
+	{
+		if(_Src.isEmpty() || _Palette.isEmpty()) throw Error("fx::img"s, ""s, "mapToPalette"s, ERR_EMPTY, "Image is empty."s);
+		if(_Src.depth() != _Palette.depth()) throw Error("fx::img"s, ""s, "mapToPalette"s, ERR_INCONSISTENT_DIM, "Inconsistent dimensions."s);
+		if((_Src.depth() > 4) || (_Palette.height() != 1) || (_Palette.width() > 256)) throw Error("fx::img"s, ""s, "mapToPalette"s, ERR_BAD_ARGS, "Palette must be 1 to 256 colours of depth 1 to 4."s);
+
+		const auto W = _Src.width();
+		const auto H = _Src.height();
+		const auto D = _Src.depth();
+		const auto K = _Palette.width();
+
+		auto Indices = Image<u8>(W, H, 1);
+
+		if(_Dither == Dither::NONE)
+		{
+			thr::parallelFor(0, H, std::max(u64(1), u64(16384) / W), [&]( const u64 _Lo, const u64 _Hi )
+			{
+				auto Matcher = impl::PaletteMatcher(_Palette.data(), K, D);
+				auto Color = std::array<i32, 4>();
+
+				for(auto y = _Lo; y < _Hi; ++y)
+				{
+					const auto In = _Src.data() + y * W * D;
+					auto Out = Indices.data() + y * W;
+					for(auto x = u64(0); x < W; ++x)
+					{
+						for(auto c = u64(0); c < D; ++c) Color[c] = In[x * D + c];
+						Out[x] = Matcher.nearest(Color.data());
+					}
+				}
+			});
+
+			return Indices;
+		}
+
+		const auto Strips = (H + impl::DITHER_STRIP - 1) / impl::DITHER_STRIP;
+
+		thr::parallelFor(0, Strips, 1, [&]( const u64 _Lo, const u64 _Hi )
+		{
+			auto Matcher = impl::PaletteMatcher(_Palette.data(), K, D);
+			auto Color = std::array<i32, 4>();
+
+			// Errors scaled by 16, one pixel of padding on both sides.
+			auto Current = std::vector<i32>((W + 2) * D);
+			auto Next = std::vector<i32>((W + 2) * D);
+
+			for(auto S = _Lo; S < _Hi; ++S)
+			{
+				const auto Y0 = S * impl::DITHER_STRIP;
+				const auto Y1 = std::min(H, Y0 + impl::DITHER_STRIP);
+				std::fill(Current.begin(), Current.end(), 0);
+
+				for(auto y = Y0; y < Y1; ++y)
+				{
+					std::fill(Next.begin(), Next.end(), 0);
+					const auto In = _Src.data() + y * W * D;
+					auto Out = Indices.data() + y * W;
+
+					for(auto x = u64(0); x < W; ++x)
+					{
+						const auto E = (x + 1) * D;
+						// Arithmetic shift floors, so +8 rounds to nearest the same way for both signs. Division would round negative errors toward zero.
+						for(auto c = u64(0); c < D; ++c) Color[c] = std::clamp(i32(In[x * D + c]) + ((Current[E + c] + 8) >> 4), 0, 255);
+
+						const auto Best = Matcher.nearest(Color.data());
+						Out[x] = Best;
+
+						for(auto c = u64(0); c < D; ++c)
+						{
+							const auto Err = Color[c] - i32(_Palette[Best * D + c]);
+							Current[E + D + c] += Err * 7;
+							Next[E - D + c] += Err * 3;
+							Next[E + c] += Err * 5;
+							Next[E + D + c] += Err;
+						}
+					}
+
+					std::swap(Current, Next);
+				}
+			}
+		});
+
+		return Indices;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Reduce image to _Count colours.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto quantize ( const Image<u8>& _Src, const u64 _Count, const OpPalette _Op = OpPalette::KMEANS, const Dither _Dither = Dither::NONE ) -> Quantized
+	{
+		auto Palette = palette(_Src, _Count, _Op);
+		auto Indices = mapToPalette(_Src, Palette, _Dither);
+		return Quantized{ std::move(Indices), std::move(Palette) };
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Expand indexed image back to colours.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto applyPalette ( const Image<u8>& _Indices, const Image<u8>& _Palette ) -> Image<u8>
+	{
+		if(_Indices.isEmpty() || _Palette.isEmpty()) throw Error("fx::img"s, ""s, "applyPalette"s, ERR_EMPTY, "Image is empty."s);
+		if(_Indices.depth() != 1) throw Error("fx::img"s, ""s, "applyPalette"s, ERR_NOT_FLAT, "Image is not flat."s);
+
+		const auto D = _Palette.depth();
+		const auto K = _Palette.size() / D;
+		auto NewImage = Image<u8>(_Indices.width(), _Indices.height(), D);
+
+		thr::parallelFor(0, _Indices.size(), 65536, [&]( const u64 _Lo, const u64 _Hi )
+		{
+			for(auto i = _Lo; i < _Hi; ++i)
+			{
+				const auto Index = std::min(u64(_Indices[i]), K - 1);
+				for(auto c = u64(0); c < D; ++c) NewImage[i * D + c] = _Palette[Index * D + c];
+			}
+		});
+
+		return NewImage;
+	}
+}
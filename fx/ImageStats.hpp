@@ -0,0 +1,273 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include "./Error.hpp"
+#include "./Image.hpp"
+#include "./Threads.hpp"
+#include "./magic.hpp"
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <cmath>
+#include <type_traits>
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Image statistics.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Statistics of one channel. Variance is population variance.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> struct ChannelStats
+	{
+		T Min;
+		T Max;
+		r64 Mean;
+		r64 Variance;
+		std::vector<u64> Histogram;
+
+		inline auto stddev ( void ) const -> r64 { return std::sqrt(this->Variance); }
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Statistics of whole image. Histogram bin i covers [Low + i * (High - Low) / bins, Low + (i + 1) * (High - Low) / bins), values outside go to end bins.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> struct ImageStats
+	{
+		u64 Count;
+		r64 Low;
+		r64 High;
+		std::vector<ChannelStats<T>> Channels;
+	};
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Image statistics internals.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img::impl
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Partial result of one chunk of rows. Keeps mean and sum of squared deviations, merged with Chan's formula.
+	// Rows are summed relative to their first pixel (shifted data), so E[x^2] - E[x]^2 never cancels against large mean.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> struct StatsPartial
+	{
+		u64 Count = 0;
+		std::vector<T> Min;
+		std::vector<T> Max;
+		std::vector<r64> Shift;
+		std::vector<r64> Sums;
+		std::vector<r64> SumsSqr;
+		std::vector<r64> Means;
+		std::vector<r64> M2;
+		std::vector<u64> Histogram;
+
+		StatsPartial ( const u64 _Depth, const u64 _Bins ) :
+			Min(_Depth, std::numeric_limits<T>::max()), Max(_Depth, std::numeric_limits<T>::lowest()), Shift(_Depth, 0.0), Sums(_Depth, 0.0), SumsSqr(_Depth, 0.0),
+			Means(_Depth, 0.0), M2(_Depth, 0.0), Histogram(_Depth * _Bins, 0) {}
+
+		// Fold shifted sums of _Count values into mean / M2.
+		auto flush ( const u64 _Count ) -> void
+		{
+			const auto N = r64(_Count);
+			if(N == 0) return;
+
+			for(auto c = u64(0); c < this->Means.size(); ++c)
+			{
+				const auto Mean = this->Shift[c] + this->Sums[c] / N;
+				const auto M2 = std::max(0.0, this->SumsSqr[c] - this->Sums[c] * this->Sums[c] / N);
+				merge(this->Means[c], this->M2[c], r64(this->Count), Mean, M2, N);
+				this->Sums[c] = 0;
+				this->SumsSqr[c] = 0;
+			}
+
+			this->Count += _Count;
+		}
+
+		static auto merge ( r64& _Mean, r64& _M2, const r64 _N, const r64 _OtherMean, const r64 _OtherM2, const r64 _OtherN ) -> void
+		{
+			const auto N = _N + _OtherN;
+			if(N == 0) return;
+
+			const auto Delta = _OtherMean - _Mean;
+			_Mean += Delta * _OtherN / N;
+			_M2 += _OtherM2 + Delta * Delta * _N * _OtherN / N;
+		}
+	};
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Image statistics.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Histogram, min / max, mean and variance of every channel in one pass. Chunks of rows run in parallel with private histograms, merged at end.
+	// u8 always uses 256 bins, one per value, and counts into four interleaved sub-histograms to break store-to-load chains on runs of equal pixels.
+	// Other types bin [_Low, _High) into _Bins bins. Equal _Low and _High pick full range of integer types and [0, 1] for floats.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto stats ( const ImageView<const T>& _Src, const u64 _Bins = 256, const r64 _Low = 0.0, const r64 _High = 0.0 ) -> ImageStats<std::remove_const_t<T>>
+	{
+		using V = std::remove_const_t<T>;
+		using Partial = impl::StatsPartial<V>;
+		static_assert(std::is_arithmetic_v<V>, "fx::img::stats | Type not implemented.");
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "stats"s, ERR_EMPTY, "Image is empty."s);
+		if(_Bins == 0) throw Error("fx::img"s, ""s, "stats"s, ERR_BAD_ARGS, "Histogram needs at least one bin."s);
+
+		constexpr auto BYTE = std::is_same_v<V, u8>;
+		const auto Bins = BYTE ? u64(256) : _Bins;
+		auto Low = BYTE ? 0.0 : _Low;
+		auto High = BYTE ? 256.0 : _High;
+		if(Low == High)
+		{
+			if constexpr(std::is_floating_point_v<V>) { Low = 0.0; High = 1.0; }
+			else { Low = r64(std::numeric_limits<V>::lowest()); High = r64(std::numeric_limits<V>::max()) + 1.0; }
+		}
+		if(High < Low) throw Error("fx::img"s, ""s, "stats"s, ERR_BAD_ARGS, "Histogram range is inverted."s);
+
+		const auto W = _Src.width();
+		const auto D = _Src.depth();
+		const auto BinScale = r64(Bins) / (High - Low);
+		const auto LastBin = r64(Bins - 1);
+
+		auto Total = Partial(D, Bins);
+		auto TotalLock = std::mutex();
+
+		thr::parallelFor(0, _Src.height(), std::max(u64(1), u64(65536) / (W * D)), [&]( const u64 _Lo, const u64 _Hi )
+		{
+			auto Local = Partial(D, Bins);
+
+			mgx::withDepth(D, [&]( auto _Depth )
+			{
+				constexpr auto FIXED = decltype(_Depth)::value;
+				const auto Dc = (FIXED == 0) ? D : FIXED;
+
+				if constexpr(BYTE)
+				{
+					auto Sub = std::vector<u32>(4 * Dc * 256, 0);
+					auto Pending = u64(0);
+
+					for(auto y = _Lo; y < _Hi; ++y)
+					{
+						// Sub-histograms are u32, flush before any bin could pass 2^32 hits, however wide rows are.
+						if(Pending + W > u64(0xFFFFFFFF))
+						{
+							for(auto i = u64(0); i < Sub.size(); ++i) Local.Histogram[i % (Dc * 256)] += Sub[i];
+							std::fill(Sub.begin(), Sub.end(), 0);
+							Pending = 0;
+						}
+
+						const auto Row = _Src.row(y);
+						auto x = u64(0);
+
+						for(; x + 4 <= W; x += 4)
+						{
+							for(auto c = u64(0); c < Dc; ++c)
+							{
+								++Sub[(0 * Dc + c) * 256 + Row[(x + 0) * Dc + c]];
+								++Sub[(1 * Dc + c) * 256 + Row[(x + 1) * Dc + c]];
+								++Sub[(2 * Dc + c) * 256 + Row[(x + 2) * Dc + c]];
+								++Sub[(3 * Dc + c) * 256 + Row[(x + 3) * Dc + c]];
+							}
+						}
+						for(; x < W; ++x) for(auto c = u64(0); c < Dc; ++c) ++Sub[c * 256 + Row[x * Dc + c]];
+
+						Pending += W;
+					}
+
+					// Min, max, mean and variance come from merged histogram at end, no second pass over pixels needed.
+					for(auto i = u64(0); i < Sub.size(); ++i) Local.Histogram[i % (Dc * 256)] += Sub[i];
+					Local.Count = (_Hi - _Lo) * W;
+				}
+
+				else
+				{
+					for(auto y = _Lo; y < _Hi; ++y)
+					{
+						const auto Row = _Src.row(y);
+
+						for(auto c = u64(0); c < Dc; ++c) Local.Shift[c] = r64(Row[c]);
+
+						for(auto x = u64(0); x < W; ++x)
+						{
+							for(auto c = u64(0); c < Dc; ++c)
+							{
+								const auto Val = Row[x * Dc + c];
+								const auto Dev = r64(Val) - Local.Shift[c];
+								Local.Min[c] = std::min(Local.Min[c], Val);
+								Local.Max[c] = std::max(Local.Max[c], Val);
+								Local.Sums[c] += Dev;
+								Local.SumsSqr[c] += Dev * Dev;
+
+								auto Bin = (r64(Val) - Low) * BinScale;
+								Bin = (Bin >= 0.0) ? std::min(Bin, LastBin) : 0.0;
+								++Local.Histogram[c * Bins + u64(Bin)];
+							}
+						}
+
+						Local.flush(W);
+					}
+				}
+			});
+
+			auto Guard = std::lock_guard<std::mutex>(TotalLock);
+
+			for(auto c = u64(0); c < D; ++c)
+			{
+				Total.Min[c] = std::min(Total.Min[c], Local.Min[c]);
+				Total.Max[c] = std::max(Total.Max[c], Local.Max[c]);
+				Partial::merge(Total.Means[c], Total.M2[c], r64(Total.Count), Local.Means[c], Local.M2[c], r64(Local.Count));
+			}
+			for(auto i = u64(0); i < Total.Histogram.size(); ++i) Total.Histogram[i] += Local.Histogram[i];
+			Total.Count += Local.Count;
+		});
+
+		auto Result = ImageStats<V>{ Total.Count, Low, High, {} };
+		const auto N = r64(Total.Count);
+
+		for(auto c = u64(0); c < D; ++c)
+		{
+			auto Channel = ChannelStats<V>{ Total.Min[c], Total.Max[c], 0.0, 0.0, std::vector<u64>(Total.Histogram.begin() + c * Bins, Total.Histogram.begin() + (c + 1) * Bins) };
+
+			if constexpr(BYTE)
+			{
+				// Exact integer mean, then squared deviations from it over 256 bins.
+				const auto H = Channel.Histogram.data();
+				auto Sum = u64(0);
+				for(auto v = u64(0); v < 256; ++v) Sum += H[v] * v;
+				Channel.Mean = r64(Sum) / N;
+
+				for(auto v = u64(0); v < 256; ++v)
+				{
+					if(H[v] == 0) continue;
+					Channel.Min = std::min(Channel.Min, u8(v));
+					Channel.Max = std::max(Channel.Max, u8(v));
+					Channel.Variance += r64(H[v]) * (r64(v) - Channel.Mean) * (r64(v) - Channel.Mean);
+				}
+				Channel.Variance /= N;
+			}
+			else
+			{
+				Channel.Mean = Total.Means[c];
+				Channel.Variance = Total.M2[c] / N;
+			}
+
+			Result.Channels.push_back(std::move(Channel));
+		}
+
+		return Result;
+	}
+
+	template<class T> auto stats ( const Image<T>& _Src, const u64 _Bins = 256, const r64 _Low = 0.0, const r64 _High = 0.0 ) -> ImageStats<T>
+	{
+		return stats(_Src.view(), _Bins, _Low, _High);
+	}
+}
@@ -0,0 +1,1559 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include "./Error.hpp"
+#include "./Image.hpp"
+#include "./VOps.hpp"
+#include <array>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Streaming codec internals. Row incremental PNG, BMP and PPM decoding and encoding.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img::impl
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Deflate tables. Shared by inflater and deflater.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr auto LEN_BASE = std::array<u16, 29>{ 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	constexpr auto LEN_EXTRA = std::array<u8, 29>{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	constexpr auto DIST_BASE = std::array<u16, 30>{ 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+	constexpr auto DIST_EXTRA = std::array<u8, 30>{ 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+	constexpr auto CLEN_ORDER = std::array<u8, 19>{ 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+	constexpr auto WINDOW_SIZE = u64(32768);
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Reverse lowest _Count bits.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	constexpr inline auto reverseBits ( u32 _Code, const u32 _Count ) -> u32
+	{
+		auto Reversed = u32(0);
+		for(auto i = u32(0); i < _Count; ++i) { Reversed = (Reversed << 1) | (_Code & 1); _Code >>= 1; }
+		return Reversed;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Big endian helpers.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto readBe32 ( const u8* _Src ) -> u32 { return (u32(_Src[0]) << 24) | (u32(_Src[1]) << 16) | (u32(_Src[2]) << 8) | u32(_Src[3]); }
+	inline auto writeBe32 ( u8* _Dst, const u32 _Val ) -> void { _Dst[0] = u8(_Val >> 24); _Dst[1] = u8(_Val >> 16); _Dst[2] = u8(_Val >> 8); _Dst[3] = u8(_Val); }
+	inline auto readLe16 ( const u8* _Src ) -> u32 { return u32(_Src[0]) | (u32(_Src[1]) << 8); }
+	inline auto readLe32 ( const u8* _Src ) -> u32 { return u32(_Src[0]) | (u32(_Src[1]) << 8) | (u32(_Src[2]) << 16) | (u32(_Src[3]) << 24); }
+	inline auto writeLe16 ( u8* _Dst, const u32 _Val ) -> void { _Dst[0] = u8(_Val); _Dst[1] = u8(_Val >> 8); }
+	inline auto writeLe32 ( u8* _Dst, const u32 _Val ) -> void { _Dst[0] = u8(_Val); _Dst[1] = u8(_Val >> 8); _Dst[2] = u8(_Val >> 16); _Dst[3] = u8(_Val >> 24); }
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// CRC32 as used by PNG chunks.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto crc32 ( u32 _Crc, const u8* _Data, const u64 _Size ) -> u32
+	{
+		static const auto Table = []
+		{
+			auto Entries = std::array<u32, 256>();
+
+			for(auto n = u32(0); n < 256; ++n)
+			{
+				auto C = n;
+				for(auto k = 0; k < 8; ++k) C = (C & 1) ? (0xEDB88320u ^ (C >> 1)) : (C >> 1);
+				Entries[n] = C;
+			}
+
+			return Entries;
+		}();
+
+		_Crc = ~_Crc;
+		for(auto i = u64(0); i < _Size; ++i) _Crc = Table[(_Crc ^ _Data[i]) & 0xFF] ^ (_Crc >> 8);
+		return ~_Crc;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Adler32 as used by zlib streams. Sums are reduced every 5552 bytes, the largest run that can not overflow.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto adler32 ( const u32 _Adler, const u8* _Data, u64 _Size ) -> u32
+	{
+		auto A = _Adler & 0xFFFF;
+		auto B = _Adler >> 16;
+
+		while(_Size > 0)
+		{
+			const auto Run = std::min(_Size, u64(5552));
+			for(auto i = u64(0); i < Run; ++i) { A += _Data[i]; B += A; }
+			A %= 65521;
+			B %= 65521;
+			_Data += Run;
+			_Size -= Run;
+		}
+
+		return (B << 16) | A;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Paeth predictor.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto paeth ( const i32 _A, const i32 _B, const i32 _C ) -> i32
+	{
+		const auto P = _A + _B - _C;
+		const auto Pa = std::abs(P - _A);
+		const auto Pb = std::abs(P - _B);
+		const auto Pc = std::abs(P - _C);
+
+		if((Pa <= Pb) && (Pa <= Pc)) return _A;
+		if(Pb <= Pc) return _B;
+		return _C;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Canonical Huffman decoding table. Codes up to LOOKUP_BITS long are resolved with one lookup.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	struct Huffman
+	{
+		static constexpr auto LOOKUP_BITS = u32(10);
+
+		std::array<u16, (1 << LOOKUP_BITS)> Fast;
+		std::array<u16, 16> Count;
+		std::array<u16, 288> Symbol;
+
+		auto build ( const u8* _Lengths, const u32 _Size ) -> void
+		{
+			this->Fast.fill(0);
+			this->Count.fill(0);
+
+			for(auto s = u32(0); s < _Size; ++s) ++this->Count[_Lengths[s]];
+			this->Count[0] = 0;
+
+			auto Left = i32(1);
+			for(auto Len = 1; Len < 16; ++Len)
+			{
+				Left = (Left << 1) - this->Count[Len];
+				if(Left < 0) throw Error("fx::img"s, "Inflater"s, "build"s, ERR_LOAD_FAILED, "Over-subscribed Huffman code."s);
+			}
+
+			auto Offset = std::array<u16, 16>();
+			auto Next = std::array<u32, 16>();
+			auto Code = u32(0);
+			Offset[1] = 0;
+
+			for(auto Len = 1; Len < 16; ++Len)
+			{
+				Next[Len] = Code;
+				Code = (Code + this->Count[Len]) << 1;
+				if(Len < 15) Offset[Len + 1] = u16(Offset[Len] + this->Count[Len]);
+			}
+
+			for(auto s = u32(0); s < _Size; ++s)
+			{
+				const auto Len = u32(_Lengths[s]);
+				if(Len == 0) continue;
+
+				this->Symbol[Offset[Len]++] = u16(s);
+
+				if(Len <= LOOKUP_BITS)
+				{
+					const auto Reversed = reverseBits(Next[Len], Len);
+					for(auto i = Reversed; i < (1u << LOOKUP_BITS); i += (1u << Len)) this->Fast[i] = u16((Len << 9) | s);
+				}
+
+				++Next[Len];
+			}
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Pull based zlib decoder. Compressed bytes come from _Source, output is produced on demand.
+	// Only 32 KB window is kept, memory use does not depend on stream length.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	class Inflater
+	{
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		enum struct State { HEADER, STORED, HUFFMAN, DONE };
+
+		std::function<u64(u8*, u64)> Source;
+		std::vector<u8> Input;
+		u64 InputPos;
+		u64 InputEnd;
+		u64 BitBuf;
+		u32 BitCount;
+		std::vector<u8> Window;
+		u64 WindowPos;
+		State Mode;
+		bool Final;
+		u32 StoredLeft;
+		u32 MatchLeft;
+		u32 MatchDist;
+		Huffman Lit;
+		Huffman Dist;
+		bool HeaderRead;
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		Inflater ( std::function<u64(u8*, u64)> _Source ) : Source(std::move(_Source)), Input(65536), InputPos(0), InputEnd(0), BitBuf(0), BitCount(0), Window(WINDOW_SIZE), WindowPos(0),
+			Mode(State::HEADER), Final(false), StoredLeft(0), MatchLeft(0), MatchDist(0), Lit(), Dist(), HeaderRead(false) {}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Produce up to _Size bytes. Returns less only at end of stream.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto read ( u8* _Dst, const u64 _Size ) -> u64
+		{
+			if(!this->HeaderRead) this->readZlibHeader();
+
+			auto Produced = u64(0);
+
+			while(Produced < _Size)
+			{
+				if(this->MatchLeft > 0)
+				{
+					const auto Run = u32(std::min(u64(this->MatchLeft), _Size - Produced));
+					const auto Mask = WINDOW_SIZE - 1;
+
+					for(auto i = u32(0); i < Run; ++i)
+					{
+						const auto Byte = this->Window[(this->WindowPos - this->MatchDist) & Mask];
+						this->Window[this->WindowPos] = Byte;
+						this->WindowPos = (this->WindowPos + 1) & Mask;
+						_Dst[Produced++] = Byte;
+					}
+
+					this->MatchLeft -= Run;
+				}
+
+				else if(this->Mode == State::HUFFMAN)
+				{
+					const auto Sym = this->decode(this->Lit);
+
+					if(Sym < 256)
+					{
+						this->Window[this->WindowPos] = u8(Sym);
+						this->WindowPos = (this->WindowPos + 1) & (WINDOW_SIZE - 1);
+						_Dst[Produced++] = u8(Sym);
+					}
+
+					else if(Sym == 256) this->Mode = State::HEADER;
+
+					else
+					{
+						const auto LenSym = Sym - 257;
+						if(LenSym >= 29) this->corrupt("Bad length symbol.");
+						this->MatchLeft = LEN_BASE[LenSym] + this->take(LEN_EXTRA[LenSym]);
+
+						const auto DistSym = this->decode(this->Dist);
+						if(DistSym >= 30) this->corrupt("Bad distance symbol.");
+						this->MatchDist = DIST_BASE[DistSym] + this->take(DIST_EXTRA[DistSym]);
+					}
+				}
+
+				else if(this->Mode == State::STORED)
+				{
+					if(this->StoredLeft == 0) { this->Mode = State::HEADER; continue; }
+
+					const auto Byte = u8(this->take(8));
+					this->Window[this->WindowPos] = Byte;
+					this->WindowPos = (this->WindowPos + 1) & (WINDOW_SIZE - 1);
+					_Dst[Produced++] = Byte;
+					--this->StoredLeft;
+				}
+
+				else if(this->Mode == State::HEADER)
+				{
+					if(this->Final) { this->Mode = State::DONE; continue; }
+					this->readBlockHeader();
+				}
+
+				else break;
+			}
+
+			return Produced;
+		}
+
+		private:
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Throw on malformed stream.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		[[noreturn]] auto corrupt ( const char* _Why ) const -> void { throw Error("fx::img"s, "Inflater"s, "read"s, ERR_LOAD_FAILED, "Corrupt deflate stream: "s + _Why); }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Top up bit buffer with as many bytes as available.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto fill ( void ) -> void
+		{
+			while(this->BitCount <= 56)
+			{
+				if(this->InputPos == this->InputEnd)
+				{
+					this->InputPos = 0;
+					this->InputEnd = this->Source(this->Input.data(), this->Input.size());
+					if(this->InputEnd == 0) return;
+				}
+
+				this->BitBuf |= u64(this->Input[this->InputPos++]) << this->BitCount;
+				this->BitCount += 8;
+			}
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Consume _Count bits, LSB first.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto take ( const u32 _Count ) -> u32
+		{
+			if(_Count == 0) return 0;
+			if(this->BitCount < _Count) this->fill();
+			if(this->BitCount < _Count) this->corrupt("Unexpected end of data.");
+
+			const auto Bits = u32(this->BitBuf & ((u64(1) << _Count) - 1));
+			this->BitBuf >>= _Count;
+			this->BitCount -= _Count;
+			return Bits;
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Decode one Huffman symbol.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto decode ( const Huffman& _Table ) -> u32
+		{
+			if(this->BitCount < 15) this->fill();
+
+			const auto Entry = _Table.Fast[this->BitBuf & ((1u << Huffman::LOOKUP_BITS) - 1)];
+			if(Entry != 0)
+			{
+				const auto Len = u32(Entry >> 9);
+				if(Len > this->BitCount) this->corrupt("Unexpected end of data.");
+				this->BitBuf >>= Len;
+				this->BitCount -= Len;
+				return Entry & 0x1FF;
+			}
+
+			// Slow canonical walk for long codes.
+			auto Code = i32(0);
+			auto First = i32(0);
+			auto Index = i32(0);
+
+			for(auto Len = 1; Len < 16; ++Len)
+			{
+				Code |= i32(this->take(1));
+				const auto Count = i32(_Table.Count[Len]);
+				if(Code - Count < First) return _Table.Symbol[Index + (Code - First)];
+				Index += Count;
+				First = (First + Count) << 1;
+				Code <<= 1;
+			}
+
+			this->corrupt("Bad Huffman code.");
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Parse two byte zlib header.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto readZlibHeader ( void ) -> void
+		{
+			const auto Cmf = this->take(8);
+			const auto Flg = this->take(8);
+
+			if(((Cmf << 8) | Flg) % 31 != 0) this->corrupt("Bad zlib header.");
+			if((Cmf & 15) != 8) this->corrupt("Compression method is not deflate.");
+			if(Flg & 32) this->corrupt("Preset dictionary not supported.");
+
+			this->HeaderRead = true;
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Parse block header and build tables.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto readBlockHeader ( void ) -> void
+		{
+			this->Final = (this->take(1) == 1);
+			const auto Type = this->take(2);
+
+			if(Type == 0)
+			{
+				this->take(this->BitCount & 7);
+				const auto Len = this->take(16);
+				const auto NLen = this->take(16);
+				if((Len ^ 0xFFFF) != NLen) this->corrupt("Stored block length mismatch.");
+
+				this->StoredLeft = Len;
+				this->Mode = State::STORED;
+			}
+
+			else if(Type == 1)
+			{
+				auto Lengths = std::array<u8, 288 + 32>();
+				for(auto i = 0; i < 144; ++i) Lengths[i] = 8;
+				for(auto i = 144; i < 256; ++i) Lengths[i] = 9;
+				for(auto i = 256; i < 280; ++i) Lengths[i] = 7;
+				for(auto i = 280; i < 288; ++i) Lengths[i] = 8;
+				for(auto i = 288; i < 320; ++i) Lengths[i] = 5;
+
+				this->Lit.build(Lengths.data(), 288);
+				this->Dist.build(Lengths.data() + 288, 30);
+				this->Mode = State::HUFFMAN;
+			}
+
+			else if(Type == 2)
+			{
+				const auto NumLit = this->take(5) + 257;
+				const auto NumDist = this->take(5) + 1;
+				const auto NumClen = this->take(4) + 4;
+
+				auto ClenLengths = std::array<u8, 19>();
+				ClenLengths.fill(0);
+				for(auto i = u32(0); i < NumClen; ++i) ClenLengths[CLEN_ORDER[i]] = u8(this->take(3));
+
+				auto Clen = Huffman();
+				Clen.build(ClenLengths.data(), 19);
+
+				auto Lengths = std::array<u8, 288 + 32>();
+				Lengths.fill(0);
+				auto Filled = u32(0);
+
+				while(Filled < NumLit + NumDist)
+				{
+					const auto Sym = this->decode(Clen);
+
+					if(Sym < 16) Lengths[Filled++] = u8(Sym);
+
+					else
+					{
+						auto Repeat = u32(0);
+						auto Value = u8(0);
+
+						if(Sym == 16)
+						{
+							if(Filled == 0) this->corrupt("Repeat without previous length.");
+							Value = Lengths[Filled - 1];
+							Repeat = 3 + this->take(2);
+						}
+
+						else if(Sym == 17) Repeat = 3 + this->take(3);
+						else Repeat = 11 + this->take(7);
+
+						if(Filled + Repeat > NumLit + NumDist) this->corrupt("Too many code lengths.");
+						for(auto i = u32(0); i < Repeat; ++i) Lengths[Filled++] = Value;
+					}
+				}
+
+				this->Lit.build(Lengths.data(), NumLit);
+				this->Dist.build(Lengths.data() + NumLit, NumDist);
+				this->Mode = State::HUFFMAN;
+			}
+
+			else this->corrupt("Reserved block type.");
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Streaming zlib encoder. Each call emits one fixed Huffman block, matches may reach into last 32 KB of previous calls.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	class Deflater
+	{
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		static constexpr auto HASH_BITS = u32(15);
+		static constexpr auto MAX_CHAIN = u32(32);
+		static constexpr auto BLOCK_SIZE = u64(1) << 18;
+
+		std::vector<u8> History;
+		std::vector<i32> Head;
+		std::vector<i32> Prev;
+		u64 BitBuf;
+		u32 BitCount;
+		u32 Adler;
+		std::vector<u8>* Out;
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		Deflater ( void ) : History(), Head(u64(1) << HASH_BITS), Prev(), BitBuf(0), BitCount(0), Adler(1), Out(nullptr) {}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// zlib header. Must be called first.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto begin ( std::vector<u8>& _Out ) -> void
+		{
+			_Out.push_back(0x78);
+			_Out.push_back(0x01);
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Compress _Size bytes as non final blocks. Whole bytes are appended to _Out, leftover bits stay buffered.
+		// Input is cut into blocks of BLOCK_SIZE, so match tables stay small however large the band is.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto push ( std::vector<u8>& _Out, const u8* _Data, const u64 _Size ) -> void
+		{
+			for(auto Done = u64(0); Done < _Size; Done += BLOCK_SIZE) this->block(_Out, _Data + Done, std::min(BLOCK_SIZE, _Size - Done));
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Emit empty final block and checksum.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto finish ( std::vector<u8>& _Out ) -> void
+		{
+			this->Out = &_Out;
+			this->put(3, 3);
+			this->putLiteral(256);
+			if(this->BitCount & 7) this->put(0, 8 - (this->BitCount & 7));
+			this->flushBytes();
+
+			_Out.push_back(u8(this->Adler >> 24));
+			_Out.push_back(u8(this->Adler >> 16));
+			_Out.push_back(u8(this->Adler >> 8));
+			_Out.push_back(u8(this->Adler));
+		}
+
+		private:
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Compress one fixed Huffman block with greedy hash chain matching.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto block ( std::vector<u8>& _Out, const u8* _Data, const u64 _Size ) -> void
+		{
+			this->Out = &_Out;
+			this->Adler = adler32(this->Adler, _Data, _Size);
+
+			const auto Start = this->History.size();
+			this->History.insert(this->History.end(), _Data, _Data + _Size);
+			const auto End = this->History.size();
+			const auto Buf = this->History.data();
+
+			std::fill(this->Head.begin(), this->Head.end(), -1);
+			this->Prev.assign(End, -1);
+			for(auto i = u64(0); (i + 2 < End) && (i < Start); ++i) this->insert(Buf, i);
+
+
+			this->put(2, 3);
+
+			auto Pos = Start;
+			while(Pos < End)
+			{
+				auto BestLen = u32(0);
+				auto BestDist = u32(0);
+
+				if(Pos + 2 < End)
+				{
+					auto Candidate = this->Head[this->hash(Buf + Pos)];
+					const auto Limit = u32(std::min(u64(258), End - Pos));
+
+					for(auto Chain = u32(0); (Candidate >= 0) && (Chain < MAX_CHAIN); ++Chain)
+					{
+						const auto Dist = u32(Pos - u64(Candidate));
+						if(Dist > WINDOW_SIZE) break;
+
+						auto Len = u32(0);
+						while((Len < Limit) && (Buf[Candidate + Len] == Buf[Pos + Len])) ++Len;
+						if(Len > BestLen) { BestLen = Len; BestDist = Dist; if(Len == Limit) break; }
+
+						Candidate = this->Prev[Candidate];
+					}
+
+					this->insert(Buf, Pos);
+				}
+
+				if(BestLen >= 3)
+				{
+					this->putLength(BestLen);
+					this->putDistance(BestDist);
+					for(auto i = Pos + 1; (i < Pos + BestLen) && (i + 2 < End); ++i) this->insert(Buf, i);
+					Pos += BestLen;
+				}
+
+				else
+				{
+					this->putLiteral(Buf[Pos]);
+					++Pos;
+				}
+			}
+
+			this->putLiteral(256);
+			this->flushBytes();
+
+
+			if(this->History.size() > WINDOW_SIZE) this->History.erase(this->History.begin(), this->History.end() - WINDOW_SIZE);
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Hash chain helpers.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto hash ( const u8* _P ) const -> u32 { return ((u32(_P[0]) << 16 | u32(_P[1]) << 8 | u32(_P[2])) * 2654435761u) >> (32 - HASH_BITS); }
+		auto insert ( const u8* _Buf, const u64 _Pos ) -> void { const auto H = this->hash(_Buf + _Pos); this->Prev[_Pos] = this->Head[H]; this->Head[H] = i32(_Pos); }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Bit output, LSB first. Huffman codes are reversed before going in.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto put ( const u32 _Bits, const u32 _Count ) -> void
+		{
+			this->BitBuf |= u64(_Bits) << this->BitCount;
+			this->BitCount += _Count;
+			if(this->BitCount >= 32) this->flushBytes();
+		}
+
+		auto flushBytes ( void ) -> void
+		{
+			while(this->BitCount >= 8)
+			{
+				this->Out->push_back(u8(this->BitBuf));
+				this->BitBuf >>= 8;
+				this->BitCount -= 8;
+			}
+		}
+
+		auto putLiteral ( const u32 _Sym ) -> void
+		{
+			if(_Sym < 144) this->put(reverseBits(0x30 + _Sym, 8), 8);
+			else if(_Sym < 256) this->put(reverseBits(0x190 + (_Sym - 144), 9), 9);
+			else if(_Sym < 280) this->put(reverseBits(_Sym - 256, 7), 7);
+			else this->put(reverseBits(0xC0 + (_Sym - 280), 8), 8);
+		}
+
+		auto putLength ( const u32 _Len ) -> void
+		{
+			auto Code = u32(28);
+			while(LEN_BASE[Code] > _Len) --Code;
+			this->putLiteral(257 + Code);
+			if(LEN_EXTRA[Code] > 0) this->put(_Len - LEN_BASE[Code], LEN_EXTRA[Code]);
+		}
+
+		auto putDistance ( const u32 _Dist ) -> void
+		{
+			auto Code = u32(29);
+			while(DIST_BASE[Code] > _Dist) --Code;
+			this->put(reverseBits(Code, 5), 5);
+			if(DIST_EXTRA[Code] > 0) this->put(_Dist - DIST_BASE[Code], DIST_EXTRA[Code]);
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Row decoder interface. Rows are produced top to bottom, interleaved channels, 8 bits per channel.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	class RowDecoder
+	{
+		public:
+		u64 Width = 0;
+		u64 Height = 0;
+		u64 Depth = 0;
+
+		virtual ~RowDecoder ( void ) = default;
+		virtual auto readRows ( u8* _Dst, const u64 _Rows ) -> void = 0;
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Row encoder interface. Rows are consumed top to bottom.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	class RowEncoder
+	{
+		public:
+		virtual ~RowEncoder ( void ) = default;
+		virtual auto writeRows ( const u8* _Src, const u64 _Rows ) -> void = 0;
+		virtual auto finish ( void ) -> void = 0;
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Read exactly _Size bytes or throw.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto readExact ( std::ifstream& _File, u8* _Dst, const u64 _Size, const char* _Who ) -> void
+	{
+		_File.read(reinterpret_cast<char*>(_Dst), std::streamsize(_Size));
+		if(u64(_File.gcount()) != _Size) throw Error("fx::img"s, _Who, "readRows"s, ERR_LOAD_FAILED, "Unexpected end of file."s);
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// PNG decoder. Non interlaced, any colour type, bit depths 1..16. 16 bit channels keep high byte.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	class PngDecoder : public RowDecoder
+	{
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		std::ifstream File;
+		u32 ChunkLeft;
+		bool IdatDone;
+		u32 BitDepth;
+		u32 ColourType;
+		u32 Channels;
+		u64 RowBytes;
+		u64 FilterBytes;
+		std::vector<u8> Palette;
+		std::vector<u8> Prior;
+		std::vector<u8> Current;
+		std::unique_ptr<Inflater> Stream;
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors. Reads every chunk up to first IDAT.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		PngDecoder ( const str& _Filename ) : File(_Filename, std::ios::binary), ChunkLeft(0), IdatDone(false), BitDepth(0), ColourType(0), Channels(0), RowBytes(0), FilterBytes(0)
+		{
+			if(!this->File.is_open()) throw Error("fx::img"s, "PngDecoder"s, "PngDecoder"s, ERR_FAILED_TO_OPEN, "Failed to open file: "s + _Filename);
+
+			auto Signature = std::array<u8, 8>();
+			readExact(this->File, Signature.data(), 8, "PngDecoder");
+
+			auto Transparency = std::vector<u8>();
+
+			while(true)
+			{
+				auto Header = std::array<u8, 8>();
+				readExact(this->File, Header.data(), 8, "PngDecoder");
+				const auto Length = readBe32(Header.data());
+				const auto Type = str(reinterpret_cast<const char*>(Header.data() + 4), 4);
+
+				if(Type == "IDAT") { this->ChunkLeft = Length; break; }
+
+				auto Body = std::vector<u8>(Length + 4);
+				readExact(this->File, Body.data(), Body.size(), "PngDecoder");
+
+				if(Type == "IHDR")
+				{
+					this->Width = readBe32(Body.data());
+					this->Height = readBe32(Body.data() + 4);
+					this->BitDepth = Body[8];
+					this->ColourType = Body[9];
+					if(Body[12] != 0) throw Error("fx::img"s, "PngDecoder"s, "PngDecoder"s, ERR_UNKNOWN_FORMAT, "Interlaced PNG can not be streamed: "s + _Filename);
+				}
+
+				else if(Type == "PLTE") this->Palette.assign(Body.begin(), Body.end() - 4);
+				else if(Type == "tRNS") Transparency.assign(Body.begin(), Body.end() - 4);
+				else if(Type == "IEND") throw Error("fx::img"s, "PngDecoder"s, "PngDecoder"s, ERR_LOAD_FAILED, "PNG has no image data: "s + _Filename);
+			}
+
+
+			if(this->ColourType == 0) { this->Channels = 1; this->Depth = 1; }
+			else if(this->ColourType == 2) { this->Channels = 3; this->Depth = 3; }
+			else if(this->ColourType == 3) { this->Channels = 1; this->Depth = Transparency.empty() ? 3 : 4; }
+			else if(this->ColourType == 4) { this->Channels = 2; this->Depth = 2; }
+			else if(this->ColourType == 6) { this->Channels = 4; this->Depth = 4; }
+			else throw Error("fx::img"s, "PngDecoder"s, "PngDecoder"s, ERR_UNKNOWN_FORMAT, "Bad PNG colour type: "s + _Filename);
+
+			if((this->ColourType == 3) && this->Palette.empty()) throw Error("fx::img"s, "PngDecoder"s, "PngDecoder"s, ERR_LOAD_FAILED, "PNG palette missing: "s + _Filename);
+
+
+			// Expand palette to RGBA once, so rows only need one lookup per pixel.
+			if(this->ColourType == 3)
+			{
+				auto Rgba = std::vector<u8>(256 * 4, 255);
+				for(auto i = u64(0); i < std::min(u64(256), u64(this->Palette.size() / 3)); ++i)
+				{
+					Rgba[i*4+0] = this->Palette[i*3+0];
+					Rgba[i*4+1] = this->Palette[i*3+1];
+					Rgba[i*4+2] = this->Palette[i*3+2];
+					if(i < Transparency.size()) Rgba[i*4+3] = Transparency[i];
+				}
+				this->Palette = std::move(Rgba);
+			}
+
+
+			const auto BitsPerPixel = u64(this->Channels) * this->BitDepth;
+			this->RowBytes = (this->Width * BitsPerPixel + 7) / 8;
+			this->FilterBytes = std::max(u64(1), BitsPerPixel / 8);
+			this->Prior.assign(this->RowBytes + this->FilterBytes, 0);
+			this->Current.assign(this->RowBytes + this->FilterBytes + 1, 0);
+			this->Stream = std::make_unique<Inflater>([this]( u8* _Dst, const u64 _Size ) { return this->feed(_Dst, _Size); });
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Decode next _Rows rows.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto readRows ( u8* _Dst, const u64 _Rows ) -> void override
+		{
+			const auto Fb = this->FilterBytes;
+
+			for(auto r = u64(0); r < _Rows; ++r)
+			{
+				// Current and Prior keep FilterBytes zeros in front, so left neighbour of first pixel reads zero.
+				auto Raw = this->Current.data() + Fb - 1;
+				if(this->Stream->read(Raw, this->RowBytes + 1) != this->RowBytes + 1) throw Error("fx::img"s, "PngDecoder"s, "readRows"s, ERR_LOAD_FAILED, "PNG data ended early."s);
+
+				const auto Filter = Raw[0];
+				Raw[0] = 0;
+				for(auto i = u64(0); i < Fb; ++i) this->Current[i] = 0;
+
+				auto Cur = this->Current.data() + Fb;
+				const auto Up = this->Prior.data() + Fb;
+
+				if(Filter == 1) for(auto i = u64(0); i < this->RowBytes; ++i) Cur[i] = u8(Cur[i] + Cur[i - Fb]);
+				else if(Filter == 2) for(auto i = u64(0); i < this->RowBytes; ++i) Cur[i] = u8(Cur[i] + Up[i]);
+				else if(Filter == 3) for(auto i = u64(0); i < this->RowBytes; ++i) Cur[i] = u8(Cur[i] + ((u32(Cur[i - Fb]) + u32(Up[i])) >> 1));
+				else if(Filter == 4) for(auto i = u64(0); i < this->RowBytes; ++i) Cur[i] = u8(Cur[i] + paeth(Cur[i - Fb], Up[i], Up[i - Fb]));
+				else if(Filter != 0) throw Error("fx::img"s, "PngDecoder"s, "readRows"s, ERR_LOAD_FAILED, "Bad PNG filter."s);
+
+				this->expand(Cur, _Dst + r * this->Width * this->Depth);
+				std::copy(this->Current.begin(), this->Current.begin() + Fb + this->RowBytes, this->Prior.begin());
+			}
+		}
+
+		private:
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Convert unfiltered row to 8 bit interleaved pixels.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto expand ( const u8* _Row, u8* _Dst ) const -> void
+		{
+			const auto Samples = this->Width * this->Channels;
+
+			if(this->ColourType == 3)
+			{
+				for(auto x = u64(0); x < this->Width; ++x)
+				{
+					const auto Index = this->sample(_Row, x, false);
+					for(auto c = u64(0); c < this->Depth; ++c) _Dst[x * this->Depth + c] = this->Palette[Index * 4 + c];
+				}
+			}
+
+			else if(this->BitDepth == 8) std::copy(_Row, _Row + Samples, _Dst);
+			else if(this->BitDepth == 16) for(auto i = u64(0); i < Samples; ++i) _Dst[i] = _Row[i * 2];
+			else for(auto i = u64(0); i < Samples; ++i) _Dst[i] = this->sample(_Row, i, true);
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Sample of sub byte bit depth. Grey levels are scaled to full 0..255 range.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto sample ( const u8* _Row, const u64 _Index, const bool _Scale ) const -> u8
+		{
+			if(this->BitDepth == 8) return _Row[_Index];
+
+			const auto Bit = _Index * this->BitDepth;
+			const auto Value = u32(_Row[Bit / 8] >> (8 - this->BitDepth - (Bit % 8))) & ((1u << this->BitDepth) - 1);
+			if(!_Scale) return u8(Value);
+			return u8(Value * (255 / ((1u << this->BitDepth) - 1)));
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Inflater source. Walks consecutive IDAT chunks.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto feed ( u8* _Dst, const u64 _Size ) -> u64
+		{
+			while((this->ChunkLeft == 0) && !this->IdatDone)
+			{
+				auto Header = std::array<u8, 12>();
+				readExact(this->File, Header.data(), 12, "PngDecoder");
+
+				if(std::memcmp(Header.data() + 8, "IDAT", 4) == 0) this->ChunkLeft = readBe32(Header.data() + 4);
+				else this->IdatDone = true;
+			}
+
+			if(this->IdatDone) return 0;
+
+			const auto Count = std::min(_Size, u64(this->ChunkLeft));
+			readExact(this->File, _Dst, Count, "PngDecoder");
+			this->ChunkLeft -= u32(Count);
+			return Count;
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// BMP decoder. Uncompressed 1, 4, 8 bit palette and 24, 32 bit colour. Rows are fetched with seeks, so bottom up files stream too.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	class BmpDecoder : public RowDecoder
+	{
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		std::ifstream File;
+		u64 DataOffset;
+		u64 Stride;
+		u32 BitCount;
+		bool TopDown;
+		u64 Row;
+		std::vector<u8> Palette;
+		std::vector<u8> Buffer;
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		BmpDecoder ( const str& _Filename ) : File(_Filename, std::ios::binary), DataOffset(0), Stride(0), BitCount(0), TopDown(false), Row(0)
+		{
+			if(!this->File.is_open()) throw Error("fx::img"s, "BmpDecoder"s, "BmpDecoder"s, ERR_FAILED_TO_OPEN, "Failed to open file: "s + _Filename);
+
+			auto Header = std::array<u8, 54>();
+			readExact(this->File, Header.data(), 54, "BmpDecoder");
+
+			this->DataOffset = readLe32(Header.data() + 10);
+			const auto InfoSize = readLe32(Header.data() + 14);
+			const auto Width = i32(readLe32(Header.data() + 18));
+			const auto Height = i32(readLe32(Header.data() + 22));
+			this->BitCount = readLe16(Header.data() + 28);
+			const auto Compression = readLe32(Header.data() + 30);
+			auto Colours = readLe32(Header.data() + 46);
+
+			if(InfoSize < 40) throw Error("fx::img"s, "BmpDecoder"s, "BmpDecoder"s, ERR_UNKNOWN_FORMAT, "Unsupported BMP header: "s + _Filename);
+			if((Compression != 0) && !((Compression == 3) && (this->BitCount == 32))) throw Error("fx::img"s, "BmpDecoder"s, "BmpDecoder"s, ERR_UNKNOWN_FORMAT, "Compressed BMP can not be streamed: "s + _Filename);
+			if((this->BitCount != 1) && (this->BitCount != 4) && (this->BitCount != 8) && (this->BitCount != 24) && (this->BitCount != 32))
+			{
+				throw Error("fx::img"s, "BmpDecoder"s, "BmpDecoder"s, ERR_UNKNOWN_FORMAT, "Unsupported BMP bit count: "s + _Filename);
+			}
+
+			this->Width = u64(std::abs(Width));
+			this->Height = u64(std::abs(Height));
+			this->TopDown = (Height < 0);
+			this->Depth = (this->BitCount == 32) ? 4 : 3;
+			this->Stride = ((this->Width * this->BitCount + 31) / 32) * 4;
+
+
+			if(this->BitCount <= 8)
+			{
+				if(Colours == 0) Colours = 1u << this->BitCount;
+				this->Palette.resize(u64(Colours) * 4);
+				this->File.seekg(std::streamoff(14 + InfoSize));
+				readExact(this->File, this->Palette.data(), this->Palette.size(), "BmpDecoder");
+			}
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Decode next _Rows rows. Bottom up files read whole band at once, then flip order.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto readRows ( u8* _Dst, const u64 _Rows ) -> void override
+		{
+			if(_Rows == 0) return;
+
+			const auto FirstFileRow = this->TopDown ? this->Row : (this->Height - this->Row - _Rows);
+			this->Buffer.resize(_Rows * this->Stride);
+			this->File.seekg(std::streamoff(this->DataOffset + FirstFileRow * this->Stride));
+			readExact(this->File, this->Buffer.data(), this->Buffer.size(), "BmpDecoder");
+
+			for(auto r = u64(0); r < _Rows; ++r)
+			{
+				const auto Src = this->Buffer.data() + (this->TopDown ? r : (_Rows - 1 - r)) * this->Stride;
+				auto Dst = _Dst + r * this->Width * this->Depth;
+
+				if(this->BitCount == 24) for(auto x = u64(0); x < this->Width; ++x) { Dst[x*3+0] = Src[x*3+2]; Dst[x*3+1] = Src[x*3+1]; Dst[x*3+2] = Src[x*3+0]; }
+				else if(this->BitCount == 32) for(auto x = u64(0); x < this->Width; ++x) { Dst[x*4+0] = Src[x*4+2]; Dst[x*4+1] = Src[x*4+1]; Dst[x*4+2] = Src[x*4+0]; Dst[x*4+3] = Src[x*4+3]; }
+
+				else
+				{
+					const auto PerByte = 8 / this->BitCount;
+					const auto Mask = u32((1u << this->BitCount) - 1);
+
+					for(auto x = u64(0); x < this->Width; ++x)
+					{
+						const auto Shift = 8 - this->BitCount * (1 + x % PerByte);
+						auto Index = u64((Src[x / PerByte] >> Shift) & Mask);
+						if(Index * 4 + 3 >= this->Palette.size()) Index = 0;
+
+						Dst[x*3+0] = this->Palette[Index*4+2];
+						Dst[x*3+1] = this->Palette[Index*4+1];
+						Dst[x*3+2] = this->Palette[Index*4+0];
+					}
+				}
+			}
+
+			this->Row += _Rows;
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Binary PGM (P5) and PPM (P6) decoder. Maxval other than 255 is rescaled to 8 bits.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	class PpmDecoder : public RowDecoder
+	{
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		std::ifstream File;
+		u32 MaxVal;
+		std::vector<u8> Buffer;
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		PpmDecoder ( const str& _Filename ) : File(_Filename, std::ios::binary), MaxVal(255)
+		{
+			if(!this->File.is_open()) throw Error("fx::img"s, "PpmDecoder"s, "PpmDecoder"s, ERR_FAILED_TO_OPEN, "Failed to open file: "s + _Filename);
+
+			auto Magic = std::array<char, 2>();
+			this->File.read(Magic.data(), 2);
+			if((Magic[0] != 'P') || ((Magic[1] != '5') && (Magic[1] != '6'))) throw Error("fx::img"s, "PpmDecoder"s, "PpmDecoder"s, ERR_UNKNOWN_FORMAT, "Not binary PGM/PPM: "s + _Filename);
+
+			this->Depth = (Magic[1] == '5') ? 1 : 3;
+			this->Width = this->number();
+			this->Height = this->number();
+			this->MaxVal = u32(this->number());
+			this->File.get();
+
+			if((this->MaxVal == 0) || (this->MaxVal > 65535) || !this->File.good()) throw Error("fx::img"s, "PpmDecoder"s, "PpmDecoder"s, ERR_LOAD_FAILED, "Bad PGM/PPM header: "s + _Filename);
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Decode next _Rows rows.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto readRows ( u8* _Dst, const u64 _Rows ) -> void override
+		{
+			const auto Samples = _Rows * this->Width * this->Depth;
+
+			if(this->MaxVal == 255) { readExact(this->File, _Dst, Samples, "PpmDecoder"); return; }
+
+			const auto Wide = (this->MaxVal > 255);
+			this->Buffer.resize(Samples * (Wide ? 2 : 1));
+			readExact(this->File, this->Buffer.data(), this->Buffer.size(), "PpmDecoder");
+
+			for(auto i = u64(0); i < Samples; ++i)
+			{
+				const auto Value = Wide ? ((u32(this->Buffer[i*2]) << 8) | this->Buffer[i*2+1]) : u32(this->Buffer[i]);
+				_Dst[i] = u8((std::min(Value, this->MaxVal) * 255 + this->MaxVal / 2) / this->MaxVal);
+			}
+		}
+
+		private:
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Read header number, skipping whitespace and comments.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto number ( void ) -> u64
+		{
+			auto C = this->File.get();
+
+			while(this->File.good())
+			{
+				if(C == '#') while(this->File.good() && (C != '\n')) C = this->File.get();
+				else if(std::isspace(C)) C = this->File.get();
+				else break;
+			}
+
+			auto Value = u64(0);
+			while(this->File.good() && std::isdigit(C)) { Value = Value * 10 + u64(C - '0'); C = this->File.get(); }
+			this->File.unget();
+
+			return Value;
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Open file stream for writing or throw.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto openOutput ( const str& _Filename, const char* _Who ) -> std::ofstream
+	{
+		auto File = std::ofstream(_Filename, std::ios::binary);
+		if(!File.is_open()) throw Error("fx::img"s, _Who, _Who, ERR_FAILED_TO_OPEN, "Failed to open file: "s + _Filename);
+		return File;
+	}
+
+	inline auto writeBytes ( std::ofstream& _File, const u8* _Src, const u64 _Size ) -> void
+	{
+		_File.write(reinterpret_cast<const char*>(_Src), std::streamsize(_Size));
+		if(!_File.good()) throw Error("fx::img"s, "StreamWriter"s, "write"s, ERR_SAVE_FAILED, "Failed to write file."s);
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// PGM/PPM encoder. Depth 1 or 3.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	class PpmEncoder : public RowEncoder
+	{
+		std::ofstream File;
+		u64 RowSize;
+		public:
+
+		PpmEncoder ( const str& _Filename, const u64 _Width, const u64 _Height, const u64 _Depth ) : File(openOutput(_Filename, "PpmEncoder")), RowSize(_Width * _Depth)
+		{
+			if((_Depth != 1) && (_Depth != 3)) throw Error("fx::img"s, "PpmEncoder"s, "PpmEncoder"s, ERR_BAD_ARGS, "PPM needs depth 1 or 3."s);
+			const auto Header = ((_Depth == 1) ? "P5\n"s : "P6\n"s) + std::to_string(_Width) + " "s + std::to_string(_Height) + "\n255\n"s;
+			writeBytes(this->File, reinterpret_cast<const u8*>(Header.data()), Header.size());
+		}
+
+		auto writeRows ( const u8* _Src, const u64 _Rows ) -> void override { writeBytes(this->File, _Src, _Rows * this->RowSize); }
+		auto finish ( void ) -> void override { this->File.close(); }
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// BMP encoder. 24 bit for depth 1 and 3, 32 bit for depth 2 and 4. File is bottom up, so rows are placed with seeks.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	class BmpEncoder : public RowEncoder
+	{
+		std::ofstream File;
+		u64 Width;
+		u64 Height;
+		u64 Depth;
+		u64 Stride;
+		u64 Row;
+		std::vector<u8> Buffer;
+		public:
+
+		BmpEncoder ( const str& _Filename, const u64 _Width, const u64 _Height, const u64 _Depth ) : File(openOutput(_Filename, "BmpEncoder")), Width(_Width), Height(_Height), Depth(_Depth), Row(0)
+		{
+			const auto Bits = (_Depth % 2 == 0) ? u32(32) : u32(24);
+			this->Stride = ((_Width * Bits + 31) / 32) * 4;
+
+			auto Header = std::array<u8, 54>();
+			Header.fill(0);
+			Header[0] = 'B';
+			Header[1] = 'M';
+			writeLe32(Header.data() + 2, u32(54 + this->Stride * _Height));
+			writeLe32(Header.data() + 10, 54);
+			writeLe32(Header.data() + 14, 40);
+			writeLe32(Header.data() + 18, u32(_Width));
+			writeLe32(Header.data() + 22, u32(_Height));
+			writeLe16(Header.data() + 26, 1);
+			writeLe16(Header.data() + 28, Bits);
+			writeLe32(Header.data() + 34, u32(this->Stride * _Height));
+			writeBytes(this->File, Header.data(), Header.size());
+		}
+
+		auto writeRows ( const u8* _Src, const u64 _Rows ) -> void override
+		{
+			if(_Rows == 0) return;
+
+			this->Buffer.assign(_Rows * this->Stride, 0);
+			const auto Out = (this->Depth % 2 == 0) ? u64(4) : u64(3);
+
+			for(auto r = u64(0); r < _Rows; ++r)
+			{
+				const auto Src = _Src + r * this->Width * this->Depth;
+				auto Dst = this->Buffer.data() + (_Rows - 1 - r) * this->Stride;
+
+				for(auto x = u64(0); x < this->Width; ++x)
+				{
+					const auto P = Src + x * this->Depth;
+					const auto Grey = (this->Depth <= 2);
+
+					Dst[x*Out+0] = Grey ? P[0] : P[2];
+					Dst[x*Out+1] = Grey ? P[0] : P[1];
+					Dst[x*Out+2] = P[0];
+					if(Out == 4) Dst[x*Out+3] = P[this->Depth - 1];
+				}
+			}
+
+			this->File.seekp(std::streamoff(54 + (this->Height - this->Row - _Rows) * this->Stride));
+			writeBytes(this->File, this->Buffer.data(), this->Buffer.size());
+			this->Row += _Rows;
+		}
+
+		auto finish ( void ) -> void override { this->File.close(); }
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// PNG encoder. Each band becomes one IDAT chunk. Filter is picked per row by smallest sum of absolute residuals.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	class PngEncoder : public RowEncoder
+	{
+		std::ofstream File;
+		u64 RowBytes;
+		u64 Depth;
+		std::vector<u8> Prior;
+		std::vector<u8> Filtered;
+		std::vector<u8> Candidate;
+		std::vector<u8> Compressed;
+		Deflater Zip;
+		public:
+
+		PngEncoder ( const str& _Filename, const u64 _Width, const u64 _Height, const u64 _Depth ) : File(openOutput(_Filename, "PngEncoder")), RowBytes(_Width * _Depth), Depth(_Depth), Prior(_Width * _Depth, 0)
+		{
+			if((_Depth < 1) || (_Depth > 4)) throw Error("fx::img"s, "PngEncoder"s, "PngEncoder"s, ERR_BAD_ARGS, "PNG needs depth 1..4."s);
+
+			const auto Signature = std::array<u8, 8>{ 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A };
+			writeBytes(this->File, Signature.data(), 8);
+
+			auto Ihdr = std::array<u8, 13>();
+			const auto Types = std::array<u8, 5>{ 0, 0, 4, 2, 6 };
+			writeBe32(Ihdr.data(), u32(_Width));
+			writeBe32(Ihdr.data() + 4, u32(_Height));
+			Ihdr[8] = 8;
+			Ihdr[9] = Types[_Depth];
+			Ihdr[10] = 0;
+			Ihdr[11] = 0;
+			Ihdr[12] = 0;
+			this->chunk("IHDR", Ihdr.data(), 13);
+
+			this->Zip.begin(this->Compressed);
+		}
+
+		auto writeRows ( const u8* _Src, const u64 _Rows ) -> void override
+		{
+			this->Filtered.resize(_Rows * (this->RowBytes + 1));
+			this->Candidate.resize(this->RowBytes);
+
+			for(auto r = u64(0); r < _Rows; ++r)
+			{
+				const auto Row = _Src + r * this->RowBytes;
+				auto Dst = this->Filtered.data() + r * (this->RowBytes + 1);
+				auto BestCost = ~u64(0);
+
+				for(auto Filter = u8(0); Filter < 5; ++Filter)
+				{
+					auto Cost = u64(0);
+
+					for(auto i = u64(0); i < this->RowBytes; ++i)
+					{
+						const auto A = (i >= this->Depth) ? i32(Row[i - this->Depth]) : 0;
+						const auto B = i32(this->Prior[i]);
+						const auto C = (i >= this->Depth) ? i32(this->Prior[i - this->Depth]) : 0;
+						auto Predict = 0;
+
+						if(Filter == 1) Predict = A;
+						else if(Filter == 2) Predict = B;
+						else if(Filter == 3) Predict = (A + B) >> 1;
+						else if(Filter == 4) Predict = paeth(A, B, C);
+
+						this->Candidate[i] = u8(Row[i] - Predict);
+						Cost += u64(std::abs(i32(i8(this->Candidate[i]))));
+					}
+
+					if(Cost < BestCost)
+					{
+						BestCost = Cost;
+						Dst[0] = Filter;
+						std::copy(this->Candidate.begin(), this->Candidate.end(), Dst + 1);
+					}
+				}
+
+				std::copy(Row, Row + this->RowBytes, this->Prior.begin());
+			}
+
+			this->Zip.push(this->Compressed, this->Filtered.data(), this->Filtered.size());
+			this->flushIdat();
+		}
+
+		auto finish ( void ) -> void override
+		{
+			this->Zip.finish(this->Compressed);
+			this->flushIdat();
+			this->chunk("IEND", nullptr, 0);
+			this->File.close();
+		}
+
+		private:
+		auto flushIdat ( void ) -> void
+		{
+			if(this->Compressed.empty()) return;
+			this->chunk("IDAT", this->Compressed.data(), this->Compressed.size());
+			this->Compressed.clear();
+		}
+
+		auto chunk ( const char* _Type, const u8* _Data, const u64 _Size ) -> void
+		{
+			auto Header = std::array<u8, 8>();
+			writeBe32(Header.data(), u32(_Size));
+			std::memcpy(Header.data() + 4, _Type, 4);
+
+			auto Crc = crc32(0, Header.data() + 4, 4);
+			if(_Size > 0) Crc = crc32(Crc, _Data, _Size);
+			auto Tail = std::array<u8, 4>();
+			writeBe32(Tail.data(), Crc);
+
+			writeBytes(this->File, Header.data(), 8);
+			if(_Size > 0) writeBytes(this->File, _Data, _Size);
+			writeBytes(this->File, Tail.data(), 4);
+		}
+	};
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Streaming image IO. Images are read and written in bands of rows, never whole.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Band by band image reader. Supports PNG (non interlaced), BMP (uncompressed) and PGM/PPM (binary).
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	class StreamReader
+	{
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		std::unique_ptr<impl::RowDecoder> Decoder;
+		FileFormat Format;
+		u64 Row;
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors. Only header is read here.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		StreamReader ( const str& _Filename ) : Decoder(), Format(peekFormat(_Filename)), Row(0)
+		{
+			if(this->Format == FileFormat::NO_FILE) throw Error("fx::img"s, "StreamReader"s, "StreamReader"s, ERR_FAILED_TO_OPEN, "Failed to open file: "s + _Filename);
+
+			if(this->Format == FileFormat::PNG) this->Decoder = std::make_unique<impl::PngDecoder>(_Filename);
+			else if(this->Format == FileFormat::BMP) this->Decoder = std::make_unique<impl::BmpDecoder>(_Filename);
+			else if(this->Format == FileFormat::PPM) this->Decoder = std::make_unique<impl::PpmDecoder>(_Filename);
+			else throw Error("fx::img"s, "StreamReader"s, "StreamReader"s, ERR_UNKNOWN_FORMAT, "Format can not be streamed: "s + _Filename);
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Trivial.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		inline auto width ( void ) const -> u64 { return this->Decoder->Width; }
+		inline auto height ( void ) const -> u64 { return this->Decoder->Height; }
+		inline auto depth ( void ) const -> u64 { return this->Decoder->Depth; }
+		inline auto format ( void ) const -> FileFormat { return this->Format; }
+		inline auto row ( void ) const -> u64 { return this->Row; }
+		inline auto isDone ( void ) const -> bool { return this->Row >= this->Decoder->Height; }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Read next band of up to _Rows rows into _Band. Band storage is reused between calls.
+		// Returns number of rows read, 0 once image is exhausted.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto read ( Image<u8>& _Band, const u64 _Rows ) -> u64
+		{
+			if(_Rows == 0) throw Error("fx::img"s, "StreamReader"s, "read"s, ERR_BAD_ARGS, "Band must have at least one row."s);
+
+			const auto Count = std::min(_Rows, this->height() - this->Row);
+			if(Count == 0) return 0;
+
+			_Band.reset(this->width(), Count, this->depth());
+			this->Decoder->readRows(_Band.data(), Count);
+			this->Row += Count;
+
+			return Count;
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Call _Fn(Band, FirstRow) for every remaining band.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		template<class F> auto forEach ( const u64 _Rows, F&& _Fn ) -> void
+		{
+			auto Band = Image<u8>();
+
+			while(true)
+			{
+				const auto First = this->Row;
+				if(this->read(Band, _Rows) == 0) break;
+				_Fn(static_cast<const Image<u8>&>(Band), First);
+			}
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Band by band image writer. Supports PNG, BMP and PGM/PPM. Dimensions are fixed up front.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	class StreamWriter
+	{
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		std::unique_ptr<impl::RowEncoder> Encoder;
+		u64 Width;
+		u64 Height;
+		u64 Depth;
+		u64 Row;
+		bool Finished;
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors. AUTO picks format from file extension.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		StreamWriter ( const str& _Filename, const u64 _Width, const u64 _Height, const u64 _Depth, const FileFormat _Format = FileFormat::AUTO )
+			: Encoder(), Width(_Width), Height(_Height), Depth(_Depth), Row(0), Finished(false)
+		{
+			const auto Format = (_Format == FileFormat::AUTO) ? formatFromExtension(_Filename) : _Format;
+			if((_Width == 0) || (_Height == 0) || (_Depth == 0)) throw Error("fx::img"s, "StreamWriter"s, "StreamWriter"s, ERR_BAD_ARGS, "Image dimensions can not be zero."s);
+
+			if(Format == FileFormat::PNG) this->Encoder = std::make_unique<impl::PngEncoder>(_Filename, _Width, _Height, _Depth);
+			else if(Format == FileFormat::BMP) this->Encoder = std::make_unique<impl::BmpEncoder>(_Filename, _Width, _Height, _Depth);
+			else if(Format == FileFormat::PPM) this->Encoder = std::make_unique<impl::PpmEncoder>(_Filename, _Width, _Height, _Depth);
+			else throw Error("fx::img"s, "StreamWriter"s, "StreamWriter"s, ERR_UNKNOWN_FORMAT, "Format can not be streamed: "s + _Filename);
+		}
+
+		StreamWriter ( const StreamWriter& ) = delete;
+		auto operator= ( const StreamWriter& ) -> StreamWriter& = delete;
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Destructor. Closes file if finish() was not called. Errors are swallowed here.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		~StreamWriter ( void ) { if(!this->Finished) try { this->Encoder->finish(); } catch (...) {} }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Trivial.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		inline auto width ( void ) const -> u64 { return this->Width; }
+		inline auto height ( void ) const -> u64 { return this->Height; }
+		inline auto depth ( void ) const -> u64 { return this->Depth; }
+		inline auto row ( void ) const -> u64 { return this->Row; }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Append rows. Band width and depth must match writer.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto write ( const u8* _Rows, const u64 _Count ) -> void
+		{
+			if(this->Finished) throw Error("fx::img"s, "StreamWriter"s, "write"s, ERR_BAD_ARGS, "Writer already finished."s);
+			if(this->Row + _Count > this->Height) throw Error("fx::img"s, "StreamWriter"s, "write"s, ERR_INCONSISTENT_DIM, "More rows than image height."s);
+
+			this->Encoder->writeRows(_Rows, _Count);
+			this->Row += _Count;
+		}
+
+		auto write ( const Image<u8>& _Band ) -> void
+		{
+			if((_Band.width() != this->Width) || (_Band.depth() != this->Depth)) throw Error("fx::img"s, "StreamWriter"s, "write"s, ERR_INCONSISTENT_DIM, "Band does not match image."s);
+			this->write(_Band.data(), _Band.height());
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Complete file. Every row must have been written.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto finish ( void ) -> void
+		{
+			if(this->Finished) return;
+			if(this->Row != this->Height) throw Error("fx::img"s, "StreamWriter"s, "finish"s, ERR_INCONSISTENT_DIM, "Not every row was written."s);
+
+			this->Finished = true;
+			this->Encoder->finish();
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Band by band resampler. Source bands go in, destination bands come out as soon as their rows are complete.
+	// Uses triangle filter widened by scale factor when shrinking, so downscale averages every source pixel.
+	// Keeps only as many horizontally resampled rows as one output row needs.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	class StreamResizer
+	{
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		struct Axis
+		{
+			std::vector<u64> First;
+			std::vector<u64> Count;
+			std::vector<u64> Offset;
+			std::vector<r32> Weights;
+			u64 MaxCount = 0;
+		};
+
+		u64 SrcWidth;
+		u64 SrcHeight;
+		u64 DstWidth;
+		u64 DstHeight;
+		u64 Depth;
+		Axis Horizontal;
+		Axis Vertical;
+		std::vector<r32> Ring;
+		std::vector<r32> Accumulator;
+		u64 SrcRow;
+		u64 DstRow;
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		StreamResizer ( const u64 _SrcWidth, const u64 _SrcHeight, const u64 _Depth, const u64 _DstWidth, const u64 _DstHeight )
+			: SrcWidth(_SrcWidth), SrcHeight(_SrcHeight), DstWidth(_DstWidth), DstHeight(_DstHeight), Depth(_Depth), SrcRow(0), DstRow(0)
+		{
+			if((_SrcWidth == 0) || (_SrcHeight == 0) || (_DstWidth == 0) || (_DstHeight == 0) || (_Depth == 0))
+			{
+				throw Error("fx::img"s, "StreamResizer"s, "StreamResizer"s, ERR_BAD_ARGS, "Dimensions can not be zero."s);
+			}
+
+			this->Horizontal = this->axis(_SrcWidth, _DstWidth);
+			this->Vertical = this->axis(_SrcHeight, _DstHeight);
+			this->Ring.assign(this->Vertical.MaxCount * _DstWidth * _Depth, 0);
+			this->Accumulator.assign(_DstWidth * _Depth, 0);
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Trivial.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		inline auto isDone ( void ) const -> bool { return this->DstRow >= this->DstHeight; }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Feed source band. _Out receives every destination row completed by it, possibly zero rows.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto push ( const Image<u8>& _Band, Image<u8>& _Out ) -> void
+		{
+			if((_Band.width() != this->SrcWidth) || (_Band.depth() != this->Depth)) throw Error("fx::img"s, "StreamResizer"s, "push"s, ERR_INCONSISTENT_DIM, "Band does not match source."s);
+			if(this->SrcRow + _Band.height() > this->SrcHeight) throw Error("fx::img"s, "StreamResizer"s, "push"s, ERR_INCONSISTENT_DIM, "More rows than source height."s);
+
+			// Count finished rows first so output is sized once.
+			auto Last = this->DstRow;
+			const auto Top = this->SrcRow + _Band.height();
+			while((Last < this->DstHeight) && (this->Vertical.First[Last] + this->Vertical.Count[Last] <= Top)) ++Last;
+			_Out.reset(this->DstWidth, Last - this->DstRow, this->Depth);
+
+			const auto RowSize = this->DstWidth * this->Depth;
+			auto OutRow = u64(0);
+
+			for(auto r = u64(0); r < _Band.height(); ++r)
+			{
+				this->resampleRow(_Band.data() + r * this->SrcWidth * this->Depth, this->Ring.data() + (this->SrcRow % this->Vertical.MaxCount) * RowSize);
+				++this->SrcRow;
+
+				while((this->DstRow < this->DstHeight) && (this->Vertical.First[this->DstRow] + this->Vertical.Count[this->DstRow] <= this->SrcRow))
+				{
+					std::fill(this->Accumulator.begin(), this->Accumulator.end(), r32(0));
+					const auto W = this->Vertical.Weights.data() + this->Vertical.Offset[this->DstRow];
+
+					for(auto k = u64(0); k < this->Vertical.Count[this->DstRow]; ++k)
+					{
+						const auto Src = this->Ring.data() + ((this->Vertical.First[this->DstRow] + k) % this->Vertical.MaxCount) * RowSize;
+						vops::mulVecByConstAddToOut(RowSize, this->Accumulator.data(), Src, W[k]);
+					}
+
+					auto Dst = _Out.data() + OutRow * RowSize;
+					for(auto i = u64(0); i < RowSize; ++i) Dst[i] = u8(std::clamp(this->Accumulator[i] + r32(0.5), r32(0), r32(255)));
+
+					++OutRow;
+					++this->DstRow;
+				}
+			}
+		}
+
+		private:
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Filter taps for one axis.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto axis ( const u64 _Src, const u64 _Dst ) const -> Axis
+		{
+			auto Result = Axis();
+			const auto Scale = r64(_Src) / r64(_Dst);
+			const auto Radius = std::max(r64(1), Scale);
+
+			for(auto i = u64(0); i < _Dst; ++i)
+			{
+				const auto Center = (r64(i) + 0.5) * Scale - 0.5;
+				const auto Lo = i64(std::max(r64(0), std::ceil(Center - Radius)));
+				const auto Hi = i64(std::min(r64(_Src - 1), std::floor(Center + Radius)));
+
+				auto Taps = std::vector<r32>();
+				auto Sum = r64(0);
+				auto First = Lo;
+
+				for(auto s = Lo; s <= Hi; ++s)
+				{
+					const auto W = std::max(r64(0), 1.0 - std::abs(r64(s) - Center) / Radius);
+					if((W == 0) && Taps.empty()) { First = s + 1; continue; }
+					Taps.push_back(r32(W));
+					Sum += W;
+				}
+
+				while(!Taps.empty() && (Taps.back() == 0)) Taps.pop_back();
+				if(Taps.empty()) { First = std::clamp(i64(std::lround(Center)), i64(0), i64(_Src - 1)); Taps.push_back(1); Sum = 1; }
+
+				Result.First.push_back(u64(First));
+				Result.Count.push_back(Taps.size());
+				Result.Offset.push_back(Result.Weights.size());
+				for(auto W : Taps) Result.Weights.push_back(r32(W / Sum));
+				Result.MaxCount = std::max(Result.MaxCount, u64(Taps.size()));
+			}
+
+			return Result;
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Horizontal pass of one source row into float row.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto resampleRow ( const u8* _Src, r32* _Dst ) const -> void
+		{
+			for(auto x = u64(0); x < this->DstWidth; ++x)
+			{
+				const auto W = this->Horizontal.Weights.data() + this->Horizontal.Offset[x];
+				const auto Src = _Src + this->Horizontal.First[x] * this->Depth;
+				auto Dst = _Dst + x * this->Depth;
+
+				for(auto c = u64(0); c < this->Depth; ++c) Dst[c] = 0;
+				for(auto k = u64(0); k < this->Horizontal.Count[x]; ++k)
+				{
+					for(auto c = u64(0); c < this->Depth; ++c) Dst[c] += W[k] * r32(Src[k * this->Depth + c]);
+				}
+			}
+		}
+	};
+}
@@ -0,0 +1,346 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include "./Error.hpp"
+#include "./Image.hpp"
+#include "./ImageStream.hpp"
+#include <array>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <fstream>
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Tiled image file (.fxi).
+//
+// Layout, native byte order:
+//   0  char[4]  Magic "FXI1".
+//   4  char[8]  Element type name as given by fx::nameof<T>(), zero padded.
+//   12 u32      Reserved, zero.
+//   16 u64      Width, height, depth.
+//   40 u32      Tile width, tile height.
+//   48          Tiles in row major grid order. Every tile is full size, edge tiles are zero padded.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Header of .fxi file.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	struct TiledHeader
+	{
+		std::array<char, 4> Magic = { 'F', 'X', 'I', '1' };
+		std::array<char, 8> Type = {};
+		u32 Reserved = 0;
+		u64 Width = 0;
+		u64 Height = 0;
+		u64 Depth = 0;
+		u32 TileWidth = 0;
+		u32 TileHeight = 0;
+	};
+
+	static_assert(sizeof(TiledHeader) == 48, "fx::img::TiledHeader | Unexpected padding.");
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Fill header for element type T.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto makeTiledHeader ( const u64 _Width, const u64 _Height, const u64 _Depth, const u32 _TileWidth, const u32 _TileHeight ) -> TiledHeader
+	{
+		if((_Width == 0) || (_Height == 0) || (_Depth == 0) || (_TileWidth == 0) || (_TileHeight == 0))
+		{
+			throw Error("fx::img"s, ""s, "makeTiledHeader"s, ERR_BAD_ARGS, "Dimensions can not be zero."s);
+		}
+
+		auto Header = TiledHeader();
+		const auto Name = nameof<T>();
+		std::copy(Name.begin(), Name.end(), Header.Type.begin());
+		Header.Width = _Width;
+		Header.Height = _Height;
+		Header.Depth = _Depth;
+		Header.TileWidth = _TileWidth;
+		Header.TileHeight = _TileHeight;
+
+		return Header;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Copy one row of tiles out of band of _Header.TileHeight rows (fewer for last band) and append to file.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto writeTileRow ( std::ofstream& _File, const TiledHeader& _Header, const T* _Band, const u64 _Rows, std::vector<T>& _Tile ) -> void
+	{
+		const auto TilesX = (_Header.Width + _Header.TileWidth - 1) / _Header.TileWidth;
+		const auto TileRow = u64(_Header.TileWidth) * _Header.Depth;
+		_Tile.resize(TileRow * _Header.TileHeight);
+
+		for(auto Tx = u64(0); Tx < TilesX; ++Tx)
+		{
+			std::fill(_Tile.begin(), _Tile.end(), T(0));
+
+			const auto X0 = Tx * _Header.TileWidth;
+			const auto Span = (std::min(X0 + _Header.TileWidth, _Header.Width) - X0) * _Header.Depth;
+
+			for(auto r = u64(0); r < _Rows; ++r)
+			{
+				const auto Src = _Band + (r * _Header.Width + X0) * _Header.Depth;
+				std::copy(Src, Src + Span, _Tile.begin() + r * TileRow);
+			}
+
+			_File.write(reinterpret_cast<const char*>(_Tile.data()), std::streamsize(_Tile.size() * sizeof(T)));
+		}
+
+		if(!_File.good()) throw Error("fx::img"s, ""s, "writeTiled"s, ERR_SAVE_FAILED, "Failed to write tiles."s);
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Write image as .fxi file.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto writeTiled ( const Image<T>& _Src, const str& _Filename, const u32 _TileWidth = 256, const u32 _TileHeight = 256 ) -> void
+	{
+		if(_Src.isEmpty()) throw Error("fx::img"s, ""s, "writeTiled"s, ERR_EMPTY, "Image is empty."s);
+
+		const auto Header = makeTiledHeader<T>(_Src.width(), _Src.height(), _Src.depth(), _TileWidth, _TileHeight);
+		auto File = std::ofstream(_Filename, std::ios::binary);
+		if(!File.is_open()) throw Error("fx::img"s, ""s, "writeTiled"s, ERR_FAILED_TO_OPEN, "Failed to open file: "s + _Filename);
+		File.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+
+		auto Tile = std::vector<T>();
+		for(auto Y = u64(0); Y < _Src.height(); Y += _TileHeight)
+		{
+			const auto Rows = std::min(u64(_TileHeight), _Src.height() - Y);
+			writeTileRow(File, Header, _Src.data() + Y * _Src.width() * _Src.depth(), Rows, Tile);
+		}
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Convert streamed image to .fxi file. Only one row of tiles is held in memory.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto writeTiled ( StreamReader& _Src, const str& _Filename, const u32 _TileWidth = 256, const u32 _TileHeight = 256 ) -> void
+	{
+		const auto Header = makeTiledHeader<u8>(_Src.width(), _Src.height(), _Src.depth(), _TileWidth, _TileHeight);
+		auto File = std::ofstream(_Filename, std::ios::binary);
+		if(!File.is_open()) throw Error("fx::img"s, ""s, "writeTiled"s, ERR_FAILED_TO_OPEN, "Failed to open file: "s + _Filename);
+		File.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+
+		auto Tile = std::vector<u8>();
+		_Src.forEach(_TileHeight, [&]( const Image<u8>& _Band, const u64 ) { writeTileRow(File, Header, _Band.data(), _Band.height(), Tile); });
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Tiled virtual image.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Read only image backed by .fxi file. Tiles are loaded on first touch and kept in LRU cache limited by byte budget.
+	// Tiles are handed out as shared pointers, so eviction never invalidates tile still in use. Safe to read from many threads.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> class TiledImage
+	{
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		using Tile = std::shared_ptr<const std::vector<T>>;
+
+		struct Entry
+		{
+			Tile Data;
+			std::list<u64>::iterator Position;
+		};
+
+		std::ifstream File;
+		TiledHeader Header;
+		u64 TilesX;
+		u64 TilesY;
+		u64 Budget;
+		std::mutex FileLock;
+		std::mutex CacheLock;
+		std::list<u64> Recent;
+		std::unordered_map<u64, Entry> Cache;
+		u64 CachedBytes;
+		u64 Hits;
+		u64 Misses;
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors. Only header is read here.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		TiledImage ( const str& _Filename, const u64 _Budget = u64(256) << 20 ) : File(_Filename, std::ios::binary), Header(), TilesX(0), TilesY(0), Budget(_Budget), CachedBytes(0), Hits(0), Misses(0)
+		{
+			if(!this->File.is_open()) throw Error("fx::img"s, "TiledImage"s, "TiledImage"s, ERR_FAILED_TO_OPEN, "Failed to open file: "s + _Filename);
+
+			this->File.read(reinterpret_cast<char*>(&this->Header), sizeof(this->Header));
+			if(!this->File.good() || (std::memcmp(this->Header.Magic.data(), "FXI1", 4) != 0)) throw Error("fx::img"s, "TiledImage"s, "TiledImage"s, ERR_UNKNOWN_FORMAT, "Not .fxi file: "s + _Filename);
+
+			const auto Name = nameof<T>();
+			if(str(this->Header.Type.begin(), std::find(this->Header.Type.begin(), this->Header.Type.end(), '\0')) != Name) throw Error("fx::img"s, "TiledImage"s, "TiledImage"s, ERR_BAD_ARGS, "File holds other element type: "s + _Filename);
+			if((this->Header.TileWidth == 0) || (this->Header.TileHeight == 0)) throw Error("fx::img"s, "TiledImage"s, "TiledImage"s, ERR_LOAD_FAILED, "Bad tile size: "s + _Filename);
+
+			this->TilesX = (this->Header.Width + this->Header.TileWidth - 1) / this->Header.TileWidth;
+			this->TilesY = (this->Header.Height + this->Header.TileHeight - 1) / this->Header.TileHeight;
+		}
+
+		TiledImage ( const TiledImage& ) = delete;
+		auto operator= ( const TiledImage& ) -> TiledImage& = delete;
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Trivial.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		inline auto isEmpty ( void ) const -> bool { return this->size() == 0; }
+		inline auto width ( void ) const -> u64 { return this->Header.Width; }
+		inline auto height ( void ) const -> u64 { return this->Header.Height; }
+		inline auto depth ( void ) const -> u64 { return this->Header.Depth; }
+		inline auto size ( void ) const -> u64 { return (this->Header.Width*this->Header.Height*this->Header.Depth); }
+		inline auto sizeInBytes ( void ) const -> u64 { return (this->size()*sizeof(T)); }
+		inline auto tileWidth ( void ) const -> u64 { return this->Header.TileWidth; }
+		inline auto tileHeight ( void ) const -> u64 { return this->Header.TileHeight; }
+		inline auto tilesX ( void ) const -> u64 { return this->TilesX; }
+		inline auto tilesY ( void ) const -> u64 { return this->TilesY; }
+		inline auto tileSize ( void ) const -> u64 { return this->tileWidth() * this->tileHeight() * this->depth(); }
+		inline auto budget ( void ) const -> u64 { return this->Budget; }
+		inline auto cachedBytes ( void ) -> u64 { auto Guard = std::lock_guard<std::mutex>(this->CacheLock); return this->CachedBytes; }
+		inline auto hits ( void ) -> u64 { auto Guard = std::lock_guard<std::mutex>(this->CacheLock); return this->Hits; }
+		inline auto misses ( void ) -> u64 { auto Guard = std::lock_guard<std::mutex>(this->CacheLock); return this->Misses; }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Get tile, loading it if needed. Tile is tileWidth() x tileHeight() x depth(), interleaved, edge tiles zero padded.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto tile ( const u64 _TileX, const u64 _TileY ) -> Tile
+		{
+			if((_TileX >= this->TilesX) || (_TileY >= this->TilesY)) throw Error("fx::img"s, "TiledImage"s, "tile"s, ERR_BAD_ARGS, "Tile index out of range."s);
+
+			const auto Key = _TileY * this->TilesX + _TileX;
+
+			{
+				auto Guard = std::lock_guard<std::mutex>(this->CacheLock);
+				auto Found = this->Cache.find(Key);
+
+				if(Found != this->Cache.end())
+				{
+					this->Recent.splice(this->Recent.begin(), this->Recent, Found->second.Position);
+					++this->Hits;
+					return Found->second.Data;
+				}
+
+				++this->Misses;
+			}
+
+
+			// Disk read happens outside cache lock, so hits on other tiles are not held up.
+			auto Loaded = std::make_shared<std::vector<T>>(this->tileSize());
+
+			{
+				auto Guard = std::lock_guard<std::mutex>(this->FileLock);
+				this->File.seekg(std::streamoff(sizeof(TiledHeader) + Key * this->tileSize() * sizeof(T)));
+				this->File.read(reinterpret_cast<char*>(Loaded->data()), std::streamsize(Loaded->size() * sizeof(T)));
+				if(!this->File.good()) { this->File.clear(); throw Error("fx::img"s, "TiledImage"s, "tile"s, ERR_LOAD_FAILED, "Failed to read tile."s); }
+			}
+
+
+			auto Guard = std::lock_guard<std::mutex>(this->CacheLock);
+			auto Found = this->Cache.find(Key);
+			if(Found != this->Cache.end()) return Found->second.Data;
+
+			this->Recent.push_front(Key);
+			this->Cache[Key] = Entry{ Loaded, this->Recent.begin() };
+			this->CachedBytes += Loaded->size() * sizeof(T);
+			this->evict();
+
+			return Loaded;
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Read single element. Prefer readRegion() for anything larger than a few pixels.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto read ( const u64 _X, const u64 _Y, const u64 _D ) -> T
+		{
+			const auto Data = this->tile(_X / this->tileWidth(), _Y / this->tileHeight());
+			return (*Data)[((_Y % this->tileHeight()) * this->tileWidth() + (_X % this->tileWidth())) * this->depth() + _D];
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Copy region into _Out. Only tiles covering region are touched. _Out storage is reused.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto readRegion ( const u64 _X, const u64 _Y, const u64 _Width, const u64 _Height, Image<T>& _Out ) -> void
+		{
+			if((_Width == 0) || (_Height == 0)) throw Error("fx::img"s, "TiledImage"s, "readRegion"s, ERR_BAD_ARGS, "Region is empty."s);
+			if((_X + _Width > this->width()) || (_Y + _Height > this->height())) throw Error("fx::img"s, "TiledImage"s, "readRegion"s, ERR_BAD_ARGS, "Region out of bounds."s);
+
+			_Out.reset(_Width, _Height, this->depth());
+
+			const auto Tw = this->tileWidth();
+			const auto Th = this->tileHeight();
+			const auto D = this->depth();
+
+			for(auto Ty = _Y / Th; Ty <= (_Y + _Height - 1) / Th; ++Ty)
+			{
+				for(auto Tx = _X / Tw; Tx <= (_X + _Width - 1) / Tw; ++Tx)
+				{
+					const auto Data = this->tile(Tx, Ty);
+
+					const auto X0 = std::max(_X, Tx * Tw);
+					const auto X1 = std::min(_X + _Width, (Tx + 1) * Tw);
+					const auto Y0 = std::max(_Y, Ty * Th);
+					const auto Y1 = std::min(_Y + _Height, (Ty + 1) * Th);
+
+					for(auto Y = Y0; Y < Y1; ++Y)
+					{
+						const auto Src = Data->data() + ((Y - Ty * Th) * Tw + (X0 - Tx * Tw)) * D;
+						std::copy(Src, Src + (X1 - X0) * D, _Out.data() + ((Y - _Y) * _Width + (X0 - _X)) * D);
+					}
+				}
+			}
+		}
+
+		auto readRegion ( const u64 _X, const u64 _Y, const u64 _Width, const u64 _Height ) -> Image<T>
+		{
+			auto Region = Image<T>();
+			this->readRegion(_X, _Y, _Width, _Height, Region);
+			return Region;
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Change byte budget. Shrinking evicts immediately.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto setBudget ( const u64 _Budget ) -> void
+		{
+			auto Guard = std::lock_guard<std::mutex>(this->CacheLock);
+			this->Budget = _Budget;
+			this->evict();
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Drop every cached tile.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto clear ( void ) -> void
+		{
+			auto Guard = std::lock_guard<std::mutex>(this->CacheLock);
+			this->Cache.clear();
+			this->Recent.clear();
+			this->CachedBytes = 0;
+		}
+
+		private:
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Drop least recently used tiles until within budget. Most recent tile always stays. Caller holds cache lock.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto evict ( void ) -> void
+		{
+			while((this->CachedBytes > this->Budget) && (this->Recent.size() > 1))
+			{
+				const auto Key = this->Recent.back();
+				this->Recent.pop_back();
+				this->CachedBytes -= this->tileSize() * sizeof(T);
+				this->Cache.erase(Key);
+			}
+		}
+	};
+}
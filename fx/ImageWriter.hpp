@@ -0,0 +1,152 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include "./Error.hpp"
+#include "./Image.hpp"
+#include "./Threads.hpp"
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Background image writing.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::img
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Write-behind saver. Takes ownership of images, encodes and writes them on background threads.
+	// Memory held by queued images is capped by byte budget. Failed writes are collected, not thrown.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	class AsyncWriter
+	{
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		std::mutex Lock;
+		std::condition_variable Released;
+		std::vector<Error> Errors;
+		u64 Budget;
+		u64 BytesInFlight;
+		u64 JobsInFlight;
+		thr::Pool Workers;
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		AsyncWriter ( const u64 _Threads = 2, const u64 _Budget = u64(256) << 20 ) : Lock(), Released(), Errors(), Budget(_Budget), BytesInFlight(0), JobsInFlight(0), Workers(_Threads) {}
+		AsyncWriter ( const AsyncWriter& ) = delete;
+		auto operator= ( const AsyncWriter& ) -> AsyncWriter& = delete;
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Destructor. Waits for pending writes. Errors not collected by then are lost.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		~AsyncWriter ( void ) { this->drain(); }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Trivial.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto budget ( void ) const -> u64 { return this->Budget; }
+		auto bytesInFlight ( void ) -> u64 { auto Guard = std::lock_guard<std::mutex>(this->Lock); return this->BytesInFlight; }
+		auto jobsInFlight ( void ) -> u64 { auto Guard = std::lock_guard<std::mutex>(this->Lock); return this->JobsInFlight; }
+		auto hasErrors ( void ) -> bool { auto Guard = std::lock_guard<std::mutex>(this->Lock); return !this->Errors.empty(); }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Queue image for writing. Blocks only while byte budget is exhausted.
+		// Image larger than whole budget is accepted once nothing else is in flight.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto push ( Image<u8>&& _Image, const str& _Filename, const FileFormat _Format = FileFormat::AUTO, const EncodeOptions& _Options = EncodeOptions() ) -> void
+		{
+			const auto Bytes = _Image.sizeInBytes();
+
+			{
+				auto Guard = std::unique_lock<std::mutex>(this->Lock);
+				this->Released.wait(Guard, [&]{ return this->fits(Bytes); });
+				this->reserve(Bytes);
+			}
+
+			this->enqueue(std::move(_Image), _Filename, _Format, _Options);
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Queue image for writing without blocking. Image is moved from only when true is returned.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto tryPush ( Image<u8>& _Image, const str& _Filename, const FileFormat _Format = FileFormat::AUTO, const EncodeOptions& _Options = EncodeOptions() ) -> bool
+		{
+			const auto Bytes = _Image.sizeInBytes();
+
+			{
+				auto Guard = std::lock_guard<std::mutex>(this->Lock);
+				if(!this->fits(Bytes)) return false;
+				this->reserve(Bytes);
+			}
+
+			this->enqueue(std::move(_Image), _Filename, _Format, _Options);
+			return true;
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Barrier. Blocks until every queued image has been written or has failed.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto drain ( void ) -> void
+		{
+			auto Guard = std::unique_lock<std::mutex>(this->Lock);
+			this->Released.wait(Guard, [this]{ return this->JobsInFlight == 0; });
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Take errors collected so far.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto errors ( void ) -> std::vector<Error>
+		{
+			auto Guard = std::lock_guard<std::mutex>(this->Lock);
+			auto Taken = std::vector<Error>();
+			Taken.swap(this->Errors);
+			return Taken;
+		}
+
+		private:
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Budget bookkeeping. Caller holds lock.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto fits ( const u64 _Bytes ) const -> bool { return (this->JobsInFlight == 0) || (this->BytesInFlight + _Bytes <= this->Budget); }
+		auto reserve ( const u64 _Bytes ) -> void { this->BytesInFlight += _Bytes; ++this->JobsInFlight; }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Hand image to worker. Image lives in shared_ptr because std::function must be copyable.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto enqueue ( Image<u8>&& _Image, const str& _Filename, const FileFormat _Format, const EncodeOptions& _Options ) -> void
+		{
+			auto Owned = std::make_shared<Image<u8>>(std::move(_Image));
+
+			this->Workers.submit([this, Owned, _Filename, _Format, _Options]
+			{
+				const auto Bytes = Owned->sizeInBytes();
+				auto Failure = std::vector<Error>();
+
+				try { Owned->save(_Filename, _Format, _Options); }
+				catch (const Error& e) { Failure.push_back(e); }
+				catch (const std::exception& e) { Failure.push_back(Error("fx::img"s, "AsyncWriter"s, "push"s, ERR_SAVE_FAILED, e.what() + ": "s + _Filename)); }
+				catch (...) { Failure.push_back(Error("fx::img"s, "AsyncWriter"s, "push"s, ERR_SAVE_FAILED, "Unknown exception: "s + _Filename)); }
+
+				*Owned = Image<u8>();
+
+				{
+					auto Guard = std::lock_guard<std::mutex>(this->Lock);
+					this->Errors.insert(this->Errors.end(), Failure.begin(), Failure.end());
+					this->BytesInFlight -= Bytes;
+					--this->JobsInFlight;
+				}
+
+				this->Released.notify_all();
+			});
+		}
+	};
+}
@@ -0,0 +1,212 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pragma.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "./Types.hpp"
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Framework: Threading.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace fx::thr
+{
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Number of hardware threads. Never returns 0.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto hardwareThreads ( void ) -> u64
+	{
+		const auto Count = u64(std::thread::hardware_concurrency());
+		return (Count == 0) ? 1 : Count;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Fixed size pool of worker threads consuming FIFO task queue.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	class Pool
+	{
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Members.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		std::vector<std::thread> Workers;
+		std::deque<std::function<void()>> Tasks;
+		std::mutex Lock;
+		std::condition_variable HasWork;
+		std::condition_variable IsIdle;
+		u64 Active;
+		bool Stop;
+		public:
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Constructors. Zero threads means one per hardware thread.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		Pool ( const u64 _Threads = 0 ) : Workers(), Tasks(), Lock(), HasWork(), IsIdle(), Active(0), Stop(false)
+		{
+			const auto Count = (_Threads == 0) ? hardwareThreads() : _Threads;
+			for(auto i = u64(0); i < Count; ++i) this->Workers.emplace_back([this]{ this->work(); });
+		}
+
+		Pool ( const Pool& ) = delete;
+		auto operator= ( const Pool& ) -> Pool& = delete;
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Destructor. Finishes queued tasks and joins workers.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		~Pool ( void )
+		{
+			{
+				auto Guard = std::lock_guard<std::mutex>(this->Lock);
+				this->Stop = true;
+			}
+
+			this->HasWork.notify_all();
+			for(auto& Worker : this->Workers) Worker.join();
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Trivial.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		inline auto size ( void ) const -> u64 { return this->Workers.size(); }
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Queue task. Tasks must not throw, exceptions escaping task are dropped.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto submit ( std::function<void()> _Task ) -> void
+		{
+			{
+				auto Guard = std::lock_guard<std::mutex>(this->Lock);
+				this->Tasks.push_back(std::move(_Task));
+			}
+
+			this->HasWork.notify_one();
+		}
+
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Block until queue is empty and all workers are idle.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto wait ( void ) -> void
+		{
+			auto Guard = std::unique_lock<std::mutex>(this->Lock);
+			this->IsIdle.wait(Guard, [this]{ return this->Tasks.empty() && (this->Active == 0); });
+		}
+
+		private:
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		// Worker loop.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		auto work ( void ) -> void
+		{
+			while(true)
+			{
+				auto Task = std::function<void()>();
+
+				{
+					auto Guard = std::unique_lock<std::mutex>(this->Lock);
+					this->HasWork.wait(Guard, [this]{ return this->Stop || !this->Tasks.empty(); });
+					if(this->Tasks.empty()) return;
+
+					Task = std::move(this->Tasks.front());
+					this->Tasks.pop_front();
+					++this->Active;
+				}
+
+				try { Task(); } catch (...) {}
+
+				{
+					auto Guard = std::lock_guard<std::mutex>(this->Lock);
+					--this->Active;
+					if(this->Tasks.empty() && (this->Active == 0)) this->IsIdle.notify_all();
+				}
+			}
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Pool shared by parallel algorithms. Created on first use.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline auto sharedPool ( void ) -> Pool&
+	{
+		static auto Shared = Pool(hardwareThreads());
+		return Shared;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Set while thread runs parallelFor body. Nested parallelFor calls run inline instead of waiting on busy pool.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	inline thread_local auto InParallel = false;
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Run _Fn(Lo, Hi) over [_Begin, _End) split in chunks of about _Grain items. Caller thread takes part.
+	// Ranges too small for two chunks run inline. First exception thrown by body is rethrown after all chunks finish.
+	// Caller waits for chunks, not for helper tasks: it drains whatever helpers have not claimed, so calling from inside pool task cannot deadlock
+	// on helpers queued behind it. Helpers that start late find no chunk left and only touch shared state, never _Fn or caller stack.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class F> auto parallelFor ( const u64 _Begin, const u64 _End, const u64 _Grain, F&& _Fn ) -> void
+	{
+		if(_End <= _Begin) return;
+
+		const auto Count = _End - _Begin;
+		const auto Grain = (_Grain == 0) ? u64(1) : _Grain;
+		const auto Threads = sharedPool().size() + 1;
+		const auto Chunks = std::min((Count + Grain - 1) / Grain, Threads * 4);
+
+		if((Chunks <= 1) || InParallel) { _Fn(_Begin, _End); return; }
+
+		struct State
+		{
+			std::atomic<u64> Next = 0;
+			u64 Done = 0;
+			std::exception_ptr Failure;
+			std::mutex Lock;
+			std::condition_variable Finished;
+		};
+
+		const auto Shared = std::make_shared<State>();
+		const auto Body = &_Fn;
+		const auto Helpers = std::min(Chunks, Threads) - 1;
+
+		auto Run = [Shared, Body, Chunks, Count, _Begin]
+		{
+			const auto Outer = InParallel;
+			InParallel = true;
+
+			for(auto Chunk = Shared->Next++; Chunk < Chunks; Chunk = Shared->Next++)
+			{
+				const auto Lo = _Begin + (Count * Chunk) / Chunks;
+				const auto Hi = _Begin + (Count * (Chunk + 1)) / Chunks;
+				auto Failure = std::exception_ptr();
+
+				try { (*Body)(Lo, Hi); }
+				catch (...) { Failure = std::current_exception(); }
+
+				auto Guard = std::lock_guard<std::mutex>(Shared->Lock);
+				if(Failure && !Shared->Failure) Shared->Failure = Failure;
+				if(++Shared->Done == Chunks) Shared->Finished.notify_all();
+			}
+
+			InParallel = Outer;
+		};
+
+		for(auto i = u64(0); i < Helpers; ++i) sharedPool().submit(Run);
+
+		Run();
+
+		{
+			auto Guard = std::unique_lock<std::mutex>(Shared->Lock);
+			Shared->Finished.wait(Guard, [&]{ return Shared->Done == Chunks; });
+		}
+
+		if(Shared->Failure) std::rethrow_exception(Shared->Failure);
+	}
+}
@@ -18,4 +18,23 @@ namespace fx::mgx
 	// Select value at compile time.
 	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 	template<bool CONDITION, class T> constexpr inline auto select ( const T _A, const T _B ) { if constexpr(CONDITION) return _A; else return _B; }
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Block template argument deduction. Lets ImageView<T> bind to parameter taking ImageView<const T>.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> struct identity { using type = T; };
+	template<class T> using identity_t = typename identity<T>::type;
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Call _Fn with channel count as compile time constant for common depths 1..4, or with 0 for anything else.
+	// Lets per pixel loops unroll channel loop. Body picks runtime depth when it receives 0.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class F> constexpr inline auto withDepth ( const u64 _Depth, F&& _Fn )
+	{
+		if(_Depth == 1) return _Fn(std::integral_constant<u64, 1>());
+		else if(_Depth == 2) return _Fn(std::integral_constant<u64, 2>());
+		else if(_Depth == 3) return _Fn(std::integral_constant<u64, 3>());
+		else if(_Depth == 4) return _Fn(std::integral_constant<u64, 4>());
+		else return _Fn(std::integral_constant<u64, 0>());
+	}
 }
@@ -0,0 +1,224 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// FFT tests against naive DFT. Build from repository root with MSVC or GCC 13+ and run:
+//   g++ -std=c++20 -O2 -I. tests/Fft.cpp -o test_fft -pthread && ./test_fft
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "../fx/Fft.hpp"
+#include <cstdio>
+#include <cmath>
+
+using namespace fx;
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Test helpers.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace
+{
+	using C64 = std::complex<r64>;
+
+	auto Failures = 0;
+
+	auto check ( const bool _Ok, const char* _What, const r64 _Value ) -> void
+	{
+		std::printf("%s %s (%g)\n", _Ok ? "ok  " : "FAIL", _What, _Value);
+		if(!_Ok) ++Failures;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Deterministic noise in [-1, 1).
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	auto noise ( const u64 _Count, u32 _Seed ) -> std::vector<r64>
+	{
+		auto Result = std::vector<r64>(_Count);
+		for(auto& Val : Result)
+		{
+			_Seed = _Seed * 1664525u + 1013904223u;
+			Val = r64(_Seed >> 8) / r64(1 << 23) - 1.0;
+		}
+		return Result;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Naive 2D DFT of _Width x _Height values, row major, e^(-2 pi i) convention. 1D is _Height == 1.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	auto naive ( const std::vector<C64>& _In, const u64 _Width, const u64 _Height ) -> std::vector<C64>
+	{
+		auto Result = std::vector<C64>(_Width * _Height);
+
+		for(auto v = u64(0); v < _Height; ++v) for(auto u = u64(0); u < _Width; ++u)
+		{
+			auto Sum = C64(0.0, 0.0);
+			for(auto y = u64(0); y < _Height; ++y) for(auto x = u64(0); x < _Width; ++x)
+			{
+				const auto Angle = -2.0 * std::numbers::pi * (r64((u * x) % _Width) / r64(_Width) + r64((v * y) % _Height) / r64(_Height));
+				Sum += _In[y * _Width + x] * C64(std::cos(Angle), std::sin(Angle));
+			}
+			Result[v * _Width + u] = Sum;
+		}
+
+		return Result;
+	}
+
+	template<class A, class B> auto maxDiff ( const A& _A, const B& _B, const u64 _Count ) -> r64
+	{
+		auto Result = 0.0;
+		for(auto i = u64(0); i < _Count; ++i) Result = std::max(Result, std::abs(C64(_A[i]) - C64(_B[i])));
+		return Result;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Entry.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+auto main ( void ) -> int
+{
+	try
+	{
+		// Sizes cover every butterfly: radix 4 and 2 (64, 128), 3 and 5 (45, 60, 1000), generic primes (7, 49, 97, 210) and trivial sizes.
+		const u64 Sizes[] = { 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 30, 45, 49, 60, 64, 97, 100, 128, 210, 1000 };
+
+		{
+			auto Worst = 0.0;
+			auto WorstInverse = 0.0;
+
+			for(const auto N : Sizes)
+			{
+				const auto Re = noise(N, u32(N));
+				const auto Im = noise(N, u32(N) + 7u);
+				auto Data = std::vector<C64>(N);
+				for(auto i = u64(0); i < N; ++i) Data[i] = C64(Re[i], Im[i]);
+
+				const auto Ref = naive(Data, N, 1);
+				const auto Plan = math::Fft<r64>(N);
+				auto Out = Data;
+				Plan.forward(Out.data());
+				Worst = std::max(Worst, maxDiff(Out, Ref, N) / r64(N));
+
+				Plan.inverse(Out.data());
+				WorstInverse = std::max(WorstInverse, maxDiff(Out, Data, N));
+			}
+
+			check(Worst < 1e-13, "complex r64 forward matches naive DFT", Worst);
+			check(WorstInverse < 1e-12, "complex r64 inverse restores input", WorstInverse);
+		}
+
+		{
+			auto Worst = 0.0;
+
+			for(const auto N : { u64(60), u64(97), u64(256), u64(210) })
+			{
+				const auto Re = noise(N, 3u);
+				auto Data = std::vector<C64>(N);
+				auto Single = std::vector<std::complex<r32>>(N);
+				for(auto i = u64(0); i < N; ++i) { Single[i] = std::complex<r32>(r32(Re[i]), 0.0f); Data[i] = C64(r64(Single[i].real()), 0.0); }
+
+				const auto Ref = naive(Data, N, 1);
+				math::Fft<r32>(N).forward(Single.data());
+				Worst = std::max(Worst, maxDiff(Single, Ref, N) / r64(N));
+			}
+
+			check(Worst < 1e-6, "complex r32 forward matches naive DFT", Worst);
+		}
+
+		// Even sizes take packed half size path, odd sizes full complex path.
+		{
+			auto Worst = 0.0;
+			auto WorstInverse = 0.0;
+
+			for(const auto N : Sizes)
+			{
+				const auto Samples = noise(N, u32(N) + 11u);
+				auto Data = std::vector<C64>(N);
+				for(auto i = u64(0); i < N; ++i) Data[i] = C64(Samples[i], 0.0);
+
+				const auto Ref = naive(Data, N, 1);
+				const auto Plan = math::FftReal<r64>(N);
+				auto Spectrum = std::vector<C64>(Plan.bins());
+				Plan.forward(Samples.data(), Spectrum.data());
+				Worst = std::max(Worst, maxDiff(Spectrum, Ref, Plan.bins()) / r64(N));
+
+				auto Back = std::vector<r64>(N);
+				Plan.inverse(Spectrum.data(), Back.data());
+				WorstInverse = std::max(WorstInverse, maxDiff(Back, Samples, N));
+			}
+
+			check(Worst < 1e-13, "real forward matches naive DFT, odd and even sizes", Worst);
+			check(WorstInverse < 1e-12, "real inverse restores samples", WorstInverse);
+		}
+
+		{
+			auto Worst = 0.0;
+			auto WorstInverse = 0.0;
+
+			for(const auto& Size : { std::pair<u64, u64>{ 12, 10 }, { 30, 7 }, { 16, 16 }, { 5, 45 } })
+			{
+				const auto [W, H] = Size;
+				const auto Re = noise(W * H, 5u);
+				const auto Im = noise(W * H, 6u);
+				auto Data = std::vector<C64>(W * H);
+				for(auto i = u64(0); i < W * H; ++i) Data[i] = C64(Re[i], Im[i]);
+
+				const auto Ref = naive(Data, W, H);
+				const auto Plan = math::Fft2D<r64>(W, H);
+				auto Out = Data;
+				Plan.forward(Out.data());
+				Worst = std::max(Worst, maxDiff(Out, Ref, W * H) / r64(W * H));
+
+				Plan.inverse(Out.data());
+				WorstInverse = std::max(WorstInverse, maxDiff(Out, Data, W * H));
+			}
+
+			check(Worst < 1e-13, "2D complex forward matches naive DFT", Worst);
+			check(WorstInverse < 1e-12, "2D complex inverse restores input", WorstInverse);
+		}
+
+		// Inverse uses its spectrum argument as scratch, so spectrum that is needed again is passed as copy.
+		{
+			auto Worst = 0.0;
+			auto WorstInverse = 0.0;
+			auto Reused = 0.0;
+
+			for(const auto& Size : { std::pair<u64, u64>{ 12, 10 }, { 15, 9 }, { 64, 8 }, { 7, 7 } })
+			{
+				const auto [W, H] = Size;
+				const auto Samples = noise(W * H, 9u);
+				auto Data = std::vector<C64>(W * H);
+				for(auto i = u64(0); i < W * H; ++i) Data[i] = C64(Samples[i], 0.0);
+
+				const auto Ref = naive(Data, W, H);
+				const auto Plan = math::FftReal2D<r64>(W, H);
+				const auto B = Plan.bins();
+				auto Spectrum = std::vector<C64>(H * B);
+				Plan.forward(Samples.data(), Spectrum.data());
+				for(auto v = u64(0); v < H; ++v) Worst = std::max(Worst, maxDiff(Spectrum.data() + v * B, Ref.data() + v * W, B) / r64(W * H));
+
+				auto Back = std::vector<r64>(W * H);
+				auto Scratch = Spectrum;
+				Plan.inverse(Scratch.data(), Back.data());
+				WorstInverse = std::max(WorstInverse, maxDiff(Back, Samples, W * H));
+
+				Scratch = Spectrum;
+				auto Again = std::vector<r64>(W * H);
+				Plan.inverse(Scratch.data(), Again.data());
+				Reused = std::max(Reused, maxDiff(Again, Back, W * H));
+			}
+
+			check(Worst < 1e-13, "2D real forward matches naive DFT, odd and even widths", Worst);
+			check(WorstInverse < 1e-12, "2D real inverse restores samples", WorstInverse);
+			check(Reused == 0.0, "2D real inverse from fresh copy of spectrum repeats exactly", Reused);
+		}
+
+		check(math::nextFastSize(97) == 100 && math::nextFastSize(1) == 1 && math::nextFastSize(121) == 125, "nextFastSize", r64(math::nextFastSize(97)));
+	}
+
+	catch(Error& e)
+	{
+		e.print();
+		return 1;
+	}
+
+	return (Failures == 0) ? 0 : 1;
+}
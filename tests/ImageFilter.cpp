@@ -0,0 +1,138 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Separable convolution tests. Build from repository root with MSVC or GCC 13+ and run:
+//   g++ -std=c++20 -O2 -I. tests/ImageFilter.cpp -o test_filter -pthread && ./test_filter
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "../fx/ImageFilter.hpp"
+#include <cstdio>
+#include <cmath>
+
+using namespace fx;
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Test helpers.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace
+{
+	auto Failures = 0;
+
+	auto check ( const bool _Ok, const char* _What, const r64 _Value ) -> void
+	{
+		std::printf("%s %s (%g)\n", _Ok ? "ok  " : "FAIL", _What, _Value);
+		if(!_Ok) ++Failures;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Deterministic noise image.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto noise ( const u64 _Width, const u64 _Height, const u64 _Depth ) -> Image<T>
+	{
+		auto Result = Image<T>(_Width, _Height, _Depth);
+		auto State = u32(12345);
+
+		for(auto i = u64(0); i < Result.size(); ++i)
+		{
+			State = State * 1664525u + 1013904223u;
+			if constexpr(std::is_same_v<T, u8>) Result[i] = u8(State >> 24);
+			else Result[i] = r32(State >> 8) / r32(1 << 24);
+		}
+
+		return Result;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Naive serial 2D convolution in r64, one output pixel at a time.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto naive ( const Image<T>& _Src, const img::Kernel& _KernelX, const img::Kernel& _KernelY, const img::Border _Border ) -> std::vector<r64>
+	{
+		const auto W = _Src.width();
+		const auto H = _Src.height();
+		const auto D = _Src.depth();
+		const auto Rx = i64(_KernelX.radius());
+		const auto Ry = i64(_KernelY.radius());
+		auto Result = std::vector<r64>(_Src.size(), 0.0);
+
+		for(auto y = i64(0); y < i64(H); ++y) for(auto x = i64(0); x < i64(W); ++x) for(auto c = u64(0); c < D; ++c)
+		{
+			auto Sum = 0.0;
+			for(auto j = -Ry; j <= Ry; ++j) for(auto i = -Rx; i <= Rx; ++i)
+			{
+				const auto Sy = u64(img::borderIndex(y + j, i64(H), _Border));
+				const auto Sx = u64(img::borderIndex(x + i, i64(W), _Border));
+				Sum += r64(_KernelY.Taps[u64(j + Ry)]) * r64(_KernelX.Taps[u64(i + Rx)]) * r64(_Src[(Sy * W + Sx) * D + c]);
+			}
+			Result[(u64(y) * W + u64(x)) * D + c] = Sum;
+		}
+
+		return Result;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Entry.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+auto main ( void ) -> int
+{
+	try
+	{
+		// Tall images give many stripes, so every pool thread runs callbacks at once.
+		std::printf("threads: %llu\n", (unsigned long long)(thr::sharedPool().size() + 1));
+		const auto Kx = img::kernelGaussian(2.0f);
+		const auto Ky = img::kernelGaussian(1.5f);
+
+		{
+			const auto Src = noise<r32>(257, 601, 3);
+			const auto Ref = naive(Src, Kx, Ky, img::Border::REFLECT);
+			auto MaxErr = 0.0;
+
+			for(auto Run = 0; Run < 4; ++Run)
+			{
+				const auto Out = img::convolve(Src, Kx, Ky, img::Border::REFLECT);
+				for(auto i = u64(0); i < Out.size(); ++i) MaxErr = std::max(MaxErr, std::abs(r64(Out[i]) - Ref[i]));
+			}
+
+			check(MaxErr < 1e-4, "threaded r32 convolve matches serial reference", MaxErr);
+		}
+
+		{
+			const auto Src = noise<u8>(257, 601, 3);
+			const auto Ref = naive(Src, Kx, Ky, img::Border::CLAMP);
+			auto MaxErr = 0.0;
+
+			for(auto Run = 0; Run < 4; ++Run)
+			{
+				const auto Out = img::convolve(Src, Kx, Ky, img::Border::CLAMP);
+				for(auto i = u64(0); i < Out.size(); ++i) MaxErr = std::max(MaxErr, std::abs(r64(Out[i]) - Ref[i]));
+			}
+
+			check(MaxErr < 1.0, "threaded u8 convolve matches serial reference", MaxErr);
+		}
+
+		// Fixed point u8 path stays within 1 of correctly rounded r32 result, for smoothing and signed kernels alike.
+		{
+			const auto Src = noise<u8>(311, 173, 3);
+			const auto Sharpen = img::Kernel{ { -0.25f, 1.5f, -0.25f } };
+			auto MaxErr = i32(0);
+
+			for(const auto& [Kx, Ky] : { std::pair{ img::kernelGaussian(0.8f), img::kernelGaussian(0.8f) }, std::pair{ img::kernelGaussian(2.0f), img::kernelGaussian(2.0f) }, std::pair{ img::kernelGaussian(2.3f), img::kernelGaussian(1.1f) }, std::pair{ Sharpen, Sharpen } })
+			{
+				const auto Fixed = img::convolve(Src, Kx, Ky, img::Border::REFLECT);
+				const auto Real = img::convolve<r32>(Src, Kx, Ky, img::Border::REFLECT);
+				for(auto i = u64(0); i < Fixed.size(); ++i) MaxErr = std::max(MaxErr, std::abs(i32(Fixed[i]) - i32(std::clamp(std::lround(Real[i]), 0l, 255l))));
+			}
+
+			check(MaxErr <= 1, "u8 convolve within 1 of rounded r32", r64(MaxErr));
+		}
+	}
+
+	catch(Error& e)
+	{
+		e.print();
+		return 1;
+	}
+
+	return (Failures == 0) ? 0 : 1;
+}
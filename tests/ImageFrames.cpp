@@ -0,0 +1,165 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Animated GIF decoding tests. Build from repository root with MSVC or GCC 13+ and run:
+//   g++ -std=c++20 -O2 -I. tests/ImageFrames.cpp -o test_frames -pthread && ./test_frames
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "../fx/ImageFrames.hpp"
+#include <cstdio>
+
+using namespace fx;
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Test helpers.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace
+{
+	auto Failures = 0;
+
+	auto check ( const bool _Ok, const char* _What, const r64 _Value ) -> void
+	{
+		std::printf("%s %s (%g)\n", _Ok ? "ok  " : "FAIL", _What, _Value);
+		if(!_Ok) ++Failures;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// 8 x 10 GIF89a with 4 colour global palette and five frames, colour index of frame f at (x, y) is (x / 2 + y + f) % 4:
+	//   0: full screen, interlaced, 5 / 100 s, dispose none. 80 indices grow LZW codes from 3 to 5 bits.
+	//   1: 4 x 4 at (2, 3), local palette, index 0 transparent, 7 / 100 s, dispose to background.
+	//   2: 3 x 2 at (5, 0), no graphic control extension, so no delay, transparency or disposal is inherited from frame 1.
+	//   3: 4 x 4 at (0, 6), 2 / 100 s, dispose to previous.
+	//   4: 2 x 2 at (6, 8), 1 / 100 s.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	const u8 Gif[] =
+	{
+		0x47, 0x49, 0x46, 0x38, 0x39, 0x61, 0x08, 0x00, 0x0A, 0x00, 0xF1, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x3C, 0xC3, 0x1E, 0x78, 0x87, 0x3C, 0xB4, 0x4B,
+		0x5A, 0x21, 0xF9, 0x04, 0x04, 0x05, 0x00, 0x00, 0x00, 0x2C, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x0A, 0x00, 0x40, 0x02, 0x15, 0x04, 0x12, 0x22,
+		0x33, 0x86, 0xCA, 0x5C, 0x5A, 0x03, 0xB6, 0x33, 0x23, 0x7E, 0xD4, 0x68, 0xCE, 0x69, 0xDF, 0x14, 0x5E, 0x05, 0x00, 0x21, 0xF9, 0x04, 0x09, 0x07,
+		0x00, 0x00, 0x00, 0x2C, 0x02, 0x00, 0x03, 0x00, 0x04, 0x00, 0x04, 0x00, 0x81, 0xC8, 0x00, 0x0A, 0xC8, 0x32, 0x0A, 0xC8, 0x64, 0x0A, 0xC8, 0x96,
+		0x0A, 0x02, 0x07, 0x4C, 0x84, 0x32, 0x3B, 0xE0, 0x60, 0x0A, 0x00, 0x2C, 0x05, 0x00, 0x00, 0x00, 0x03, 0x00, 0x02, 0x00, 0x00, 0x02, 0x03, 0x94,
+		0x86, 0x50, 0x00, 0x21, 0xF9, 0x04, 0x0C, 0x02, 0x00, 0x00, 0x00, 0x2C, 0x00, 0x00, 0x06, 0x00, 0x04, 0x00, 0x04, 0x00, 0x00, 0x02, 0x07, 0xDC,
+		0x80, 0x10, 0x1B, 0xE2, 0x62, 0x0A, 0x00, 0x21, 0xF9, 0x04, 0x00, 0x01, 0x00, 0x00, 0x00, 0x2C, 0x06, 0x00, 0x08, 0x00, 0x02, 0x00, 0x02, 0x00,
+		0x00, 0x02, 0x03, 0x04, 0x12, 0x05, 0x00, 0x3B,
+	};
+
+	// Low byte of frame 2 width inside Gif.
+	constexpr auto FRAME2_WIDTH = u64(112);
+
+	struct Rect { u64 X, Y, W, H; u32 Dispose; i32 Transparent; u32 Delay; bool Local; };
+
+	const Rect Layout[] = { { 0, 0, 8, 10, 1, -1, 50, false }, { 2, 3, 4, 4, 2, 0, 70, true }, { 5, 0, 3, 2, 0, -1, 0, false }, { 0, 6, 4, 4, 3, -1, 20, false }, { 6, 8, 2, 2, 0, -1, 10, false } };
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Straightforward composition of Layout on RGBA canvas that starts transparent, one vector per frame.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	auto reference ( void ) -> std::vector<std::vector<u8>>
+	{
+		constexpr auto W = u64(8);
+		auto Canvas = std::vector<u8>(W * 10 * 4, 0);
+		auto Saved = Canvas;
+		auto Result = std::vector<std::vector<u8>>();
+
+		for(auto f = u64(0); f < std::size(Layout); ++f)
+		{
+			const auto& R = Layout[f];
+
+			if(f > 0)
+			{
+				const auto& P = Layout[f - 1];
+				for(auto y = P.Y; y < P.Y + P.H; ++y) for(auto x = P.X; x < P.X + P.W; ++x) for(auto c = u64(0); c < 4; ++c)
+				{
+					const auto i = (y * W + x) * 4 + c;
+					if(P.Dispose == 2) Canvas[i] = 0;
+					if(P.Dispose == 3) Canvas[i] = Saved[i];
+				}
+			}
+			if(R.Dispose == 3) Saved = Canvas;
+
+			for(auto y = u64(0); y < R.H; ++y) for(auto x = u64(0); x < R.W; ++x)
+			{
+				const auto Index = u8((x / 2 + y + f) % 4);
+				if(i32(Index) == R.Transparent) continue;
+
+				const auto Out = Canvas.data() + ((R.Y + y) * W + R.X + x) * 4;
+				Out[0] = R.Local ? u8(200) : u8(Index * 60);
+				Out[1] = R.Local ? u8(Index * 50) : u8(255 - Index * 60);
+				Out[2] = R.Local ? u8(10) : u8(Index * 30);
+				Out[3] = 255;
+			}
+
+			Result.push_back(Canvas);
+		}
+
+		return Result;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Entry.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+auto main ( void ) -> int
+{
+	try
+	{
+		const auto Ref = reference();
+
+		{
+			const auto Result = img::loadFrames(Gif, sizeof(Gif));
+			auto Pixels = true;
+			auto Delays = true;
+
+			for(auto f = u64(0); f < std::min(Result.count(), Ref.size()); ++f)
+			{
+				Pixels = Pixels && std::equal(Ref[f].begin(), Ref[f].end(), Result.frame(f).data());
+				Delays = Delays && (Result.delay(f) == Layout[f].Delay);
+			}
+
+			check((Result.width() == 8) && (Result.height() == 10) && (Result.count() == Ref.size()), "loadFrames size and frame count", r64(Result.count()));
+			check(Pixels, "loadFrames pixels match reference composition", 0.0);
+			check(Delays, "loadFrames delays, frame without control extension has none", r64(Result.delay(2)));
+		}
+
+		// Streaming reader goes through file source and its own buffer.
+		{
+			const auto Filename = "test_frames.gif"s;
+			{
+				auto File = std::ofstream(Filename, std::ios::binary);
+				File.write(reinterpret_cast<const char*>(Gif), std::streamsize(sizeof(Gif)));
+			}
+
+			auto Reader = img::FrameReader(Filename);
+			auto Frame = Image<u8>();
+			auto Matches = u64(0);
+			while(Reader.read(Frame)) if((Reader.index() <= Ref.size()) && std::equal(Ref[Reader.index() - 1].begin(), Ref[Reader.index() - 1].end(), Frame.data()) && (Reader.delay() == Layout[Reader.index() - 1].Delay)) ++Matches;
+			std::remove(Filename.c_str());
+
+			check((Matches == Ref.size()) && (Reader.index() == Ref.size()), "FrameReader matches reference composition", r64(Matches));
+		}
+
+		// Frame that pokes out of logical screen is rejected before any buffer is sized from it.
+		{
+			auto Bad = std::vector<u8>(Gif, Gif + sizeof(Gif));
+			Bad[FRAME2_WIDTH] = 4;
+			auto Rejected = false;
+			try { img::loadFrames(Bad.data(), Bad.size()); } catch(Error&) { Rejected = true; }
+			check(Rejected, "frame exceeding logical screen is rejected", 0.0);
+		}
+
+		// File cut inside global palette.
+		{
+			auto Rejected = false;
+			try { img::loadFrames(Gif, 20); } catch(Error&) { Rejected = true; }
+			check(Rejected, "file cut inside palette is rejected", 0.0);
+		}
+	}
+
+	catch(Error& e)
+	{
+		e.print();
+		return 1;
+	}
+
+	return (Failures == 0) ? 0 : 1;
+}
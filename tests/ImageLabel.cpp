@@ -0,0 +1,177 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Connected component tests. Build from repository root with MSVC or GCC 13+ and run:
+//   g++ -std=c++20 -O2 -I. tests/ImageLabel.cpp -o test_label -pthread && ./test_label
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "../fx/ImageLabel.hpp"
+#include <cstdio>
+#include <cmath>
+
+using namespace fx;
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Test helpers.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace
+{
+	auto Failures = 0;
+
+	auto check ( const bool _Ok, const char* _What, const r64 _Value ) -> void
+	{
+		std::printf("%s %s (%g)\n", _Ok ? "ok  " : "FAIL", _What, _Value);
+		if(!_Ok) ++Failures;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Deterministic mask with roughly _Percent % of pixels set.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	auto mask ( const u64 _Width, const u64 _Height, const u32 _Percent ) -> Image<u8>
+	{
+		auto Result = Image<u8>(_Width, _Height, 1);
+		auto State = u32(12345);
+
+		for(auto i = u64(0); i < Result.size(); ++i)
+		{
+			State = State * 1664525u + 1013904223u;
+			Result[i] = ((State >> 8) % 100 < _Percent) ? 255 : 0;
+		}
+
+		return Result;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Serial flood fill reference, components numbered in scan order of their first pixel.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	auto floodFill ( const Image<u8>& _Src, const img::Connectivity _Conn ) -> img::Labeling
+	{
+		const auto W = i64(_Src.width());
+		const auto H = i64(_Src.height());
+		auto Result = img::Labeling{ Image<u32>(_Src.width(), _Src.height(), 1), {} };
+		auto Stack = std::vector<i64>();
+		std::fill(Result.Labels.data(), Result.Labels.data() + Result.Labels.size(), 0u);
+
+		for(auto Start = i64(0); Start < W * H; ++Start)
+		{
+			if((_Src[u64(Start)] == 0) || Result.Labels[u64(Start)]) continue;
+
+			const auto Label = u32(Result.Components.size() + 1);
+			auto Comp = img::Component{ 0, u64(W), u64(H), 0, 0, 0.0, 0.0 };
+			Result.Labels[u64(Start)] = Label;
+			Stack.push_back(Start);
+
+			while(!Stack.empty())
+			{
+				const auto P = Stack.back();
+				const auto X = P % W;
+				const auto Y = P / W;
+				Stack.pop_back();
+
+				++Comp.Area;
+				Comp.MinX = std::min(Comp.MinX, u64(X));
+				Comp.MinY = std::min(Comp.MinY, u64(Y));
+				Comp.MaxX = std::max(Comp.MaxX, u64(X));
+				Comp.MaxY = std::max(Comp.MaxY, u64(Y));
+				Comp.CentroidX += r64(X);
+				Comp.CentroidY += r64(Y);
+
+				for(auto Dy = i64(-1); Dy <= 1; ++Dy) for(auto Dx = i64(-1); Dx <= 1; ++Dx)
+				{
+					if((Dx == 0) && (Dy == 0)) continue;
+					if((_Conn == img::Connectivity::FOUR) && (Dx != 0) && (Dy != 0)) continue;
+
+					const auto Nx = X + Dx;
+					const auto Ny = Y + Dy;
+					if((Nx < 0) || (Ny < 0) || (Nx >= W) || (Ny >= H)) continue;
+
+					const auto N = u64(Ny * W + Nx);
+					if((_Src[N] == 0) || Result.Labels[N]) continue;
+					Result.Labels[N] = Label;
+					Stack.push_back(i64(N));
+				}
+			}
+
+			Comp.CentroidX /= r64(Comp.Area);
+			Comp.CentroidY /= r64(Comp.Area);
+			Result.Components.push_back(Comp);
+		}
+
+		return Result;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Label image and components must match reference exactly, both number components in scan order.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	auto same ( const img::Labeling& _A, const img::Labeling& _B ) -> bool
+	{
+		if(_A.Components.size() != _B.Components.size()) return false;
+		if(!std::equal(_A.Labels.data(), _A.Labels.data() + _A.Labels.size(), _B.Labels.data())) return false;
+
+		for(auto i = u64(0); i < _A.Components.size(); ++i)
+		{
+			const auto& A = _A.Components[i];
+			const auto& B = _B.Components[i];
+			if((A.Area != B.Area) || (A.MinX != B.MinX) || (A.MinY != B.MinY) || (A.MaxX != B.MaxX) || (A.MaxY != B.MaxY)) return false;
+			if((std::abs(A.CentroidX - B.CentroidX) > 1e-9) || (std::abs(A.CentroidY - B.CentroidY) > 1e-9)) return false;
+		}
+
+		return true;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Entry.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+auto main ( void ) -> int
+{
+	try
+	{
+		// Densities below, near and above percolation threshold, odd sizes so stripe seams fall anywhere. Single row and column hit one stripe paths.
+		const u64 Sizes[][2] = { { 317, 211 }, { 64, 1000 }, { 1, 97 }, { 151, 1 }, { 1024, 7 } };
+		const u32 Densities[] = { 10, 45, 60, 90 };
+
+		for(const auto Conn : { img::Connectivity::FOUR, img::Connectivity::EIGHT })
+		{
+			auto Good = 0;
+			auto Total = 0;
+
+			for(const auto& Size : Sizes) for(const auto Density : Densities)
+			{
+				const auto Src = mask(Size[0], Size[1], Density);
+				Good += same(img::label(Src, Conn), floodFill(Src, Conn)) ? 1 : 0;
+				++Total;
+			}
+
+			check(Good == Total, (Conn == img::Connectivity::FOUR) ? "FOUR labeling matches flood fill" : "EIGHT labeling matches flood fill", r64(Good));
+		}
+
+		// Spiral spans every stripe and joins back on itself across seams.
+		{
+			auto Src = Image<u8>(101, 101, 1);
+			std::fill(Src.data(), Src.data() + Src.size(), u8(0));
+			auto Lo = i64(0);
+			auto Hi = i64(100);
+			while(Lo <= Hi)
+			{
+				for(auto i = Lo; i <= Hi; ++i) { Src[u64(Lo * 101 + i)] = 1; Src[u64(i * 101 + Hi)] = 1; Src[u64(Hi * 101 + i)] = 1; }
+				for(auto i = Lo + 2; i <= Hi; ++i) Src[u64(i * 101 + Lo)] = 1;
+				if(Lo + 2 <= Hi) Src[u64((Lo + 2) * 101 + Lo + 1)] = 1;
+				Lo += 2;
+				Hi -= 2;
+			}
+
+			const auto Result = img::label(Src, img::Connectivity::FOUR);
+			check(same(Result, floodFill(Src, img::Connectivity::FOUR)), "spiral matches flood fill", r64(Result.Components.size()));
+		}
+	}
+
+	catch(Error& e)
+	{
+		e.print();
+		return 1;
+	}
+
+	return (Failures == 0) ? 0 : 1;
+}
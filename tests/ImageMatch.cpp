@@ -0,0 +1,179 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Template matching tests against brute force. Build from repository root with MSVC or GCC 13+ and run:
+//   g++ -std=c++20 -O2 -I. tests/ImageMatch.cpp -o test_match -pthread && ./test_match
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "../fx/ImageMatch.hpp"
+#include <cstdio>
+#include <cmath>
+
+using namespace fx;
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Test helpers.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace
+{
+	auto Failures = 0;
+
+	auto check ( const bool _Ok, const char* _What, const r64 _Value ) -> void
+	{
+		std::printf("%s %s (%g)\n", _Ok ? "ok  " : "FAIL", _What, _Value);
+		if(!_Ok) ++Failures;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Deterministic noise image.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	auto noise ( const u64 _Width, const u64 _Height, const u64 _Depth, u32 _Seed ) -> Image<u8>
+	{
+		auto Result = Image<u8>(_Width, _Height, _Depth);
+		for(auto i = u64(0); i < Result.size(); ++i)
+		{
+			_Seed = _Seed * 1664525u + 1013904223u;
+			Result[i] = u8(_Seed >> 24);
+		}
+		return Result;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Template cut out of image, so exact match exists at (_X, _Y).
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	auto crop ( const Image<u8>& _Src, const u64 _X, const u64 _Y, const u64 _Width, const u64 _Height ) -> Image<u8>
+	{
+		const auto D = _Src.depth();
+		auto Result = Image<u8>(_Width, _Height, D);
+		for(auto y = u64(0); y < _Height; ++y) for(auto i = u64(0); i < _Width * D; ++i) Result[y * _Width * D + i] = _Src[((_Y + y) * _Src.width() + _X) * D + i];
+		return Result;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Brute force score of one placement, straight from definitions in r64.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	auto bruteScore ( const Image<u8>& _Src, const Image<u8>& _Templ, const u64 _X, const u64 _Y, const img::OpMatch _Op ) -> r64
+	{
+		const auto D = _Src.depth();
+		const auto TW = _Templ.width();
+		const auto TH = _Templ.height();
+		const auto N = r64(TW * TH * D);
+		const auto Pixel = [&]( const u64 _I, const u64 _J, const u64 _C ) { return r64(_Src[((_Y + _J) * _Src.width() + _X + _I) * D + _C]); };
+		const auto Tap = [&]( const u64 _I, const u64 _J, const u64 _C ) { return r64(_Templ[(_J * TW + _I) * D + _C]); };
+
+		auto MeanI = 0.0;
+		auto MeanT = 0.0;
+		for(auto j = u64(0); j < TH; ++j) for(auto i = u64(0); i < TW; ++i) for(auto c = u64(0); c < D; ++c) { MeanI += Pixel(i, j, c); MeanT += Tap(i, j, c); }
+		MeanI /= N;
+		MeanT /= N;
+
+		auto Diff = 0.0, Corr = 0.0, NormI = 0.0, NormT = 0.0, Cov = 0.0, VarI = 0.0, VarT = 0.0;
+		for(auto j = u64(0); j < TH; ++j) for(auto i = u64(0); i < TW; ++i) for(auto c = u64(0); c < D; ++c)
+		{
+			const auto A = Pixel(i, j, c);
+			const auto B = Tap(i, j, c);
+			Diff += (A - B) * (A - B);
+			Corr += A * B;
+			NormI += A * A;
+			NormT += B * B;
+			Cov += (A - MeanI) * (B - MeanT);
+			VarI += (A - MeanI) * (A - MeanI);
+			VarT += (B - MeanT) * (B - MeanT);
+		}
+
+		if(_Op == img::OpMatch::SQDIFF) return Diff;
+		if(_Op == img::OpMatch::CCORR) return Corr;
+		if(_Op == img::OpMatch::CCORR_NORMED) return Corr / std::sqrt(NormI * NormT);
+		return Cov / std::sqrt(VarI * VarT);
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Worst error of matchTemplate against brute force, relative to largest reference score so unnormalized scores compare too.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	auto compare ( const Image<u8>& _Src, const Image<u8>& _Templ, const img::OpMatch _Op ) -> r64
+	{
+		const auto Result = img::matchTemplate(_Src, _Templ, _Op);
+		auto Scale = 1.0;
+		auto Worst = 0.0;
+		auto Ref = std::vector<r64>(Result.size());
+
+		for(auto y = u64(0); y < Result.height(); ++y) for(auto x = u64(0); x < Result.width(); ++x)
+		{
+			Ref[y * Result.width() + x] = bruteScore(_Src, _Templ, x, y, _Op);
+			Scale = std::max(Scale, std::abs(Ref[y * Result.width() + x]));
+		}
+		for(auto i = u64(0); i < Result.size(); ++i) Worst = std::max(Worst, std::abs(r64(Result[i]) - Ref[i]) / Scale);
+
+		return Worst;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Direct and overlap-save correlation on same input, with tile size that is not power of two.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	auto comparePaths ( const Image<u8>& _Src, const Image<u8>& _Templ, const u64 _Tile ) -> r64
+	{
+		const auto TW = _Templ.width();
+		const auto TH = _Templ.height();
+		auto Templ = std::vector<r64>(_Templ.size());
+		for(auto i = u64(0); i < Templ.size(); ++i) Templ[i] = r64(_Templ[i]) - 100.0;
+
+		auto Spatial = Image<r64>(_Src.width() - TW + 1, _Src.height() - TH + 1, 1);
+		auto Fourier = Image<r64>(_Src.width() - TW + 1, _Src.height() - TH + 1, 1);
+		img::impl::correlateSpatial(_Src, Templ, TW, TH, Spatial);
+		img::impl::correlateFft(_Src, Templ, TW, TH, _Tile, Fourier);
+
+		auto Worst = 0.0;
+		for(auto i = u64(0); i < Spatial.size(); ++i) Worst = std::max(Worst, std::abs(Spatial[i] - Fourier[i]) / (std::abs(Spatial[i]) + 1.0));
+		return Worst;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Entry.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+auto main ( void ) -> int
+{
+	try
+	{
+		const img::OpMatch Ops[] = { img::OpMatch::SQDIFF, img::OpMatch::CCORR, img::OpMatch::CCORR_NORMED, img::OpMatch::CCOEFF_NORMED };
+		const char* Names[] = { "SQDIFF", "CCORR", "CCORR_NORMED", "CCOEFF_NORMED" };
+
+		// 5 x 4 template is cheaper directly, 40 x 33 goes through FFT tiles of 80 (2^4 * 5).
+		for(const auto D : { u64(1), u64(3) })
+		{
+			const auto Src = noise(203, 151, D, 17u);
+
+			for(const auto& Size : { std::pair<u64, u64>{ 5, 4 }, { 40, 33 } })
+			{
+				const auto Templ = crop(Src, 61, 47, Size.first, Size.second);
+
+				for(auto o = 0; o < 4; ++o)
+				{
+					char What[96];
+					std::snprintf(What, sizeof(What), "%s, depth %llu, %llux%llu template", Names[o], (unsigned long long)D, (unsigned long long)Size.first, (unsigned long long)Size.second);
+					const auto Err = compare(Src, Templ, Ops[o]);
+					check(Err < 1e-5, What, Err);
+				}
+
+				const auto Scores = img::matchTemplate(Src, Templ, img::OpMatch::CCOEFF_NORMED);
+				const auto Best = u64(std::max_element(Scores.data(), Scores.data() + Scores.size()) - Scores.data());
+				check(Best == 47 * Scores.width() + 61, "best CCOEFF_NORMED score at crop position", r64(Best));
+			}
+		}
+
+		{
+			auto Worst = 0.0;
+			for(const auto Tile : { u64(64), u64(75), u64(90), u64(128) }) Worst = std::max(Worst, comparePaths(noise(157, 131, 3, 23u), noise(13, 21, 3, 29u), Tile));
+			check(Worst < 1e-9, "overlap-save FFT correlation matches direct correlation", Worst);
+		}
+	}
+
+	catch(Error& e)
+	{
+		e.print();
+		return 1;
+	}
+
+	return (Failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Fused pipeline tests against sequential image operations. Build from repository root with MSVC or GCC 13+ and run:
+//   g++ -std=c++20 -O2 -I. tests/ImagePipe.cpp -o test_pipe -pthread && ./test_pipe
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "../fx/ImagePipe.hpp"
+#include <cstdio>
+#include <cmath>
+
+using namespace fx;
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Test helpers.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace
+{
+	auto Failures = 0;
+
+	auto check ( const bool _Ok, const char* _What, const r64 _Value ) -> void
+	{
+		std::printf("%s %s (%g)\n", _Ok ? "ok  " : "FAIL", _What, _Value);
+		if(!_Ok) ++Failures;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Deterministic noise image.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	auto noise ( const u64 _Width, const u64 _Height, const u64 _Depth ) -> Image<u8>
+	{
+		auto Result = Image<u8>(_Width, _Height, _Depth);
+		auto State = u32(12345);
+
+		for(auto i = u64(0); i < Result.size(); ++i)
+		{
+			State = State * 1664525u + 1013904223u;
+			Result[i] = u8(State >> 24);
+		}
+
+		return Result;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Largest element difference, or infinity when dimensions differ.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class A, class B> auto maxDiff ( const Image<A>& _A, const Image<B>& _B ) -> r64
+	{
+		if((_A.width() != _B.width()) || (_A.height() != _B.height()) || (_A.depth() != _B.depth())) return INFINITY;
+
+		auto Result = 0.0;
+		for(auto i = u64(0); i < _A.size(); ++i) Result = std::max(Result, std::abs(r64(_A[i]) - r64(_B[i])));
+		return Result;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Entry.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+auto main ( void ) -> int
+{
+	try
+	{
+		// Widths around chunk size make rows end mid chunk, on chunk boundary and after several chunks.
+		const u64 Widths[] = { 1, 3, 255, 256, 257, 600, 1031 };
+		const std::vector<r32> Mean = { 0.485f, 0.456f, 0.406f };
+		const std::vector<r32> Std = { 0.229f, 0.224f, 0.225f };
+
+		auto ErrNormalize = 0.0;
+		auto ErrGray = 0.0;
+		auto ErrSrgb = 0.0;
+		auto ErrBytes = 0.0;
+
+		for(const auto W : Widths)
+		{
+			const auto Src = noise(W, 37, 3);
+
+			// remap | toFloat | normalize | map against remap, Image<r32> conversion and loops.
+			{
+				const Image<r32> Fused = img::pipe(Src) | img::remap<2, 1, 0>() | img::toFloat() | img::normalize(Mean, Std) | img::map([]( const r32 _V ){ return _V * 0.5f; });
+				auto Seq = Image<r32>(img::remap(Src, { 2, 1, 0 }));
+				for(auto i = u64(0); i < Seq.size(); ++i) Seq[i] = ((Seq[i] - Mean[i % 3]) / Std[i % 3]) * 0.5f;
+				ErrNormalize = std::max(ErrNormalize, maxDiff(Fused, Seq));
+			}
+
+			{
+				const Image<u8> Fused = img::pipe(Src) | img::flatten(img::OpFlatten::MEAN) | img::fatten(4);
+				ErrGray = std::max(ErrGray, maxDiff(Fused, img::fatten(img::flatten(Src, img::OpFlatten::MEAN), 4)));
+			}
+
+			{
+				const Image<u8> Fused = img::pipe(Src) | img::flatten(img::OpFlatten::MEAN, img::Transfer::SRGB);
+				ErrSrgb = std::max(ErrSrgb, maxDiff(Fused, img::flatten(Src, img::OpFlatten::MEAN, img::Transfer::SRGB)));
+			}
+
+			{
+				const Image<u8> Fused = img::pipe(Src) | img::toFloat() | img::toByte();
+				ErrBytes = std::max(ErrBytes, maxDiff(Fused, Src));
+			}
+		}
+
+		check(ErrNormalize < 1e-5, "remap, toFloat, normalize, map match sequential ops", ErrNormalize);
+		check(ErrGray == 0.0, "flatten, fatten match sequential ops", ErrGray);
+		check(ErrSrgb == 0.0, "sRGB flatten matches sequential op", ErrSrgb);
+		check(ErrBytes == 0.0, "toFloat, toByte round trip is exact", ErrBytes);
+
+		// Remap map has one entry per channel, as img::remap.
+		{
+			auto Rejected = false;
+			try { const Image<u8> Out = img::pipe(noise(16, 4, 4)) | img::remap<2, 1, 0>(); } catch(Error&) { Rejected = true; }
+			check(Rejected, "remap with map shorter than depth is rejected", 0.0);
+		}
+	}
+
+	catch(Error& e)
+	{
+		e.print();
+		return 1;
+	}
+
+	return (Failures == 0) ? 0 : 1;
+}
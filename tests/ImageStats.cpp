@@ -0,0 +1,117 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Image statistics tests. Build from repository root with MSVC or GCC 13+ and run:
+//   g++ -std=c++20 -O2 -I. tests/ImageStats.cpp -o test_stats -pthread && ./test_stats
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "../fx/ImageStats.hpp"
+#include <cstdio>
+#include <cmath>
+
+using namespace fx;
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Test helpers.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace
+{
+	auto Failures = 0;
+
+	auto check ( const bool _Ok, const char* _What, const r64 _Value ) -> void
+	{
+		std::printf("%s %s (%g)\n", _Ok ? "ok  " : "FAIL", _What, _Value);
+		if(!_Ok) ++Failures;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Deterministic noise of amplitude _Spread around _Offset.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto noise ( const u64 _Width, const u64 _Height, const u64 _Depth, const r64 _Offset, const r64 _Spread ) -> Image<T>
+	{
+		auto Result = Image<T>(_Width, _Height, _Depth);
+		auto State = u32(12345);
+
+		for(auto i = u64(0); i < Result.size(); ++i)
+		{
+			State = State * 1664525u + 1013904223u;
+			const auto Val = _Offset + _Spread * r64(State >> 8) / r64(1 << 24);
+			if constexpr(std::is_floating_point_v<T>) Result[i] = T(Val);
+			else Result[i] = T(std::floor(Val));
+		}
+
+		return Result;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Worst relative error of mean and variance against serial two-pass reference in r64, checks min / max and histogram totals on the way.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	template<class T> auto compare ( const Image<T>& _Src, const img::ImageStats<T>& _Stats ) -> r64
+	{
+		const auto D = _Src.depth();
+		const auto N = _Src.width() * _Src.height();
+		auto Worst = 0.0;
+
+		for(auto c = u64(0); c < D; ++c)
+		{
+			auto Mean = 0.0;
+			auto Min = _Src[c];
+			auto Max = _Src[c];
+			for(auto i = c; i < _Src.size(); i += D) { Mean += r64(_Src[i]); Min = std::min(Min, _Src[i]); Max = std::max(Max, _Src[i]); }
+			Mean /= r64(N);
+
+			auto Variance = 0.0;
+			for(auto i = c; i < _Src.size(); i += D) Variance += (r64(_Src[i]) - Mean) * (r64(_Src[i]) - Mean);
+			Variance /= r64(N);
+
+			const auto& Channel = _Stats.Channels[c];
+			auto Hits = u64(0);
+			for(const auto Bin : Channel.Histogram) Hits += Bin;
+
+			if((Channel.Min != Min) || (Channel.Max != Max) || (Hits != N) || (_Stats.Count != N)) return 1e9;
+			Worst = std::max(Worst, std::abs(Channel.Mean - Mean) / std::abs(Mean));
+			Worst = std::max(Worst, std::abs(Channel.Variance - Variance) / Variance);
+		}
+
+		return Worst;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Entry.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+auto main ( void ) -> int
+{
+	try
+	{
+		{
+			const auto Src = noise<u8>(1031, 517, 3, 0.0, 256.0);
+			check(compare(Src, img::stats(Src)) < 1e-12, "u8 stats match two-pass reference", compare(Src, img::stats(Src)));
+		}
+
+		// Large offset with small spread: E[x^2] - E[x]^2 would lose most digits here.
+		{
+			const auto Src = noise<u16>(641, 479, 2, 60000.0, 16.0);
+			check(compare(Src, img::stats(Src)) < 1e-9, "u16 stats near top of range", compare(Src, img::stats(Src)));
+		}
+
+		{
+			const auto Src = noise<i32>(513, 257, 1, 1e9, 100.0);
+			check(compare(Src, img::stats(Src)) < 1e-9, "i32 stats with large offset", compare(Src, img::stats(Src)));
+		}
+
+		{
+			const auto Src = noise<r32>(777, 333, 4, 1e4, 1.0);
+			check(compare(Src, img::stats(Src, 64, 1e4, 1e4 + 1.0)) < 1e-6, "r32 stats with large offset", compare(Src, img::stats(Src, 64, 1e4, 1e4 + 1.0)));
+		}
+	}
+
+	catch(Error& e)
+	{
+		e.print();
+		return 1;
+	}
+
+	return (Failures == 0) ? 0 : 1;
+}
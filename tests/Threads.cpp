@@ -0,0 +1,83 @@
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Parallel loop tests. Build from repository root with MSVC or GCC 13+ and run:
+//   g++ -std=c++20 -O2 -I. tests/Threads.cpp -o test_threads -pthread && ./test_threads
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Imports.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "../fx/Threads.hpp"
+#include <cstdio>
+#include <stdexcept>
+
+using namespace fx;
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Test helpers.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+namespace
+{
+	auto Failures = 0;
+
+	auto check ( const bool _Ok, const char* _What, const r64 _Value ) -> void
+	{
+		std::printf("%s %s (%g)\n", _Ok ? "ok  " : "FAIL", _What, _Value);
+		if(!_Ok) ++Failures;
+	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// Sum of [0, _Count) through parallelFor, every index visited exactly once.
+	// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	auto parallelSum ( const u64 _Count ) -> u64
+	{
+		auto Sum = std::atomic<u64>(0);
+		thr::parallelFor(0, _Count, 16, [&]( const u64 _Lo, const u64 _Hi ){ for(auto i = _Lo; i < _Hi; ++i) Sum += i; });
+		return Sum;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Entry.
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+auto main ( void ) -> int
+{
+	std::printf("threads: %llu\n", (unsigned long long)(thr::sharedPool().size() + 1));
+	const auto Count = u64(100000);
+	const auto Expected = Count * (Count - 1) / 2;
+
+	check(parallelSum(Count) == Expected, "parallelFor visits every index once", r64(parallelSum(Count)));
+
+	// Every worker busy in plain pool task that itself calls parallelFor. Helpers queue behind caller, so caller must not wait on them.
+	{
+		const auto Tasks = thr::sharedPool().size() * 3;
+		auto Good = std::atomic<u64>(0);
+
+		for(auto i = u64(0); i < Tasks; ++i) thr::sharedPool().submit([&]{ if(parallelSum(Count) == Expected) ++Good; });
+		thr::sharedPool().wait();
+
+		check(Good == Tasks, "parallelFor from pool tasks completes", r64(Good));
+	}
+
+	// Nested call from body runs inline.
+	{
+		auto Sum = std::atomic<u64>(0);
+		thr::parallelFor(0, 64, 1, [&]( const u64 _Lo, const u64 _Hi ){ for(auto i = _Lo; i < _Hi; ++i) Sum += parallelSum(Count); });
+		check(Sum == Expected * 64, "nested parallelFor", r64(Sum));
+	}
+
+	// First exception reaches caller after all chunks finish.
+	{
+		auto Seen = std::atomic<u64>(0);
+		auto Thrown = false;
+
+		try
+		{
+			thr::parallelFor(0, 1000, 1, [&]( const u64 _Lo, const u64 _Hi ){ Seen += _Hi - _Lo; if(_Lo == 0) throw std::runtime_error("body"); });
+		}
+		catch(std::runtime_error&) { Thrown = true; }
+
+		check(Thrown && (Seen == 1000), "exception rethrown after all chunks", r64(Seen));
+	}
+
+	return (Failures == 0) ? 0 : 1;
+}